@@ -245,6 +245,10 @@ endif
 ifeq ($(UI_TYPE),external)
 DGL_FLAGS += -DDGL_EXTERNAL
 HAVE_DGL   = true
+ifeq ($(LINUX),true)
+# shm_open, used by ExternalChannel
+DGL_LIBS  += -lrt
+endif
 endif
 
 ifeq ($(UI_TYPE),stub)
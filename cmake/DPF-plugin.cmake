@@ -170,6 +170,7 @@ function(dpf_add_plugin NAME)
     if((NOT WIN32) AND (NOT APPLE) AND (NOT HAIKU))
       target_link_libraries("${NAME}-ui" PRIVATE "dl")
     endif()
+    dpf__add_external_channel_libs("${NAME}-ui")
     # add the files containing Objective-C classes
     dpf__add_plugin_specific_ui_sources("${NAME}-ui")
   else()
@@ -834,6 +835,23 @@ function(dpf__add_dgl_system_libs)
   target_link_libraries(dgl-system-libs INTERFACE dgl-system-libs-definitions)
 endfunction()
 
+# dpf__add_external_channel_libs
+# ------------------------------------------------------------------------------
+#
+# Link the system libraries needed by ExternalChannel, which only external UIs use.
+# Older glibc versions provide shm_open in librt instead of libc.
+#
+function(dpf__add_external_channel_libs NAME)
+  if(WIN32 OR APPLE OR HAIKU)
+    return()
+  endif()
+  include(CheckSymbolExists)
+  check_symbol_exists(shm_open "sys/mman.h" DPF_HAVE_SHM_OPEN_IN_LIBC)
+  if(NOT DPF_HAVE_SHM_OPEN_IN_LIBC)
+    target_link_libraries("${NAME}" PRIVATE "rt")
+  endif()
+endfunction()
+
 # dpf__add_executable
 # ------------------------------------------------------------------------------
 #
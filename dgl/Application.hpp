@@ -100,8 +100,13 @@ public:
       You can add more than one, and remove them at anytime with removeIdleCallback().
       Idle callbacks trigger right after OS event handling and Window idle events (within the same cycle).
       There are no guarantees in terms of timing, use Window::addIdleCallback for time-relative callbacks.
+
+      When @a periodInMs is non-zero the callback is only triggered once every @a periodInMs milliseconds,
+      still from within the idle cycle, so it can never run more often than the idle cycle itself.
+      Callbacks due within the same display frame are triggered together,
+      and a standalone application event-loop sleeps until the next callback is due.
     */
-    void addIdleCallback(IdleCallback* callback);
+    void addIdleCallback(IdleCallback* callback, uint periodInMs = 0);
 
    /**
       Remove an idle callback previously added via addIdleCallback().
@@ -141,6 +141,10 @@ public:
 
     void setStep(float step) noexcept;
 
+    // returns the amount of evenly spaced positions within the normalized range, as set by setStep
+    // returns 0 if the value is continuous or using log scale (where positions are not evenly spaced)
+    uint getStepCount() const noexcept;
+
     void setUsingLogScale(bool yesNo) noexcept;
 
     Orientation getOrientation() const noexcept;
@@ -150,6 +150,11 @@ public:
     void setRotationAngle(int angle);
     bool setValue(float value, bool sendCallback = false) noexcept override;
 
+    // keep up to this many pre-rendered rotation frames around, 0 to disable (the default)
+    // rotations are quantized to the knob step count, or to whole degrees for continuous knobs
+    // NOTE: only used for Cairo, other backends rotate on the GPU
+    void setRotationCacheSize(uint frames) noexcept;
+
 protected:
     void onDisplay() override;
     bool onMouse(const MouseEvent&) override;
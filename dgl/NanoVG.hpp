@@ -34,6 +34,7 @@
 
 struct NVGcontext;
 struct NVGpaint;
+struct NVGrecording;
 
 START_NAMESPACE_DGL
 
@@ -123,6 +124,162 @@ private:
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NanoImage)
 };
 
+// -----------------------------------------------------------------------
+// NanoRecording
+
+/**
+   NanoVG Recording class.
+
+   This implements NanoVG recordings as a C++ class where deletion is handled automatically.
+   Recordings are created with NanoVG::beginRecording() and NanoVG::endRecording().
+   @see NanoVG::drawRecording(const NanoRecording&)
+ */
+class NanoRecording
+{
+private:
+    struct Handle {
+        NVGrecording* recording;
+
+        Handle() noexcept
+            : recording(nullptr) {}
+
+        explicit Handle(NVGrecording* r) noexcept
+            : recording(r) {}
+    };
+
+public:
+   /**
+      Constructor for an invalid/null recording.
+    */
+    NanoRecording();
+
+   /**
+      Constructor.
+    */
+    NanoRecording(const Handle& handle);
+
+   /**
+      Destructor.
+    */
+    ~NanoRecording();
+
+   /**
+      Replace this recording with a new one without recreating the C++ class.
+    */
+    NanoRecording& operator=(const Handle& handle);
+
+   /**
+      Wherever this recording is valid.
+    */
+    bool isValid() const noexcept;
+
+private:
+    Handle fHandle;
+    friend class NanoVG;
+
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NanoRecording)
+};
+
+// -----------------------------------------------------------------------
+// NanoAsyncImage
+
+/**
+   NanoVG Image class loaded in the background.
+
+   Image data is decoded on worker threads and uploaded as a texture at the start of a later frame,
+   a few images per frame so that skins with many large images do not stall the UI.
+   Until then the image is not valid and should be replaced by a placeholder while drawing.
+   Images are created with NanoVG::createImageFromMemoryAsync() and NanoVG::createImageFromFileAsync().
+
+   Decoded pixels are shared through a process-wide cache keyed by the hash of the encoded data,
+   so multiple plugin instances loading the same images at the same time only decode them once.
+   The pixels are freed as soon as every instance waiting for them has created its texture.
+
+   When created from a NanoVG based widget, that widget is repainted automatically once the image is decoded.
+
+   Typical usage:
+   @code
+   NanoAsyncImage fBackground;
+
+   MyWidget(Widget* const parent)
+       : NanoSubWidget(parent)
+   {
+       fBackground = createImageFromMemoryAsync(MyResources::backgroundData, MyResources::backgroundDataSize, 0);
+   }
+
+   void onNanoDisplay() override
+   {
+       beginPath();
+       rect(0, 0, getWidth(), getHeight());
+
+       if (fBackground.isValid())
+           fillPaint(imagePattern(0, 0, getWidth(), getHeight(), 0.0f, fBackground.getImage(), 1.0f));
+       else
+           fillColor(0.1f, 0.1f, 0.1f);
+
+       fill();
+   }
+   @endcode
+ */
+class NanoAsyncImage
+{
+private:
+    struct PrivateData;
+
+    struct Handle {
+        PrivateData* data;
+
+        Handle() noexcept
+            : data(nullptr) {}
+
+        explicit Handle(PrivateData* d) noexcept
+            : data(d) {}
+    };
+
+public:
+   /**
+      Constructor for an invalid/null image.
+    */
+    NanoAsyncImage();
+
+   /**
+      Constructor.
+    */
+    NanoAsyncImage(const Handle& handle);
+
+   /**
+      Destructor.
+    */
+    ~NanoAsyncImage();
+
+   /**
+      Replace this image with a new one without recreating the C++ class.
+    */
+    NanoAsyncImage& operator=(const Handle& handle);
+
+   /**
+      Wherever this image is ready for drawing, that is, decoded and uploaded.
+    */
+    bool isValid() const noexcept;
+
+   /**
+      Wherever this image is still being decoded or waiting to be uploaded.
+      Returns false once the image is valid or if it failed to load.
+    */
+    bool isLoading() const noexcept;
+
+   /**
+      Get the uploaded image, which is invalid until isValid() returns true.
+    */
+    const NanoImage& getImage() const noexcept;
+
+private:
+    PrivateData* pData;
+    friend class NanoVG;
+
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NanoAsyncImage)
+};
+
 // -----------------------------------------------------------------------
 // NanoVG
 
@@ -217,6 +374,28 @@ private:
    @endcode
 
    Note: currently only solid color fill is supported for text.
+
+   @section Recordings
+   Fills, strokes and text can be recorded after being flattened and tessellated,
+   so that static content such as knob arcs, graph grids and icons is only built once.
+   Drawing calls made between beginRecording() and endRecording() are captured instead of rendered,
+   the resulting recording is drawn with drawRecording() using only the current transform and global alpha.
+
+   @code
+       if (! grid.isValid() || vg.isRecordingOutdated(grid))
+       {
+           vg.beginRecording();
+           drawGrid(vg);
+           grid = vg.endRecording();
+       }
+       vg.translate(x, y);
+       vg.drawRecording(grid);
+   @endcode
+
+   Since anti-aliasing is tessellated too, recordings should be drawn with the same scale they were recorded with.
+   Images and fonts used while recording must remain valid for as long as the recording is drawn.
+   Recorded text refers to the current font atlas, and becomes outdated once the atlas grows or is reset.
+   Outdated recordings are not drawn, check isRecordingOutdated() to know when to record them again.
  */
 class NanoVG
 {
@@ -237,6 +416,13 @@ public:
           Flag indicating that additional debug checks are done.
         */
         CREATE_DEBUG = 1 << 2,
+
+       /**
+          Flag indicating that a NanoSubWidget should always create its own context and draw in its own frame,
+          instead of sharing a context with other NanoSubWidgets of the same window.
+          Use this for widgets doing custom OpenGL drawing or relying on their own viewport.
+        */
+        CREATE_OWN_CONTEXT = 1 << 3,
     };
 
     enum ImageFlags {
@@ -637,6 +823,19 @@ public:
     */
     NanoImage::Handle createImageFromTextureHandle(GLuint textureId, uint w, uint h, int imageFlags, bool deleteTexture = false);
 
+   /**
+      Creates image by decoding the specified chunk of memory in the background.
+      The data is copied and does not need to stay valid after this call.
+      @see NanoAsyncImage
+    */
+    NanoAsyncImage::Handle createImageFromMemoryAsync(const uchar* data, uint dataSize, int imageFlags);
+
+   /**
+      Creates image by loading it from the disk from specified file name and decoding it in the background.
+      @see NanoAsyncImage
+    */
+    NanoAsyncImage::Handle createImageFromFileAsync(const char* filename, int imageFlags);
+
    /* --------------------------------------------------------------------
     * Paints */
 
@@ -774,6 +973,33 @@ public:
     */
     void stroke();
 
+   /* --------------------------------------------------------------------
+    * Recordings */
+
+   /**
+      Begin capturing fills, strokes and text into a new recording.
+      Drawing calls are not rendered until endRecording() is called.
+    */
+    void beginRecording();
+
+   /**
+      End capturing drawing calls and return the new recording.
+    */
+    NanoRecording::Handle endRecording();
+
+   /**
+      Check if a recording contains text from a font atlas that has since been replaced.
+      Such recordings are not drawn anymore and need to be recorded again.
+    */
+    bool isRecordingOutdated(const NanoRecording& recording);
+
+   /**
+      Draw a recording using the current transform and global alpha.
+      The current scissor is applied to recorded drawing that had no scissor of its own.
+      Outdated recordings are skipped, see isRecordingOutdated().
+    */
+    void drawRecording(const NanoRecording& recording);
+
    /* --------------------------------------------------------------------
     * Text */
 
@@ -894,6 +1120,11 @@ private:
     bool fInFrame;
     bool fIsSubWidget;
 
+    /** @internal */
+    NanoVG(NVGcontext* context, int flags);
+    void _uploadAsyncImages();
+    template <class BaseWidget> friend class NanoBaseWidget;
+
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NanoVG)
 };
 
@@ -914,6 +1145,12 @@ class NanoBaseWidget : public BaseWidget,
 public:
    /**
       Constructor for a NanoSubWidget.
+
+      A NanoVG context shared by all NanoSubWidgets created with the same flags in the same window is used,
+      which is kept alive for as long as any of them exists.
+      If the direct parent widget is one of those NanoSubWidgets, this widget is drawn as part of the parent frame,
+      with a scissor matching the widget bounds.
+      Pass CREATE_OWN_CONTEXT in @a flags to always create a separate context, which is never shared.
       @see CreateFlags
     */
     explicit NanoBaseWidget(Widget* parentWidget, int flags = CREATE_ANTIALIAS);
@@ -949,7 +1186,7 @@ public:
    /**
       Destructor.
     */
-    ~NanoBaseWidget() override {}
+    ~NanoBaseWidget() override;
 
 protected:
    /**
@@ -973,8 +1210,10 @@ private:
     void endFrame() {}
 
    /** @internal */
-    const bool fUsingParentContext;
+    bool fUsingParentContext;
+    bool fUsingSharedContext;
     void displayChildren();
+    static NVGcontext* acquireSharedContext(Widget* parentWidget, int flags);
     friend class NanoBaseWidget<TopLevelWidget>;
     friend class NanoBaseWidget<StandaloneWindow>;
 
@@ -164,6 +164,37 @@ public:
     */
     void setSkipDrawing(bool skipDrawing = true);
 
+   /**
+      Check if this subwidget drawing is cached.
+      @see setCached(bool)
+    */
+    bool isCached() const noexcept;
+
+   /**
+      Enable or disable caching of this subwidget drawing.
+
+      A cached subwidget is drawn once into an offscreen buffer, which is then reused on every frame
+      until the subwidget calls repaint() or gets resized.
+      This is meant for static content such as panels, backgrounds, scales and text labels.
+      Only this subwidget's own drawing is cached, its subwidgets are still drawn as usual.
+
+      @note Caching is not possible for subwidgets that need full viewport drawing,
+            or with graphics backends that have no offscreen rendering support; such subwidgets are drawn as usual.
+            NanoSubWidgets drawn as part of their parent frame are cached together with the parent;
+            use NanoVG::CREATE_OWN_CONTEXT to cache them separately.
+    */
+    void setCached(bool cached = true);
+
+   /**
+      Get the amount of memory used by this subwidget's cache, in bytes.
+    */
+    size_t getCacheSize() const noexcept;
+
+   /**
+      Get the amount of memory used by the caches of all subwidgets, in bytes.
+    */
+    static size_t getTotalCacheSize() noexcept;
+
 protected:
    /**
       A function called when the subwidget's absolute position is changed.
@@ -174,6 +205,7 @@ private:
     struct PrivateData;
     PrivateData* const pData;
     friend class Widget;
+    template <class BaseWidget> friend class NanoBaseWidget;
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SubWidget)
 };
 
@@ -31,6 +31,8 @@ class SubWidget;
 class TopLevelWidget;
 class Window;
 
+template <class BaseWidget> class NanoBaseWidget;
+
 // --------------------------------------------------------------------------------------------------------------------
 
 /**
@@ -296,6 +298,21 @@ public:
     */
     void hide();
 
+   /**
+      Use a spatial index for routing pointer events to the subwidgets of this widget.
+
+      By default every visible subwidget receives mouse, motion and scroll events in reverse z-order,
+      until one of them accepts the event, regardless of the pointer position.
+      When the index is enabled, only subwidgets whose area contains the pointer receive such events,
+      which avoids visiting all subwidgets for widgets with a large amount of them.
+      As exceptions, the subwidget that accepted a button press receives all events until a button is released,
+      and subwidgets that the pointer just left receive one last motion event.
+      Keyboard and character input events are not affected.
+
+      The index is rebuilt after subwidgets are added, removed, moved, resized or restacked.
+    */
+    void setUsingSubWidgetIndex(bool enabled);
+
    /**
       Get width.
     */
@@ -472,6 +489,7 @@ private:
     PrivateData* const pData;
     friend class SubWidget;
     friend class TopLevelWidget;
+    template <class BaseWidget> friend class NanoBaseWidget;
 
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Widget)
 };
@@ -35,6 +35,7 @@ START_NAMESPACE_DGL
 
 class Application;
 class TopLevelWidget;
+class Widget;
 
 // -----------------------------------------------------------------------
 
@@ -424,6 +425,162 @@ public:
     */
     void renderToPicture(const char* filename);
 
+   /**
+      Render this window's content into a memory buffer, without going through the native window.
+      The window does not need to be visible, only its current size is used.
+      It still needs to be created though, so a display connection is required (a virtual one works too).
+      This allows to draw widgets offscreen, for example for automated tests and benchmarks.
+
+      @a pixels must hold getHeight() rows of @a stride bytes,
+      each pixel is written as 32-bit native-endian ARGB with premultiplied alpha.
+
+      @return false if offscreen rendering is not supported by the current graphics backend.
+      @note Implemented for Cairo and OpenGL, the latter requires framebuffer object support.
+    */
+    bool renderToMemory(void* pixels, uint stride);
+
+   /**
+      Callback for measuring the time each widget takes to draw.
+      @see setDisplayTimingCallback
+    */
+    class DisplayTimingCallback
+    {
+    public:
+        virtual ~DisplayTimingCallback() {}
+
+       /**
+          Called after a widget has been drawn.
+          @a seconds includes the time taken to draw its visible subwidgets, which are reported before it.
+        */
+        virtual void widgetDisplayed(Widget* widget, double seconds) = 0;
+
+       /**
+          Called after a full frame has been drawn, right after its top-level widgets are reported.
+        */
+        virtual void frameDisplayed(double seconds) { (void)seconds; }
+
+       /**
+          Called when a repaint is requested.
+          @a widget is the widget that called repaint(), or null if the repaint was requested through the window.
+        */
+        virtual void repaintRequested(Widget* widget) { (void)widget; }
+    };
+
+   /**
+      Display timing callback that records frames, widget draws and repaint requests, meant for profiling.
+      The recorded events can be written into a file using Chrome's JSON trace event format,
+      which can be opened in about:tracing or https://ui.perfetto.dev.
+      Widgets are named after their type, resolved once they are drawn or after the next frame.
+      Widgets deleted before that are reported as unknown.
+      @code
+      Window::FrameTracer tracer(window);
+      window.setDisplayTimingCallback(&tracer);
+      // ... run for a while
+      window.setDisplayTimingCallback(nullptr);
+      tracer.printRepaintSummary();
+      tracer.writeToFile("/tmp/frames.json");
+      @endcode
+    */
+    class FrameTracer : public DisplayTimingCallback
+    {
+    public:
+       /**
+          Constructor for a tracer, keeping at most @a maxEvents events.
+          Events past that limit are dropped.
+        */
+        explicit FrameTracer(Window& window, uint maxEvents = 100000);
+
+       /**
+          Destructor.
+        */
+        ~FrameTracer() override;
+
+       /**
+          Discard all recorded events.
+        */
+        void clear() noexcept;
+
+       /**
+          Get the number of recorded events.
+        */
+        uint getNumEvents() const noexcept;
+
+       /**
+          Print how many repaints each widget requested, most frequent first.
+        */
+        void printRepaintSummary() const;
+
+       /**
+          Write the recorded events into @a filename.
+          Returns false if the file could not be written.
+        */
+        bool writeToFile(const char* filename) const;
+
+        void widgetDisplayed(Widget* widget, double seconds) override;
+        void frameDisplayed(double seconds) override;
+        void repaintRequested(Widget* widget) override;
+
+    private:
+        struct PrivateData;
+        PrivateData* const pData;
+
+        DISTRHO_DECLARE_NON_COPYABLE(FrameTracer)
+    };
+
+   /**
+      Get the callback used for widget draw timings, as set by setDisplayTimingCallback().
+    */
+    DisplayTimingCallback* getDisplayTimingCallback() const noexcept;
+
+   /**
+      Set a callback to receive draw timings for every widget in this window, meant for profiling.
+      Pass null to stop receiving timings, which is the default.
+    */
+    void setDisplayTimingCallback(DisplayTimingCallback* callback) noexcept;
+
+   /**
+      Frame statistics of a window.
+      @see getFrameStats
+    */
+    struct FrameStats {
+        /** Number of frames drawn. */
+        uint numFrames;
+        /** Number of repaint requests, several requests can be handled by a single frame. */
+        uint numRepaintRequests;
+        /** Time taken to draw the last frame, in seconds. */
+        double lastFrameTime;
+        /** Average time taken to draw a frame, in seconds. */
+        double averageFrameTime;
+        /** Longest time taken to draw a frame, in seconds. */
+        double maxFrameTime;
+        /** Widget that requested the last repaint, or null if it was requested through the window. */
+        Widget* lastRepaintWidget;
+    };
+
+   /**
+      Get the frame statistics of this window, since the window was created or resetFrameStats() was last called.
+      Use a DisplayTimingCallback for per-widget timings and for every repaint request.
+    */
+    FrameStats getFrameStats() const noexcept;
+
+   /**
+      Reset the frame statistics of this window.
+    */
+    void resetFrameStats() noexcept;
+
+   /**
+      Check if the frame statistics overlay is visible.
+      @see setFrameStatsOverlayVisible
+    */
+    bool isFrameStatsOverlayVisible() const noexcept;
+
+   /**
+      Show or hide an overlay with a graph of the most recent frame times, drawn on top of all widgets.
+      Each bar represents a frame, bars over half the overlay height exceed a 60 Hz frame budget and are drawn in red.
+      @note The overlay uses basic shape drawing, which is not available in OpenGL3 and Vulkan builds.
+    */
+    void setFrameStatsOverlayVisible(bool visible);
+
    /**
       Run this window as a modal, blocking input events from the parent.
       Only valid for windows that have been created with another window as parent (as passed in the constructor).
@@ -533,6 +690,7 @@ protected:
 private:
     PrivateData* const pData;
     friend class Application;
+    friend class SubWidget;
     friend class TopLevelWidget;
    #ifdef DISTRHO_NAMESPACE
     friend class DISTRHO_NAMESPACE::PluginWindow;
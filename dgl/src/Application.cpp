@@ -59,7 +59,9 @@ void Application::exec(const uint idleTimeInMs)
     {
         pData->idle(0);
 
-        if (CFRunLoopRunInMode(kCFRunLoopDefaultMode, idleTimeInSecs, true) == kCFRunLoopRunFinished)
+        if (CFRunLoopRunInMode(kCFRunLoopDefaultMode,
+                               pData->getTimeUntilNextDeadline(idleTimeInSecs),
+                               true) == kCFRunLoopRunFinished)
             break;
     }
 #else
@@ -88,11 +90,14 @@ double Application::getTime() const
     return pData->getTime();
 }
 
-void Application::addIdleCallback(IdleCallback* const callback)
+void Application::addIdleCallback(IdleCallback* const callback, const uint periodInMs)
 {
     DISTRHO_SAFE_ASSERT_RETURN(callback != nullptr,)
 
-    pData->idleCallbacks.push_back(callback);
+    if (periodInMs != 0)
+        pData->addScheduledIdleCallback(callback, static_cast<double>(periodInMs) / 1000.0);
+    else
+        pData->idleCallbacks.push_back(callback);
 }
 
 void Application::removeIdleCallback(IdleCallback* const callback)
@@ -100,6 +105,7 @@ void Application::removeIdleCallback(IdleCallback* const callback)
     DISTRHO_SAFE_ASSERT_RETURN(callback != nullptr,)
 
     pData->idleCallbacks.remove(callback);
+    pData->removeScheduledIdleCallback(callback);
 }
 
 void Application::setClassName(const char* const name)
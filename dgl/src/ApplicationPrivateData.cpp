@@ -15,10 +15,14 @@
  */
 
 #include "ApplicationPrivateData.hpp"
+#ifndef DPF_TEST_APPLICATION_CPP
+# include "WindowPrivateData.hpp"
+#endif
 #include "../Window.hpp"
 
 #include "pugl.hpp"
 
+#include <algorithm>
 #include <ctime>
 
 START_NAMESPACE_DGL
@@ -26,6 +30,12 @@ START_NAMESPACE_DGL
 typedef std::list<DGL_NAMESPACE::Window*>::iterator WindowListIterator;
 typedef std::list<DGL_NAMESPACE::Window*>::reverse_iterator WindowListReverseIterator;
 
+// used until a window reports its display refresh rate
+static constexpr const double kDefaultFrameInterval = 1.0 / 60.0;
+
+// fraction of the frame interval between paced repaints, small tolerance for jitter in the calling idle timer
+static constexpr const double kRepaintIntervalFactor = 0.9;
+
 static d_ThreadHandle getCurrentThreadHandle() noexcept
 {
    #ifdef DISTRHO_OS_WINDOWS
@@ -61,10 +71,15 @@ Application::PrivateData::PrivateData(const bool standalone)
       isQuittingInNextCycle(false),
       isStarting(true),
       needsRepaint(false),
+      isProcessingEvents(false),
       visibleWindows(0),
       mainThreadHandle(getCurrentThreadHandle()),
       windows(),
-      idleCallbacks()
+      idleCallbacks(),
+      scheduledIdleCallbacks(),
+      dueIdleCallbacks(),
+      frameInterval(kDefaultFrameInterval),
+      lastRepaintTime(0.0)
 {
     DISTRHO_SAFE_ASSERT_RETURN(world != nullptr,);
 
@@ -127,11 +142,22 @@ void Application::PrivateData::idle(const uint timeoutInMs)
 
     if (world != nullptr)
     {
+        // sleep until events arrive or the next scheduled callback or repaint is due, whichever comes first
         const double timeoutInSeconds = timeoutInMs != 0
-                                      ? static_cast<double>(timeoutInMs) / 1000.0
+                                      ? getTimeUntilNextDeadline(static_cast<double>(timeoutInMs) / 1000.0)
                                       : 0.0;
 
+        isProcessingEvents = true;
         puglUpdate(world, timeoutInSeconds);
+        isProcessingEvents = false;
+
+       #ifndef DPF_TEST_APPLICATION_CPP
+        for (WindowListIterator it = windows.begin(), ite = windows.end(); it != ite; ++it)
+        {
+            Window* const window(*it);
+            window->pData->flushPendingMotion();
+        }
+       #endif
     }
 
     triggerIdleCallbacks();
@@ -144,19 +170,130 @@ void Application::PrivateData::triggerIdleCallbacks()
         IdleCallback* const idleCallback(*it);
         idleCallback->idleCallback();
     }
+
+    if (scheduledIdleCallbacks.empty())
+        return;
+
+    // coalesce callbacks that would otherwise be due a fraction of a frame later
+    const double now = getTime();
+    const double horizon = now + frameInterval * 0.5;
+
+    // idle can be re-entered from a callback (e.g. running a modal window),
+    // so each level only appends and triggers its own range, leaving outer ones untouched
+    const size_t firstDue = dueIdleCallbacks.size();
+
+    std::vector<ScheduledIdleCallback>::iterator heapEnd = scheduledIdleCallbacks.end();
+
+    while (heapEnd != scheduledIdleCallbacks.begin() && scheduledIdleCallbacks.front().deadline <= horizon)
+    {
+        std::pop_heap(scheduledIdleCallbacks.begin(), heapEnd, ScheduledIdleCallback::isLater);
+        --heapEnd;
+
+        ScheduledIdleCallback& scheduled(*heapEnd);
+        dueIdleCallbacks.push_back(scheduled.callback);
+
+        // skip missed periods instead of triggering a burst of late callbacks
+        scheduled.deadline += scheduled.period;
+        if (scheduled.deadline <= now)
+            scheduled.deadline = now + scheduled.period;
+    }
+
+    // reschedule before triggering, callbacks are allowed to add or remove other callbacks
+    while (heapEnd != scheduledIdleCallbacks.end())
+        std::push_heap(scheduledIdleCallbacks.begin(), ++heapEnd, ScheduledIdleCallback::isLater);
+
+    const size_t lastDue = dueIdleCallbacks.size();
+
+    for (size_t i = firstDue; i < lastDue; ++i)
+    {
+        if (IdleCallback* const idleCallback = dueIdleCallbacks[i])
+            idleCallback->idleCallback();
+    }
+
+    dueIdleCallbacks.resize(firstDue);
+}
+
+void Application::PrivateData::addScheduledIdleCallback(IdleCallback* const callback, const double period)
+{
+    const ScheduledIdleCallback scheduled = { callback, period, getTime() + period };
+
+    scheduledIdleCallbacks.push_back(scheduled);
+    std::push_heap(scheduledIdleCallbacks.begin(), scheduledIdleCallbacks.end(), ScheduledIdleCallback::isLater);
+}
+
+void Application::PrivateData::removeScheduledIdleCallback(IdleCallback* const callback)
+{
+    bool removed = false;
+
+    for (std::vector<ScheduledIdleCallback>::iterator it = scheduledIdleCallbacks.begin(); it != scheduledIdleCallbacks.end();)
+    {
+        if (it->callback == callback)
+        {
+            it = scheduledIdleCallbacks.erase(it);
+            removed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (removed)
+        std::make_heap(scheduledIdleCallbacks.begin(), scheduledIdleCallbacks.end(), ScheduledIdleCallback::isLater);
+
+    // in case we are in the middle of triggering callbacks, possibly on several nested levels
+    std::replace(dueIdleCallbacks.begin(), dueIdleCallbacks.end(), callback, static_cast<IdleCallback*>(nullptr));
+}
+
+double Application::PrivateData::getTimeUntilNextDeadline(const double maxTimeout) const
+{
+    if (scheduledIdleCallbacks.empty() && ! needsRepaint)
+        return maxTimeout;
+
+    const double now = getTime();
+    double timeout = maxTimeout;
+
+    if (! scheduledIdleCallbacks.empty())
+        timeout = std::min(timeout, scheduledIdleCallbacks.front().deadline - now);
+
+    if (needsRepaint)
+        timeout = std::min(timeout, lastRepaintTime + frameInterval * kRepaintIntervalFactor - now);
+
+    return std::max(0.0, timeout);
+}
+
+void Application::PrivateData::setRefreshRate(const double refreshRate) noexcept
+{
+    if (refreshRate <= 0.0)
+        return;
+
+    const double interval = 1.0 / refreshRate;
+
+    if (frameInterval == kDefaultFrameInterval || interval < frameInterval)
+        frameInterval = interval;
 }
 
 void Application::PrivateData::repaintIfNeeeded()
 {
     if (needsRepaint)
     {
+        // pace repaints to the display refresh rate
+        const double now = getTime();
+
+        if (now - lastRepaintTime < frameInterval * kRepaintIntervalFactor)
+            return;
+
+        lastRepaintTime = now;
         needsRepaint = false;
 
+       #ifndef DPF_TEST_APPLICATION_CPP
+        // only windows that requested a repaint are touched, each posting its own merged area
         for (WindowListIterator it = windows.begin(), ite = windows.end(); it != ite; ++it)
         {
             DGL_NAMESPACE::Window* const window(*it);
-            window->repaint();
+            window->pData->flushPendingRepaints();
         }
+       #endif
     }
 }
 
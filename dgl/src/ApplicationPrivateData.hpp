@@ -20,6 +20,7 @@
 #include "../Application.hpp"
 
 #include <list>
+#include <vector>
 
 #ifdef DISTRHO_OS_WINDOWS
 # ifndef NOMINMAX
@@ -63,9 +64,12 @@ struct Application::PrivateData {
     /** Whether the applicating is starting up, that is, no windows have been made visible yet. Defaults to true. */
     bool isStarting;
 
-    /** When true force all windows to be repainted on next idle. */
+    /** When true, windows with scheduled repaints post their pending repaint area on next idle. */
     bool needsRepaint;
 
+    /** Whether pugl events are being processed as part of idle, motion events are coalesced meanwhile. */
+    bool isProcessingEvents;
+
     /** Counter of visible windows, only used in standalone mode.
         If 0->1, application is starting. If 1->0, application is quitting/stopping. */
     uint visibleWindows;
@@ -73,12 +77,38 @@ struct Application::PrivateData {
     /** Handle that identifies the main thread. Used to check if calls belong to current thread or not. */
     d_ThreadHandle mainThreadHandle;
 
-    /** List of windows for this application. Only used during `close`. */
+    /** List of windows for this application. Only used during `close` and for delivering coalesced events. */
     std::list<DGL_NAMESPACE::Window*> windows;
 
     /** List of idle callbacks for this application. */
     std::list<DGL_NAMESPACE::IdleCallback*> idleCallbacks;
 
+    /** Idle callback with a period, triggered from the idle cycle once its deadline is reached. */
+    struct ScheduledIdleCallback {
+        DGL_NAMESPACE::IdleCallback* callback;
+        double period;
+        double deadline;
+
+        /** Heap ordering, earliest deadline on top. */
+        static bool isLater(const ScheduledIdleCallback& a, const ScheduledIdleCallback& b) noexcept
+        {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    /** Min-heap of periodic idle callbacks, ordered by deadline. */
+    std::vector<ScheduledIdleCallback> scheduledIdleCallbacks;
+
+    /** Callbacks being triggered in the current cycle, removed ones are set to null.
+        Nested cycles (from a modal window event loop) append theirs after the outer ones. */
+    std::vector<DGL_NAMESPACE::IdleCallback*> dueIdleCallbacks;
+
+    /** Duration of a display frame in seconds, taken from the fastest refresh rate among realized windows. */
+    double frameInterval;
+
+    /** Time of the last repaint triggered via repaintIfNeeeded. */
+    double lastRepaintTime;
+
     /** Constructor and destructor */
     explicit PrivateData(bool standalone);
     ~PrivateData();
@@ -96,10 +126,21 @@ struct Application::PrivateData {
     /** Run Pugl world update for @a timeoutInMs, and then each idle callback in order of registration. */
     void idle(uint timeoutInMs);
 
-    /** Run each idle callback without updating pugl world. */
+    /** Run each idle callback without updating pugl world, including scheduled callbacks that are due. */
     void triggerIdleCallbacks();
 
-    /** Trigger a repaint of all windows if @a needsRepaint is true. */
+    /** Add and remove a periodic idle callback. */
+    void addScheduledIdleCallback(IdleCallback* callback, double period);
+    void removeScheduledIdleCallback(IdleCallback* callback);
+
+    /** Get the time until the next scheduled idle callback or paced repaint is due,
+        or @a maxTimeout if that is sooner. */
+    double getTimeUntilNextDeadline(double maxTimeout) const;
+
+    /** Use @a refreshRate (in Hz) for frame pacing if faster than the current one, ignored if not positive. */
+    void setRefreshRate(double refreshRate) noexcept;
+
+    /** Post pending scheduled repaints if @a needsRepaint is true and at least one display frame has passed. */
     void repaintIfNeeeded();
 
     /** Set flag indicating application is quitting, and close all windows in reverse order of registration.
@@ -613,59 +613,185 @@ template class ImageBaseButton<CairoImage>;
 // -----------------------------------------------------------------------
 // ImageBaseKnob
 
-template <>
-void ImageBaseKnob<CairoImage>::PrivateData::init()
-{
-    alwaysRepaint = true;
-    cairoSurface = nullptr;
-}
-
-template <>
-void ImageBaseKnob<CairoImage>::PrivateData::cleanup()
-{
-    cairo_surface_destroy((cairo_surface_t*)cairoSurface);
-    cairoSurface = nullptr;
-}
-
 /**
-   Get the pixel size in bytes.
-   @return pixel size, or 0 if the format is unknown, or pixels are not aligned to bytes.
+   Frames of a Cairo image knob, kept around so that value changes do not need to create new surfaces.
+
+   Filmstrip layers are sub-surfaces of the knob image, created once per layer and without copying pixels.
+   Rotations are rendered into a single reused surface, or into a small LRU cache of pre-rendered angles if enabled.
 */
-static int getBytesPerPixel(const cairo_format_t format) noexcept
-{
-    switch (format)
+struct CairoKnobFrames {
+    struct CachedRotation {
+        cairo_surface_t* surface;
+        uint key;
+        uint lastUsed;
+    };
+
+    cairo_surface_t* const image;
+    const int layerWidth;
+    const int layerHeight;
+    const uint layerCount;
+    const bool isVertical;
+    const int rotationAngle;
+    const uint cacheSize;
+
+    cairo_surface_t* current;
+    cairo_surface_t** layers;
+    cairo_surface_t* rotation;
+    cairo_t* rotationContext;
+    CachedRotation* cache;
+    uint usageCounter;
+
+    CairoKnobFrames(cairo_surface_t* const img,
+                    const int width, const int height, const uint count, const bool vertical,
+                    const int angle, const uint cacheSz)
+        : image(cairo_surface_reference(img)),
+          layerWidth(width),
+          layerHeight(height),
+          layerCount(count),
+          isVertical(vertical),
+          rotationAngle(angle),
+          cacheSize(cacheSz),
+          current(nullptr),
+          layers(angle == 0 && count != 0 ? new cairo_surface_t*[count] : nullptr),
+          rotation(nullptr),
+          rotationContext(nullptr),
+          cache(angle != 0 && cacheSz != 0 ? new CachedRotation[cacheSz] : nullptr),
+          usageCounter(0)
     {
-    case CAIRO_FORMAT_ARGB32:
-    case CAIRO_FORMAT_RGB24:
-        return 4;
-    case CAIRO_FORMAT_A8:
-        return 1;
-    default:
-        DISTRHO_SAFE_ASSERT(false);
-        return 0;
+        if (layers != nullptr)
+            std::memset(layers, 0, sizeof(cairo_surface_t*) * count);
+        if (cache != nullptr)
+            std::memset(cache, 0, sizeof(CachedRotation) * cacheSz);
     }
-}
 
-static cairo_surface_t* getRegion(cairo_surface_t* origsurface, int x, int y, int width, int height) noexcept
-{
-    const cairo_format_t format = cairo_image_surface_get_format(origsurface);
-    DISTRHO_SAFE_ASSERT_RETURN(format != CAIRO_FORMAT_INVALID, nullptr);
+    ~CairoKnobFrames()
+    {
+        if (layers != nullptr)
+        {
+            for (uint i = 0; i < layerCount; ++i)
+                cairo_surface_destroy(layers[i]);
+            delete[] layers;
+        }
+
+        if (cache != nullptr)
+        {
+            for (uint i = 0; i < cacheSize; ++i)
+                cairo_surface_destroy(cache[i].surface);
+            delete[] cache;
+        }
+
+        cairo_destroy(rotationContext);
+        cairo_surface_destroy(rotation);
+        cairo_surface_destroy(image);
+    }
+
+    bool matches(cairo_surface_t* const img,
+                 const int width, const int height, const uint count, const bool vertical,
+                 const int angle, const uint cacheSz) const noexcept
+    {
+        return image == img
+            && layerWidth == width
+            && layerHeight == height
+            && layerCount == count
+            && isVertical == vertical
+            && rotationAngle == angle
+            && cacheSize == cacheSz;
+    }
+
+    cairo_surface_t* getLayer(const double normValue)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(layers != nullptr, nullptr);
+
+        const uint layerNum = static_cast<uint>(normValue * static_cast<double>(layerCount - 1) + 0.5);
+        DISTRHO_SAFE_ASSERT_RETURN(layerNum < layerCount, nullptr);
+
+        if (layers[layerNum] == nullptr)
+        {
+            const int layerX = isVertical ? 0 : static_cast<int>(layerNum) * layerWidth;
+            const int layerY = isVertical ? static_cast<int>(layerNum) * layerHeight : 0;
+
+            layers[layerNum] = cairo_surface_create_for_rectangle(image, layerX, layerY, layerWidth, layerHeight);
+        }
+
+        return layers[layerNum];
+    }
+
+    cairo_surface_t* getRotation(const double normValue, const uint stepCount)
+    {
+        if (cache == nullptr)
+        {
+            if (rotation == nullptr)
+            {
+                rotation = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, layerWidth, layerHeight);
+                rotationContext = cairo_create(rotation);
+            }
+
+            renderRotation(rotationContext, normValue);
+            return rotation;
+        }
+
+        // quantize to knob steps if they fit within the rotation, otherwise use whole degrees
+        const uint numDegrees = static_cast<uint>(std::abs(rotationAngle)) + 1;
+        const uint numAngles = stepCount > 1 && stepCount <= numDegrees ? stepCount : numDegrees;
+        const uint key = static_cast<uint>(normValue * static_cast<double>(numAngles - 1) + 0.5);
+
+        // unused entries have lastUsed as 0, and get picked first
+        CachedRotation* oldest = &cache[0];
+
+        for (uint i = 0; i < cacheSize; ++i)
+        {
+            CachedRotation& entry(cache[i]);
+
+            if (entry.surface != nullptr && entry.key == key)
+            {
+                entry.lastUsed = ++usageCounter;
+                return entry.surface;
+            }
+
+            if (entry.lastUsed < oldest->lastUsed)
+                oldest = &entry;
+        }
+
+        if (oldest->surface == nullptr)
+            oldest->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, layerWidth, layerHeight);
+
+        cairo_t* const cr = cairo_create(oldest->surface);
+        renderRotation(cr, static_cast<double>(key) / static_cast<double>(numAngles - 1));
+        cairo_destroy(cr);
 
-    const int bpp = getBytesPerPixel(format);
-    DISTRHO_SAFE_ASSERT_RETURN(bpp != 0, nullptr);
+        oldest->key = key;
+        oldest->lastUsed = ++usageCounter;
+        return oldest->surface;
+    }
 
-    const int fullWidth   = cairo_image_surface_get_width(origsurface);
-    const int fullHeight  = cairo_image_surface_get_height(origsurface);
-    const int stride      = cairo_image_surface_get_stride(origsurface);
-    uchar* const fullData = cairo_image_surface_get_data(origsurface);
+    void renderRotation(cairo_t* const cr, const double normValue)
+    {
+        cairo_save(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        cairo_translate(cr, 0.5 * layerWidth, 0.5 * layerHeight);
+        cairo_rotate(cr, normValue * rotationAngle * (M_PI / 180));
+        cairo_set_source_surface(cr, image, -0.5 * layerWidth, -0.5 * layerHeight);
+        cairo_paint(cr);
+        cairo_restore(cr);
+    }
 
-    x = (x < fullWidth) ? x : fullWidth;
-    y = (y < fullHeight) ? y : fullHeight;
-    width = (x + width < fullWidth) ? width : (fullWidth - x);
-    height = (x + height < fullHeight) ? height : (fullHeight - x);
+    DISTRHO_DECLARE_NON_COPYABLE(CairoKnobFrames)
+};
 
-    uchar* const data = fullData + (x * bpp + y * stride);
-    return cairo_image_surface_create_for_data(data, format, width, height, stride);
+template <>
+void ImageBaseKnob<CairoImage>::PrivateData::init()
+{
+    alwaysRepaint = true;
+    cairoFrames = nullptr;
+}
+
+template <>
+void ImageBaseKnob<CairoImage>::PrivateData::cleanup()
+{
+    delete static_cast<CairoKnobFrames*>(cairoFrames);
+    cairoFrames = nullptr;
 }
 
 template <>
@@ -673,46 +799,39 @@ void ImageBaseKnob<CairoImage>::onDisplay()
 {
     const GraphicsContext& context(getGraphicsContext());
     cairo_t* const handle = ((const CairoGraphicsContext&)context).handle;
-    const double normValue = getNormalizedValue();
-
-    cairo_surface_t* surface = (cairo_surface_t*)pData->cairoSurface;
 
     if (! pData->isReady)
     {
+        cairo_surface_t* const image = pData->image.getSurface();
+        DISTRHO_SAFE_ASSERT_RETURN(image != nullptr,);
+
         const int layerW = static_cast<int>(pData->imgLayerWidth);
         const int layerH = static_cast<int>(pData->imgLayerHeight);
-        int layerNum = 0;
-
-        if (pData->rotationAngle == 0)
-            layerNum = static_cast<int>(normValue * static_cast<double>(pData->imgLayerCount - 1) + 0.5);
+        CairoKnobFrames* frames = static_cast<CairoKnobFrames*>(pData->cairoFrames);
 
-        const int layerX = pData->isImgVertical ? 0 : layerNum * layerW;
-        const int layerY = !pData->isImgVertical ? 0 : layerNum * layerH;
-
-        cairo_surface_t* newsurface;
-
-        if (pData->rotationAngle == 0)
-        {
-            newsurface = getRegion(pData->image.getSurface(), layerX, layerY, layerW, layerH);
-        }
-        else
+        if (frames == nullptr || ! frames->matches(image, layerW, layerH, pData->imgLayerCount, pData->isImgVertical,
+                                                   pData->rotationAngle, pData->rotationCacheSize))
         {
-            newsurface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, layerW, layerH);
-            cairo_t* const cr = cairo_create(newsurface);
-            cairo_translate(cr, 0.5 * layerW, 0.5 * layerH);
-            cairo_rotate(cr, normValue * pData->rotationAngle * (M_PI / 180));
-            cairo_set_source_surface(cr, pData->image.getSurface(), -0.5 * layerW, -0.5 * layerH);
-            cairo_paint(cr);
-            cairo_destroy(cr);
+            delete frames;
+            pData->cairoFrames = frames = new CairoKnobFrames(image, layerW, layerH,
+                                                              pData->imgLayerCount, pData->isImgVertical,
+                                                              pData->rotationAngle, pData->rotationCacheSize);
         }
 
-        DISTRHO_SAFE_ASSERT_RETURN(newsurface != nullptr,);
+        const double normValue = getNormalizedValue();
+
+        frames->current = pData->rotationAngle == 0
+                        ? frames->getLayer(normValue)
+                        : frames->getRotation(normValue, getStepCount());
 
-        cairo_surface_destroy(surface);
-        pData->cairoSurface = surface = newsurface;
         pData->isReady = true;
     }
 
+    const CairoKnobFrames* const frames = static_cast<const CairoKnobFrames*>(pData->cairoFrames);
+    DISTRHO_SAFE_ASSERT_RETURN(frames != nullptr,);
+
+    cairo_surface_t* const surface = frames->current;
+
     if (surface != nullptr)
     {
         cairo_set_source_surface(handle, surface, 0, 0);
@@ -734,6 +853,24 @@ template class ImageBaseSwitch<CairoImage>;
 
 // -----------------------------------------------------------------------
 
+// subwidget drawing stored in an intermediate group surface, positioned in device space
+struct CairoRenderCache : SubWidgetRenderCache {
+    cairo_pattern_t* pattern;
+    double x, y, scaleFactor;
+
+    CairoRenderCache() noexcept
+        : pattern(nullptr),
+          x(0.0),
+          y(0.0),
+          scaleFactor(0.0) {}
+
+    ~CairoRenderCache() override
+    {
+        if (pattern != nullptr)
+            cairo_pattern_destroy(pattern);
+    }
+};
+
 void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor)
 {
     cairo_t* const handle = static_cast<const CairoGraphicsContext&>(self->getGraphicsContext()).handle;
@@ -773,8 +910,45 @@ void SubWidget::PrivateData::display(const uint width, const uint height, const
         cairo_scale(handle, autoScaleFactor, autoScaleFactor);
     }
 
-    // display widget
-    self->onDisplay();
+    if (cached && ! needsViewportScaling && ! needsFullViewportForDrawing)
+    {
+        CairoRenderCache* cache = static_cast<CairoRenderCache*>(renderCache);
+
+        if (cache == nullptr)
+            renderCache = cache = new CairoRenderCache;
+
+        double x = 0.0, y = 0.0;
+        cairo_user_to_device(handle, &x, &y);
+
+        if (cacheNeedsUpdate || cache->pattern == nullptr
+            || d_isNotEqual(cache->x, x) || d_isNotEqual(cache->y, y) || d_isNotEqual(cache->scaleFactor, autoScaleFactor))
+        {
+            if (cache->pattern != nullptr)
+                cairo_pattern_destroy(cache->pattern);
+
+            // group surface is limited to the current clip, which matches widget bounds
+            cairo_push_group(handle);
+            self->onDisplay();
+            cache->pattern = cairo_pop_group(handle);
+            cache->x = x;
+            cache->y = y;
+            cache->scaleFactor = autoScaleFactor;
+            cache->setSize(d_roundToUnsignedInt(self->getWidth() * autoScaleFactor),
+                           d_roundToUnsignedInt(self->getHeight() * autoScaleFactor));
+            cacheNeedsUpdate = false;
+        }
+
+        cairo_set_source(handle, cache->pattern);
+        cairo_paint(handle);
+    }
+    else
+    {
+        if (renderCache != nullptr)
+            freeRenderCache();
+
+        // display widget
+        self->onDisplay();
+    }
 
     if (needsResetClip)
         cairo_reset_clip(handle);
@@ -821,9 +995,75 @@ void TopLevelWidget::PrivateData::display()
 
 // -----------------------------------------------------------------------
 
-void Window::PrivateData::renderToPicture(const char*, const GraphicsContext&, uint, uint)
+void Window::PrivateData::renderToPicture(const char* const filename,
+                                          const GraphicsContext& context,
+                                          const uint width,
+                                          const uint height)
 {
-    notImplemented("Window::PrivateData::renderToPicture");
+    cairo_t* const handle = ((const CairoGraphicsContext&)context).handle;
+    DISTRHO_SAFE_ASSERT_RETURN(handle != nullptr,);
+
+    // copy window contents into an image surface, so we can access its pixels
+    cairo_surface_t* const surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+                                                                static_cast<int>(width),
+                                                                static_cast<int>(height));
+    cairo_t* const cr = cairo_create(surface);
+    cairo_set_source_surface(cr, cairo_get_target(handle), 0, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+
+    if (FILE* const f = fopen(filename, "w"))
+    {
+        const uchar* const data = cairo_image_surface_get_data(surface);
+        const int stride = cairo_image_surface_get_stride(surface);
+
+        fprintf(f, "P3\n%d %d\n255\n", width, height);
+        for (uint y = 0; y < height; y++)
+        {
+            const uint32_t* const row = reinterpret_cast<const uint32_t*>(data + static_cast<int>(y) * stride);
+
+            for (uint x = 0; x < width; x++)
+                fprintf(f, "%3d %3d %3d ", (row[x] >> 16) & 0xff, (row[x] >> 8) & 0xff, row[x] & 0xff);
+
+            fprintf(f, "\n");
+        }
+
+        fclose(f);
+    }
+
+    cairo_surface_destroy(surface);
+}
+
+bool Window::PrivateData::renderToMemory(void* const pixels, const uint stride)
+{
+    const PuglRect rect = puglGetFrame(view);
+    const int width = static_cast<int>(rect.width);
+    const int height = static_cast<int>(rect.height);
+    DISTRHO_SAFE_ASSERT_RETURN(width > 0 && height > 0, false);
+    DISTRHO_SAFE_ASSERT_RETURN(static_cast<int>(stride) >= cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width),
+                               false);
+
+    cairo_surface_t* const surface = cairo_image_surface_create_for_data(static_cast<uchar*>(pixels),
+                                                                         CAIRO_FORMAT_ARGB32,
+                                                                         width,
+                                                                         height,
+                                                                         static_cast<int>(stride));
+    cairo_t* const handle = cairo_create(surface);
+
+    // start from a clear image, like a freshly exposed window
+    cairo_set_operator(handle, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(handle);
+    cairo_set_operator(handle, CAIRO_OPERATOR_OVER);
+
+    offscreenContext = handle;
+    displayTopLevelWidgets();
+    offscreenContext = nullptr;
+
+    cairo_destroy(handle);
+    cairo_surface_flush(surface);
+    cairo_surface_destroy(surface);
+    return true;
 }
 
 // -----------------------------------------------------------------------
@@ -831,7 +1071,9 @@ void Window::PrivateData::renderToPicture(const char*, const GraphicsContext&, u
 const GraphicsContext& Window::PrivateData::getGraphicsContext() const noexcept
 {
     GraphicsContext& context((GraphicsContext&)graphicsContext);
-    ((CairoGraphicsContext&)context).handle = (cairo_t*)puglGetContext(view);
+    ((CairoGraphicsContext&)context).handle = offscreenContext != nullptr
+                                            ? static_cast<cairo_t*>(offscreenContext)
+                                            : (cairo_t*)puglGetContext(view);
     return context;
 }
 
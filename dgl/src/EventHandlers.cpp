@@ -634,6 +634,14 @@ void KnobEventHandler::setStep(const float step) noexcept
     pData->step = step;
 }
 
+uint KnobEventHandler::getStepCount() const noexcept
+{
+    if (pData->step <= 0.f || pData->usingLog)
+        return 0;
+
+    return static_cast<uint>((pData->maximum - pData->minimum) / pData->step + 0.5f) + 1;
+}
+
 void KnobEventHandler::setUsingLogScale(const bool yesNo) noexcept
 {
     pData->usingLog = yesNo;
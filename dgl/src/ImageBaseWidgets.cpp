@@ -231,6 +231,7 @@ struct ImageBaseKnob<ImageType>::PrivateData : public KnobEventHandler::Callback
     ImageType image;
 
     int rotationAngle;
+    uint rotationCacheSize;
 
     bool alwaysRepaint;
     bool isImgVertical;
@@ -241,13 +242,14 @@ struct ImageBaseKnob<ImageType>::PrivateData : public KnobEventHandler::Callback
 
     union {
         uint glTextureId;
-        void* cairoSurface;
+        void* cairoFrames;
     };
 
     explicit PrivateData(const ImageType& img)
         : callback(nullptr),
           image(img),
           rotationAngle(0),
+          rotationCacheSize(0),
           alwaysRepaint(false),
           isImgVertical(img.getHeight() > img.getWidth()),
           imgLayerWidth(isImgVertical ? img.getWidth() : img.getHeight()),
@@ -262,6 +264,7 @@ struct ImageBaseKnob<ImageType>::PrivateData : public KnobEventHandler::Callback
         : callback(other->callback),
           image(other->image),
           rotationAngle(other->rotationAngle),
+          rotationCacheSize(other->rotationCacheSize),
           alwaysRepaint(other->alwaysRepaint),
           isImgVertical(other->isImgVertical),
           imgLayerWidth(other->imgLayerWidth),
@@ -275,15 +278,16 @@ struct ImageBaseKnob<ImageType>::PrivateData : public KnobEventHandler::Callback
     void assignFrom(PrivateData* const other)
     {
         cleanup();
-        image          = other->image;
-        rotationAngle  = other->rotationAngle;
-        callback       = other->callback;
-        alwaysRepaint  = other->alwaysRepaint;
-        isImgVertical  = other->isImgVertical;
-        imgLayerWidth  = other->imgLayerWidth;
-        imgLayerHeight = other->imgLayerHeight;
-        imgLayerCount  = other->imgLayerCount;
-        isReady        = false;
+        image             = other->image;
+        rotationAngle     = other->rotationAngle;
+        rotationCacheSize = other->rotationCacheSize;
+        callback          = other->callback;
+        alwaysRepaint     = other->alwaysRepaint;
+        isImgVertical     = other->isImgVertical;
+        imgLayerWidth     = other->imgLayerWidth;
+        imgLayerHeight    = other->imgLayerHeight;
+        imgLayerCount     = other->imgLayerCount;
+        isReady           = false;
         init();
     }
 
@@ -382,6 +386,7 @@ void ImageBaseKnob<ImageType>::setImageLayerCount(uint count) noexcept
     else
         pData->imgLayerWidth = pData->image.getWidth()/count;
 
+    pData->isReady = false;
     setSize(pData->imgLayerWidth, pData->imgLayerHeight);
 }
 
@@ -395,6 +400,16 @@ void ImageBaseKnob<ImageType>::setRotationAngle(int angle)
     pData->isReady = false;
 }
 
+template <class ImageType>
+void ImageBaseKnob<ImageType>::setRotationCacheSize(const uint frames) noexcept
+{
+    if (pData->rotationCacheSize == frames)
+        return;
+
+    pData->rotationCacheSize = frames;
+    pData->isReady = false;
+}
+
 template <class ImageType>
 bool ImageBaseKnob<ImageType>::setValue(float value, bool sendCallback) noexcept
 {
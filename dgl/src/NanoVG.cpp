@@ -19,11 +19,18 @@
 # pragma warning(disable:4661)
 #endif
 
+#include "../Application.hpp"
 #include "../NanoVG.hpp"
 #include "SubWidgetPrivateData.hpp"
+#include "WidgetPrivateData.hpp"
+
+#include "../../distrho/extra/Thread.hpp"
+
+#include <cstdio>
 
 #ifndef DGL_NO_SHARED_RESOURCES
 # include "Resources.hpp"
+# include "../../distrho/extra/Resource.hpp"
 #endif
 
 // -----------------------------------------------------------------------
@@ -291,6 +298,467 @@ void NanoImage::_updateSize()
     fSize.setSize(static_cast<uint>(w), static_cast<uint>(h));
 }
 
+// -----------------------------------------------------------------------
+// NanoRecording
+
+NanoRecording::NanoRecording()
+    : fHandle() {}
+
+NanoRecording::NanoRecording(const Handle& handle)
+    : fHandle(handle) {}
+
+NanoRecording::~NanoRecording()
+{
+    if (fHandle.recording != nullptr)
+        nvgDeleteRecording(fHandle.recording);
+}
+
+NanoRecording& NanoRecording::operator=(const Handle& handle)
+{
+    if (fHandle.recording != nullptr && fHandle.recording != handle.recording)
+        nvgDeleteRecording(fHandle.recording);
+
+    fHandle.recording = handle.recording;
+    return *this;
+}
+
+bool NanoRecording::isValid() const noexcept
+{
+    return fHandle.recording != nullptr;
+}
+
+// -----------------------------------------------------------------------
+// Process-wide cache of decoded images, shared by all NanoAsyncImages
+
+// upload at most this amount of pixel data per frame, but always at least one image
+static constexpr const size_t kAsyncImageUploadBytesPerFrame = 4 * 1024 * 1024;
+
+// how often widgets check for decoded images to be uploaded
+static constexpr const uint kAsyncImageIdlePeriodInMs = 20;
+
+static constexpr const uint kNumAsyncImageDecoders = 2;
+
+struct DecodedImage {
+    enum State {
+        kStateQueued,
+        kStateDecoding,
+        kStateDecoded,
+        kStateFailed,
+        kStateUploaded // pixels freed after every user uploaded them
+    };
+
+    uint64_t hash;
+    uint encodedSize;
+    uchar* encodedData;
+    uchar* pixels;
+    int width, height;
+    uint refCount;
+    uint pendingUploads;
+    State state;
+};
+
+class AsyncImageCache
+{
+public:
+    static AsyncImageCache& getInstance()
+    {
+        static AsyncImageCache cache;
+        return cache;
+    }
+
+    ~AsyncImageCache()
+    {
+        for (uint i = 0; i < kNumAsyncImageDecoders; ++i)
+        {
+            fDecoders[i]->stopThread(-1);
+            delete fDecoders[i];
+        }
+
+        for (std::vector<DecodedImage*>::iterator it = fImages.begin(); it != fImages.end(); ++it)
+            freeImage(*it);
+    }
+
+    // returns a new reference to the decoded image matching the given data, queueing it for decoding if needed
+    DecodedImage* acquire(const uchar* const data, const uint dataSize)
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (uint i = 0; i < dataSize; ++i)
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+
+        const MutexLocker cml(fMutex);
+
+        for (std::vector<DecodedImage*>::iterator it = fImages.begin(); it != fImages.end(); ++it)
+        {
+            DecodedImage* const image = *it;
+
+            if (image->hash != hash || image->encodedSize != dataSize)
+                continue;
+
+            // pixels are gone already, decode them again
+            if (image->state == DecodedImage::kStateUploaded)
+            {
+                DISTRHO_SAFE_ASSERT_RETURN(queueDecoding(image, data, dataSize), nullptr);
+            }
+
+            ++image->refCount;
+            ++image->pendingUploads;
+            return image;
+        }
+
+        DecodedImage* const image = new DecodedImage;
+        image->hash = hash;
+        image->encodedSize = dataSize;
+        image->encodedData = nullptr;
+        image->pixels = nullptr;
+        image->width = image->height = 0;
+        image->refCount = 1;
+        image->pendingUploads = 1;
+
+        if (! queueDecoding(image, data, dataSize))
+        {
+            delete image;
+            return nullptr;
+        }
+
+        fImages.push_back(image);
+        return image;
+    }
+
+    void release(DecodedImage* const image)
+    {
+        const MutexLocker cml(fMutex);
+
+        if (--image->refCount != 0)
+            return;
+
+        // freed by the decoder when done
+        if (image->state == DecodedImage::kStateDecoding)
+            return;
+
+        removeImage(image);
+    }
+
+    // called once per reference after uploading the pixels, or when a reference is gone before doing so
+    void uploadDone(DecodedImage* const image)
+    {
+        const MutexLocker cml(fMutex);
+        DISTRHO_SAFE_ASSERT_RETURN(image->pendingUploads != 0,);
+
+        if (--image->pendingUploads == 0 && image->state == DecodedImage::kStateDecoded)
+            freePixels(image);
+    }
+
+    // pixels stay valid until uploadDone() is called
+    DecodedImage::State getState(const DecodedImage* const image, const uchar** const pixels = nullptr,
+                                 int* const width = nullptr, int* const height = nullptr)
+    {
+        const MutexLocker cml(fMutex);
+
+        if (pixels != nullptr)
+        {
+            *pixels = image->pixels;
+            *width = image->width;
+            *height = image->height;
+        }
+
+        return image->state;
+    }
+
+private:
+    class Decoder : public Thread
+    {
+    public:
+        // only accessed with the cache mutex held
+        bool active;
+
+        Decoder(AsyncImageCache& cache) noexcept
+            : Thread("DPF Image Decoder"),
+              active(false),
+              fCache(cache) {}
+
+    protected:
+        void run() override
+        {
+            while (fCache.decodeNext(this)) {}
+        }
+
+    private:
+        AsyncImageCache& fCache;
+
+        DISTRHO_DECLARE_NON_COPYABLE(Decoder)
+    };
+
+    Mutex fMutex;
+    std::vector<DecodedImage*> fImages;
+    Decoder* fDecoders[kNumAsyncImageDecoders];
+
+    AsyncImageCache()
+        : fMutex(),
+          fImages()
+    {
+        for (uint i = 0; i < kNumAsyncImageDecoders; ++i)
+            fDecoders[i] = new Decoder(*this);
+    }
+
+    // must be called with the mutex held
+    bool queueDecoding(DecodedImage* const image, const uchar* const data, const uint dataSize)
+    {
+        uchar* const encodedData = static_cast<uchar*>(std::malloc(dataSize));
+        DISTRHO_SAFE_ASSERT_RETURN(encodedData != nullptr, false);
+
+        std::memcpy(encodedData, data, dataSize);
+
+        image->encodedData = encodedData;
+        image->state = DecodedImage::kStateQueued;
+
+        // wake up an idle decoder, if any
+        for (uint i = 0; i < kNumAsyncImageDecoders; ++i)
+        {
+            Decoder* const decoder = fDecoders[i];
+
+            if (decoder->active)
+                continue;
+
+            decoder->active = true;
+
+            // thread might still be finishing after running out of work
+            decoder->stopThread(-1);
+            decoder->startThread();
+            break;
+        }
+
+        return true;
+    }
+
+    bool decodeNext(Decoder* const decoder)
+    {
+        DecodedImage* image = nullptr;
+
+        {
+            const MutexLocker cml(fMutex);
+
+            for (std::vector<DecodedImage*>::iterator it = fImages.begin(); it != fImages.end(); ++it)
+            {
+                if ((*it)->state == DecodedImage::kStateQueued)
+                {
+                    image = *it;
+                    break;
+                }
+            }
+
+            if (image == nullptr)
+            {
+                decoder->active = false;
+                return false;
+            }
+
+            image->state = DecodedImage::kStateDecoding;
+        }
+
+        int width = 0, height = 0;
+        uchar* const pixels = nvgDecodeImageMem(image->encodedData, static_cast<int>(image->encodedSize),
+                                                &width, &height);
+
+        const MutexLocker cml(fMutex);
+
+        std::free(image->encodedData);
+        image->encodedData = nullptr;
+
+        if (pixels != nullptr)
+        {
+            image->pixels = pixels;
+            image->width = width;
+            image->height = height;
+            image->state = DecodedImage::kStateDecoded;
+
+            // every user went away while decoding
+            if (image->pendingUploads == 0)
+                freePixels(image);
+        }
+        else
+        {
+            d_stderr2("Failed to decode %u bytes of image data", image->encodedSize);
+            image->state = DecodedImage::kStateFailed;
+        }
+
+        if (image->refCount == 0)
+            removeImage(image);
+
+        return true;
+    }
+
+    void removeImage(DecodedImage* const image)
+    {
+        for (std::vector<DecodedImage*>::iterator it = fImages.begin(); it != fImages.end(); ++it)
+        {
+            if (*it == image)
+            {
+                fImages.erase(it);
+                break;
+            }
+        }
+
+        freeImage(image);
+    }
+
+    static void freePixels(DecodedImage* const image)
+    {
+        nvgFreeDecodedImage(image->pixels);
+        image->pixels = nullptr;
+        image->state = DecodedImage::kStateUploaded;
+    }
+
+    static void freeImage(DecodedImage* const image)
+    {
+        std::free(image->encodedData);
+
+        if (image->pixels != nullptr)
+            nvgFreeDecodedImage(image->pixels);
+
+        delete image;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(AsyncImageCache)
+};
+
+// -----------------------------------------------------------------------
+// NanoAsyncImage
+
+struct NanoAsyncImage::PrivateData : IdleCallback {
+    NVGcontext* const context;
+    const int imageFlags;
+    DecodedImage* const decoded;
+    Widget* const widget;
+    NanoImage image;
+    bool failed;
+    bool idleCallbackAdded;
+
+    PrivateData(NVGcontext* const c, const int flags, DecodedImage* const d, Widget* const w)
+        : context(c),
+          imageFlags(flags),
+          decoded(d),
+          widget(w),
+          image(),
+          failed(false),
+          idleCallbackAdded(false)
+    {
+        getPendingImages().push_back(this);
+
+        if (widget != nullptr)
+        {
+            widget->getApp().addIdleCallback(this, kAsyncImageIdlePeriodInMs);
+            idleCallbackAdded = true;
+        }
+    }
+
+    ~PrivateData() override
+    {
+        std::vector<PrivateData*>& pendingImages(getPendingImages());
+
+        AsyncImageCache& cache(AsyncImageCache::getInstance());
+
+        for (std::vector<PrivateData*>::iterator it = pendingImages.begin(); it != pendingImages.end(); ++it)
+        {
+            if (*it == this)
+            {
+                pendingImages.erase(it);
+                cache.uploadDone(decoded);
+                break;
+            }
+        }
+
+        if (idleCallbackAdded)
+            widget->getApp().removeIdleCallback(this);
+
+        cache.release(decoded);
+    }
+
+    bool isLoading() const
+    {
+        return ! image.isValid() && ! failed
+            && AsyncImageCache::getInstance().getState(decoded) != DecodedImage::kStateFailed;
+    }
+
+    // repaint the widget once decoding is done, the image gets uploaded during its next frame
+    void idleCallback() override
+    {
+        if (image.isValid() || failed)
+        {
+            removeIdleCallback();
+            return;
+        }
+
+        const DecodedImage::State state = AsyncImageCache::getInstance().getState(decoded);
+
+        if (state == DecodedImage::kStateQueued || state == DecodedImage::kStateDecoding)
+            return;
+
+        // hidden widgets upload the image on their first frame after being shown
+        if (! widget->isVisible() || ! widget->getWindow().isVisible())
+            return;
+
+        widget->repaint();
+
+        if (state == DecodedImage::kStateFailed)
+            removeIdleCallback();
+    }
+
+    void removeIdleCallback()
+    {
+        widget->getApp().removeIdleCallback(this);
+        idleCallbackAdded = false;
+    }
+
+    // images waiting to be uploaded, only accessed from the UI thread
+    static std::vector<PrivateData*>& getPendingImages()
+    {
+        static std::vector<PrivateData*> pendingImages;
+        return pendingImages;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PrivateData)
+};
+
+NanoAsyncImage::NanoAsyncImage()
+    : pData(nullptr) {}
+
+NanoAsyncImage::NanoAsyncImage(const Handle& handle)
+    : pData(handle.data) {}
+
+NanoAsyncImage::~NanoAsyncImage()
+{
+    delete pData;
+}
+
+NanoAsyncImage& NanoAsyncImage::operator=(const Handle& handle)
+{
+    if (pData != handle.data)
+    {
+        delete pData;
+        pData = handle.data;
+    }
+
+    return *this;
+}
+
+bool NanoAsyncImage::isValid() const noexcept
+{
+    return pData != nullptr && pData->image.isValid();
+}
+
+bool NanoAsyncImage::isLoading() const noexcept
+{
+    return pData != nullptr && pData->isLoading();
+}
+
+const NanoImage& NanoAsyncImage::getImage() const noexcept
+{
+    static const NanoImage nullImage;
+
+    return pData != nullptr ? pData->image : nullImage;
+}
+
 // -----------------------------------------------------------------------
 // Paint
 
@@ -325,7 +793,7 @@ NanoVG::Paint::operator NVGpaint() const noexcept
 // NanoVG
 
 NanoVG::NanoVG(int flags)
-    : fContext(nvgCreateGL(flags)),
+    : fContext(nvgCreateGL(flags & ~CREATE_OWN_CONTEXT)),
       fInFrame(false),
       fIsSubWidget(false)
 {
@@ -340,6 +808,14 @@ NanoVG::NanoVG(NVGcontext* const context)
     DISTRHO_CUSTOM_SAFE_ASSERT("Failed to create NanoVG context, expect a black screen", fContext != nullptr);
 }
 
+NanoVG::NanoVG(NVGcontext* const context, const int flags)
+    : fContext(context != nullptr ? context : nvgCreateGL(flags & ~CREATE_OWN_CONTEXT)),
+      fInFrame(false),
+      fIsSubWidget(context != nullptr)
+{
+    DISTRHO_CUSTOM_SAFE_ASSERT("Failed to create NanoVG context, expect a black screen", fContext != nullptr);
+}
+
 NanoVG::~NanoVG()
 {
     DISTRHO_CUSTOM_SAFE_ASSERT("Destroying NanoVG context with still active frame", ! fInFrame);
@@ -356,8 +832,11 @@ void NanoVG::beginFrame(const uint width, const uint height, const float scaleFa
     DISTRHO_SAFE_ASSERT_RETURN(! fInFrame,);
     fInFrame = true;
 
-    if (fContext != nullptr)
-        nvgBeginFrame(fContext, static_cast<int>(width), static_cast<int>(height), scaleFactor);
+    if (fContext == nullptr)
+        return;
+
+    _uploadAsyncImages();
+    nvgBeginFrame(fContext, static_cast<int>(width), static_cast<int>(height), scaleFactor);
 }
 
 void NanoVG::beginFrame(Widget* const widget)
@@ -369,6 +848,8 @@ void NanoVG::beginFrame(Widget* const widget)
     if (fContext == nullptr)
         return;
 
+    _uploadAsyncImages();
+
     if (TopLevelWidget* const tlw = widget->getTopLevelWidget())
         nvgBeginFrame(fContext,
                       static_cast<int>(tlw->getWidth()),
@@ -766,6 +1247,109 @@ NanoImage::Handle NanoVG::createImageFromTextureHandle(GLuint textureId, uint w,
                                                                  static_cast<int>(h), imageFlags));
 }
 
+NanoAsyncImage::Handle NanoVG::createImageFromMemoryAsync(const uchar* data, uint dataSize, int imageFlags)
+{
+    if (fContext == nullptr) return NanoAsyncImage::Handle();
+    DISTRHO_SAFE_ASSERT_RETURN(data != nullptr, NanoAsyncImage::Handle());
+    DISTRHO_SAFE_ASSERT_RETURN(dataSize > 0, NanoAsyncImage::Handle());
+
+    DecodedImage* const decoded = AsyncImageCache::getInstance().acquire(data, dataSize);
+    DISTRHO_SAFE_ASSERT_RETURN(decoded != nullptr, NanoAsyncImage::Handle());
+
+    return NanoAsyncImage::Handle(new NanoAsyncImage::PrivateData(fContext, imageFlags, decoded,
+                                                                  dynamic_cast<Widget*>(this)));
+}
+
+NanoAsyncImage::Handle NanoVG::createImageFromFileAsync(const char* filename, int imageFlags)
+{
+    if (fContext == nullptr) return NanoAsyncImage::Handle();
+    DISTRHO_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', NanoAsyncImage::Handle());
+
+    FILE* const f = std::fopen(filename, "rb");
+    DISTRHO_SAFE_ASSERT_RETURN(f != nullptr, NanoAsyncImage::Handle());
+
+    std::fseek(f, 0, SEEK_END);
+    const long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+
+    uchar* const data = size > 0 ? static_cast<uchar*>(std::malloc(static_cast<size_t>(size))) : nullptr;
+    const bool ok = data != nullptr && std::fread(data, static_cast<size_t>(size), 1, f) == 1;
+    std::fclose(f);
+
+    if (! ok)
+    {
+        d_stderr2("Failed to read image file '%s'", filename);
+        std::free(data);
+        return NanoAsyncImage::Handle();
+    }
+
+    const NanoAsyncImage::Handle handle(createImageFromMemoryAsync(data, static_cast<uint>(size), imageFlags));
+    std::free(data);
+    return handle;
+}
+
+void NanoVG::_uploadAsyncImages()
+{
+    std::vector<NanoAsyncImage::PrivateData*>& pendingImages(NanoAsyncImage::PrivateData::getPendingImages());
+
+    if (pendingImages.empty())
+        return;
+
+    AsyncImageCache& cache(AsyncImageCache::getInstance());
+    size_t uploadedSize = 0;
+
+    for (std::vector<NanoAsyncImage::PrivateData*>::iterator it = pendingImages.begin(); it != pendingImages.end();)
+    {
+        NanoAsyncImage::PrivateData* const pending = *it;
+
+        if (pending->context != fContext)
+        {
+            ++it;
+            continue;
+        }
+
+        const uchar* pixels;
+        int width, height;
+
+        switch (cache.getState(pending->decoded, &pixels, &width, &height))
+        {
+        case DecodedImage::kStateQueued:
+        case DecodedImage::kStateDecoding:
+            ++it;
+            continue;
+
+        case DecodedImage::kStateUploaded:
+            // not possible while this upload is pending
+            DISTRHO_SAFE_ASSERT(false);
+            pending->failed = true;
+            break;
+
+        case DecodedImage::kStateDecoded:
+        {
+            // spread uploads across frames
+            const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+
+            if (uploadedSize != 0 && uploadedSize + size > kAsyncImageUploadBytesPerFrame)
+                return;
+
+            uploadedSize += size;
+            pending->image = NanoImage::Handle(fContext, nvgCreateImageRGBA(fContext, width, height,
+                                                                            pending->imageFlags, pixels));
+            pending->failed = ! pending->image.isValid();
+            break;
+        }
+
+        case DecodedImage::kStateFailed:
+            pending->failed = true;
+            break;
+        }
+
+        // the decoded pixels are freed once every user is done with them
+        cache.uploadDone(pending->decoded);
+        it = pendingImages.erase(it);
+    }
+}
+
 // -----------------------------------------------------------------------
 // Paints
 
@@ -911,6 +1495,43 @@ void NanoVG::stroke()
         nvgStroke(fContext);
 }
 
+// -----------------------------------------------------------------------
+// Recordings
+
+void NanoVG::beginRecording()
+{
+    if (fContext == nullptr)
+        return;
+
+    DISTRHO_SAFE_ASSERT_RETURN(nvgIsRecording(fContext) == 0,);
+
+    nvgBeginRecording(fContext);
+}
+
+NanoRecording::Handle NanoVG::endRecording()
+{
+    if (fContext == nullptr)
+        return NanoRecording::Handle();
+
+    DISTRHO_SAFE_ASSERT_RETURN(nvgIsRecording(fContext) != 0, NanoRecording::Handle());
+
+    return NanoRecording::Handle(nvgEndRecording(fContext));
+}
+
+bool NanoVG::isRecordingOutdated(const NanoRecording& recording)
+{
+    if (fContext == nullptr || recording.fHandle.recording == nullptr)
+        return false;
+
+    return nvgIsRecordingOutdated(fContext, recording.fHandle.recording) != 0;
+}
+
+void NanoVG::drawRecording(const NanoRecording& recording)
+{
+    if (fContext != nullptr && recording.fHandle.recording != nullptr)
+        nvgDrawRecording(fContext, recording.fHandle.recording);
+}
+
 // -----------------------------------------------------------------------
 // Text
 
@@ -1066,25 +1687,95 @@ bool NanoVG::loadSharedResources()
 
     using namespace dpf_resources;
 
-    return nvgCreateFontMem(fContext, NANOVG_DEJAVU_SANS_TTF, (uchar*)dejavusans_ttf, dejavusans_ttf_size, 0) >= 0;
+    // decoded on first use and kept while the library is loaded, contexts use it without making a copy
+    static DISTRHO_NAMESPACE::Resource dejavusans(dejavusans_ttf, dejavusans_ttf_size, dejavusans_ttf_decoded_size);
+
+    const uint8_t* const data = dejavusans.getData();
+    DISTRHO_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+    return nvgCreateFontMem(fContext, NANOVG_DEJAVU_SANS_TTF, (uchar*)data, static_cast<int>(dejavusans.getSize()), 0) >= 0;
 }
 #endif
 
 // -----------------------------------------------------------------------
+// NanoVG contexts shared between NanoSubWidgets
+
+struct SharedNanoContext {
+    Window* window;
+    int flags;
+    NVGcontext* context;
+    uint refCount;
+};
+
+static std::vector<SharedNanoContext> sSharedNanoContexts;
 
 template <class BaseWidget>
-void NanoBaseWidget<BaseWidget>::displayChildren()
+NVGcontext* NanoBaseWidget<BaseWidget>::acquireSharedContext(Widget* const parentWidget, const int flags)
 {
-    std::list<SubWidget*> children(BaseWidget::getChildren());
+    DISTRHO_SAFE_ASSERT_RETURN(parentWidget != nullptr, nullptr);
 
-    for (std::list<SubWidget*>::iterator it = children.begin(); it != children.end(); ++it)
+    if (flags & CREATE_OWN_CONTEXT)
+        return nullptr;
+
+    Window* const window = &parentWidget->getWindow();
+
+    // only reference-counted contexts are shared, contexts owned by a single widget die with it
+    for (std::vector<SharedNanoContext>::iterator it = sSharedNanoContexts.begin(); it != sSharedNanoContexts.end(); ++it)
     {
-        if (NanoSubWidget* const subwidget = dynamic_cast<NanoSubWidget*>(*it))
+        SharedNanoContext& shared(*it);
+
+        if (shared.window == window && shared.flags == flags)
         {
-            if (subwidget->fUsingParentContext && subwidget->isVisible())
-                subwidget->onDisplay();
+            ++shared.refCount;
+            return shared.context;
         }
     }
+
+    NVGcontext* const context = nvgCreateGL(flags);
+    DISTRHO_SAFE_ASSERT_RETURN(context != nullptr, nullptr);
+
+    const SharedNanoContext shared = { window, flags, context, 1 };
+    sSharedNanoContexts.push_back(shared);
+    return context;
+}
+
+template <class BaseWidget>
+NanoBaseWidget<BaseWidget>::~NanoBaseWidget()
+{
+    if (! fUsingSharedContext)
+        return;
+
+    for (std::vector<SharedNanoContext>::iterator it = sSharedNanoContexts.begin(); it != sSharedNanoContexts.end(); ++it)
+    {
+        SharedNanoContext& shared(*it);
+
+        if (shared.context != fContext)
+            continue;
+
+        if (--shared.refCount == 0)
+        {
+            nvgDeleteGL(shared.context);
+            sSharedNanoContexts.erase(it);
+        }
+        break;
+    }
+}
+
+// -----------------------------------------------------------------------
+
+template <class BaseWidget>
+void NanoBaseWidget<BaseWidget>::displayChildren()
+{
+    const std::vector<SubWidget*>& children(Widget::pData->getDrawList());
+
+    for (size_t i = 0, count = children.size(); i < count; ++i)
+    {
+        SubWidget* const child(children[i]);
+
+        // only set for NanoSubWidgets created with this widget as parent context
+        if (child->pData->usingParentContext)
+            static_cast<NanoSubWidget*>(child)->onDisplay();
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -1093,9 +1784,22 @@ void NanoBaseWidget<BaseWidget>::displayChildren()
 template <>
 NanoBaseWidget<SubWidget>::NanoBaseWidget(Widget* const parentWidget, int flags)
     : SubWidget(parentWidget),
-      NanoVG(flags),
-      fUsingParentContext(false)
+      NanoVG(acquireSharedContext(parentWidget, flags), flags),
+      fUsingParentContext(false),
+      fUsingSharedContext(fIsSubWidget)
 {
+    // draw as part of the parent frame when possible, saves a full GPU flush per widget
+    if (NanoVG* const parentNanoVG = dynamic_cast<NanoVG*>(parentWidget))
+    {
+        if (fUsingSharedContext && parentNanoVG->fContext == fContext)
+        {
+            fUsingParentContext = true;
+            SubWidget::pData->usingParentContext = true;
+            setSkipDrawing();
+            return;
+        }
+    }
+
     setNeedsViewportScaling();
 }
 
@@ -1103,8 +1807,10 @@ template <>
 NanoBaseWidget<SubWidget>::NanoBaseWidget(NanoSubWidget* const parentWidget)
     : SubWidget(parentWidget),
       NanoVG(parentWidget->getContext()),
-      fUsingParentContext(true)
+      fUsingParentContext(true),
+      fUsingSharedContext(false)
 {
+    SubWidget::pData->usingParentContext = true;
     setSkipDrawing();
 }
 
@@ -1112,15 +1818,42 @@ template <>
 NanoBaseWidget<SubWidget>::NanoBaseWidget(NanoTopLevelWidget* const parentWidget)
     : SubWidget(parentWidget),
       NanoVG(parentWidget->getContext()),
-      fUsingParentContext(true)
+      fUsingParentContext(true),
+      fUsingSharedContext(false)
 {
+    SubWidget::pData->usingParentContext = true;
     setSkipDrawing();
 }
 
 template <>
 inline void NanoBaseWidget<SubWidget>::onDisplay()
 {
-    if (fUsingParentContext)
+    if (fUsingParentContext && fUsingSharedContext)
+    {
+        // the parent frame starts at the position of the closest widget that is not part of another frame
+        Widget* frameWidget = SubWidget::getParentWidget();
+        SubWidget* frameSubWidget;
+
+        while ((frameSubWidget = dynamic_cast<SubWidget*>(frameWidget)) != nullptr
+               && frameSubWidget->pData->usingParentContext)
+            frameWidget = frameSubWidget->getParentWidget();
+
+        // same initial state as a separate frame, clipped to widget bounds
+        NanoVG::save();
+        NanoVG::reset();
+
+        if (frameSubWidget != nullptr)
+            translate(SubWidget::getAbsoluteX() - frameSubWidget->getAbsoluteX(),
+                      SubWidget::getAbsoluteY() - frameSubWidget->getAbsoluteY());
+        else
+            translate(SubWidget::getAbsoluteX(), SubWidget::getAbsoluteY());
+
+        scissor(0, 0, SubWidget::getWidth(), SubWidget::getHeight());
+        onNanoDisplay();
+        NanoVG::restore();
+        displayChildren();
+    }
+    else if (fUsingParentContext)
     {
         NanoVG::save();
         translate(SubWidget::getAbsoluteX(), SubWidget::getAbsoluteY());
@@ -1146,7 +1879,8 @@ template <>
 NanoBaseWidget<TopLevelWidget>::NanoBaseWidget(Window& windowToMapTo, int flags)
     : TopLevelWidget(windowToMapTo),
       NanoVG(flags),
-      fUsingParentContext(false) {}
+      fUsingParentContext(false),
+      fUsingSharedContext(false) {}
 
 template <>
 inline void NanoBaseWidget<TopLevelWidget>::onDisplay()
@@ -1166,13 +1900,15 @@ template <>
 NanoBaseWidget<StandaloneWindow>::NanoBaseWidget(Application& app, int flags)
     : StandaloneWindow(app),
       NanoVG(flags),
-      fUsingParentContext(false) {}
+      fUsingParentContext(false),
+      fUsingSharedContext(false) {}
 
 template <>
 NanoBaseWidget<StandaloneWindow>::NanoBaseWidget(Application& app, Window& parentWindow, int flags)
     : StandaloneWindow(app, parentWindow),
       NanoVG(flags),
-      fUsingParentContext(false) {}
+      fUsingParentContext(false),
+      fUsingSharedContext(false) {}
 
 template <>
 inline void NanoBaseWidget<StandaloneWindow>::onDisplay()
@@ -44,6 +44,272 @@ static void notImplemented(const char* const name)
 # define DGL_USE_COMPAT_OPENGL
 #endif
 
+// -----------------------------------------------------------------------
+// Framebuffer objects, used for subwidget render caches
+
+#ifdef DGL_USE_COMPAT_OPENGL
+# if defined(DISTRHO_OS_WINDOWS)
+#  include <windows.h>
+#  define DGL_EXT(PROC, func) static PROC func;
+DGL_EXT(PFNGLBINDFRAMEBUFFERPROC,         glBindFramebuffer)
+DGL_EXT(PFNGLBINDRENDERBUFFERPROC,        glBindRenderbuffer)
+DGL_EXT(PFNGLCHECKFRAMEBUFFERSTATUSPROC,  glCheckFramebufferStatus)
+DGL_EXT(PFNGLDELETEFRAMEBUFFERSPROC,      glDeleteFramebuffers)
+DGL_EXT(PFNGLDELETERENDERBUFFERSPROC,     glDeleteRenderbuffers)
+DGL_EXT(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer)
+DGL_EXT(PFNGLFRAMEBUFFERTEXTURE2DPROC,    glFramebufferTexture2D)
+DGL_EXT(PFNGLGENFRAMEBUFFERSPROC,         glGenFramebuffers)
+DGL_EXT(PFNGLGENRENDERBUFFERSPROC,        glGenRenderbuffers)
+DGL_EXT(PFNGLRENDERBUFFERSTORAGEPROC,     glRenderbufferStorage)
+#  undef DGL_EXT
+# elif defined(DISTRHO_OS_MAC)
+#  include <OpenGL/glext.h>
+#  define glBindFramebuffer         glBindFramebufferEXT
+#  define glBindRenderbuffer        glBindRenderbufferEXT
+#  define glCheckFramebufferStatus  glCheckFramebufferStatusEXT
+#  define glDeleteFramebuffers      glDeleteFramebuffersEXT
+#  define glDeleteRenderbuffers     glDeleteRenderbuffersEXT
+#  define glFramebufferRenderbuffer glFramebufferRenderbufferEXT
+#  define glFramebufferTexture2D    glFramebufferTexture2DEXT
+#  define glGenFramebuffers         glGenFramebuffersEXT
+#  define glGenRenderbuffers        glGenRenderbuffersEXT
+#  define glRenderbufferStorage     glRenderbufferStorageEXT
+#  ifndef GL_FRAMEBUFFER
+#   define GL_COLOR_ATTACHMENT0     GL_COLOR_ATTACHMENT0_EXT
+#   define GL_FRAMEBUFFER           GL_FRAMEBUFFER_EXT
+#   define GL_FRAMEBUFFER_BINDING   GL_FRAMEBUFFER_BINDING_EXT
+#   define GL_FRAMEBUFFER_COMPLETE  GL_FRAMEBUFFER_COMPLETE_EXT
+#   define GL_RENDERBUFFER          GL_RENDERBUFFER_EXT
+#   define GL_STENCIL_ATTACHMENT    GL_STENCIL_ATTACHMENT_EXT
+#   define GL_STENCIL_INDEX8        GL_STENCIL_INDEX8_EXT
+#  endif
+# endif
+
+static bool hasFramebufferSupport()
+{
+   #ifdef DISTRHO_OS_WINDOWS
+    static bool needsInit = true;
+    static bool supported = false;
+
+    if (needsInit)
+    {
+        needsInit = false;
+
+       # if defined(__GNUC__) && (__GNUC__ >= 9)
+       #  pragma GCC diagnostic push
+       #  pragma GCC diagnostic ignored "-Wcast-function-type"
+       # endif
+       # define DGL_EXT(PROC, func) \
+          func = (PROC) wglGetProcAddress ( #func ); \
+          if (func == nullptr) return false;
+        DGL_EXT(PFNGLBINDFRAMEBUFFERPROC,         glBindFramebuffer)
+        DGL_EXT(PFNGLBINDRENDERBUFFERPROC,        glBindRenderbuffer)
+        DGL_EXT(PFNGLCHECKFRAMEBUFFERSTATUSPROC,  glCheckFramebufferStatus)
+        DGL_EXT(PFNGLDELETEFRAMEBUFFERSPROC,      glDeleteFramebuffers)
+        DGL_EXT(PFNGLDELETERENDERBUFFERSPROC,     glDeleteRenderbuffers)
+        DGL_EXT(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer)
+        DGL_EXT(PFNGLFRAMEBUFFERTEXTURE2DPROC,    glFramebufferTexture2D)
+        DGL_EXT(PFNGLGENFRAMEBUFFERSPROC,         glGenFramebuffers)
+        DGL_EXT(PFNGLGENRENDERBUFFERSPROC,        glGenRenderbuffers)
+        DGL_EXT(PFNGLRENDERBUFFERSTORAGEPROC,     glRenderbufferStorage)
+       # undef DGL_EXT
+       # if defined(__GNUC__) && (__GNUC__ >= 9)
+       #  pragma GCC diagnostic pop
+       # endif
+
+        supported = true;
+    }
+
+    return supported;
+   #else
+    return true;
+   #endif
+}
+
+// texture with a stencil buffer (needed by NanoVG), bound through a framebuffer object for drawing into
+struct OpenGLFramebuffer {
+    GLuint framebuffer;
+    GLuint stencilbuffer;
+    GLuint texture;
+    GLint previousFramebuffer;
+
+    OpenGLFramebuffer() noexcept
+        : framebuffer(0),
+          stencilbuffer(0),
+          texture(0),
+          previousFramebuffer(0) {}
+
+    bool create(const uint w, const uint h)
+    {
+        if (! hasFramebufferSupport())
+            return false;
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, static_cast<GLsizei>(w), static_cast<GLsizei>(h), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glGenRenderbuffers(1, &stencilbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, stencilbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, static_cast<GLsizei>(w), static_cast<GLsizei>(h));
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        GLint prevFramebuffer = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, stencilbuffer);
+
+        const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevFramebuffer));
+
+        return complete;
+    }
+
+    // must be called with the owning graphics context active
+    void release()
+    {
+        if (framebuffer != 0)
+        {
+            glDeleteFramebuffers(1, &framebuffer);
+            framebuffer = 0;
+        }
+
+        if (stencilbuffer != 0)
+        {
+            glDeleteRenderbuffers(1, &stencilbuffer);
+            stencilbuffer = 0;
+        }
+
+        if (texture != 0)
+        {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+
+    // bind framebuffer for drawing and clear it to full transparency
+    void begin()
+    {
+        GLfloat clearColor[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glClearColor(0.f, 0.f, 0.f, 0.f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    }
+
+    void end()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(OpenGLFramebuffer)
+};
+
+// subwidget drawing stored in a framebuffer texture, with premultiplied alpha
+// must be deleted with the window graphics context active, see SubWidget::PrivateData::freeRenderCache
+struct OpenGLRenderCache : SubWidgetRenderCache {
+    OpenGLFramebuffer fbo;
+
+    OpenGLRenderCache() noexcept
+        : fbo() {}
+
+    ~OpenGLRenderCache() override
+    {
+        fbo.release();
+    }
+
+    bool needsGraphicsContext() const noexcept override
+    {
+        return fbo.framebuffer != 0 || fbo.stencilbuffer != 0 || fbo.texture != 0;
+    }
+
+    void abandon() noexcept override
+    {
+        fbo.framebuffer = fbo.stencilbuffer = fbo.texture = 0;
+    }
+
+    // bind framebuffer for drawing into the cache, (re)creating it if needed
+    bool begin(const uint w, const uint h)
+    {
+        if (fbo.framebuffer == 0 || w != width || h != height)
+        {
+            fbo.release();
+            setSize(0, 0);
+
+            if (! fbo.create(w, h))
+            {
+                fbo.release();
+                return false;
+            }
+
+            setSize(w, h);
+        }
+
+        fbo.begin();
+        return true;
+    }
+
+    void end()
+    {
+        fbo.end();
+    }
+
+    // draw cache contents at a position in window pixels, with bottom-left origin
+    void draw(const int x, const int y)
+    {
+        glViewport(x, y, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        // cache contents have premultiplied alpha
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        glColor4f(1.f, 1.f, 1.f, 1.f);
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, fbo.texture);
+
+        glBegin(GL_QUADS);
+        {
+            glTexCoord2f(0.f, 0.f);
+            glVertex2f(-1.f, -1.f);
+
+            glTexCoord2f(1.f, 0.f);
+            glVertex2f(1.f, -1.f);
+
+            glTexCoord2f(1.f, 1.f);
+            glVertex2f(1.f, 1.f);
+
+            glTexCoord2f(0.f, 1.f);
+            glVertex2f(-1.f, 1.f);
+        }
+        glEnd();
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+    }
+};
+#endif
+
 // -----------------------------------------------------------------------
 // Color
 
@@ -680,9 +946,17 @@ template class ImageBaseSwitch<OpenGLImage>;
 void SubWidget::PrivateData::display(const uint width, const uint height, const double autoScaleFactor)
 {
     if (skipDrawing)
+    {
+        // NanoSubWidgets drawn by their parent can still have regular subwidgets
+        if (usingParentContext)
+            selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
         return;
+    }
 
-    bool needsDisableScissor = false;
+    // viewport used for drawing, and widget area within the window (in pixels, bottom-left origin)
+    int viewportX, viewportY, viewportWidth, viewportHeight;
+    int areaX, areaY, areaWidth, areaHeight;
+    bool needsScissor = false;
 
     if (needsViewportScaling)
     {
@@ -693,44 +967,103 @@ void SubWidget::PrivateData::display(const uint width, const uint height, const
 
         if (d_isNotZero(viewportScaleFactor) && d_isNotEqual(viewportScaleFactor, 1.0))
         {
-            glViewport(x,
-                       -d_roundToIntPositive(height * viewportScaleFactor - height + absolutePos.getY()),
-                       d_roundToIntPositive(width * viewportScaleFactor),
-                       d_roundToIntPositive(height * viewportScaleFactor));
+            viewportX = x;
+            viewportY = -d_roundToIntPositive(height * viewportScaleFactor - height + absolutePos.getY());
+            viewportWidth = d_roundToIntPositive(width * viewportScaleFactor);
+            viewportHeight = d_roundToIntPositive(height * viewportScaleFactor);
+            areaWidth = d_roundToIntPositive(w * viewportScaleFactor);
+            areaHeight = d_roundToIntPositive(h * viewportScaleFactor);
+            areaX = x;
+            areaY = viewportY + viewportHeight - areaHeight;
         }
         else
         {
             const int y = static_cast<int>(height - self->getHeight()) - absolutePos.getY();
-            glViewport(x, y, w, h);
+            viewportX = areaX = x;
+            viewportY = areaY = y;
+            viewportWidth = areaWidth = w;
+            viewportHeight = areaHeight = h;
         }
     }
     else if (needsFullViewportForDrawing || (absolutePos.isZero() && self->getSize() == Size<uint>(width, height)))
     {
         // full viewport size
-        glViewport(0, 0, static_cast<int>(width), static_cast<int>(height));
+        viewportX = areaX = 0;
+        viewportY = areaY = 0;
+        viewportWidth = areaWidth = static_cast<int>(width);
+        viewportHeight = areaHeight = static_cast<int>(height);
     }
     else
     {
         // set viewport pos
-        glViewport(d_roundToIntPositive(absolutePos.getX() * autoScaleFactor),
-                   -d_roundToIntPositive(absolutePos.getY() * autoScaleFactor),
-                   static_cast<int>(width),
-                   static_cast<int>(height));
+        viewportX = d_roundToIntPositive(absolutePos.getX() * autoScaleFactor);
+        viewportY = -d_roundToIntPositive(absolutePos.getY() * autoScaleFactor);
+        viewportWidth = static_cast<int>(width);
+        viewportHeight = static_cast<int>(height);
 
         // then cut the outer bounds
-        glScissor(d_roundToIntPositive(absolutePos.getX() * autoScaleFactor),
-                  d_roundToIntPositive(height - (static_cast<int>(self->getHeight()) + absolutePos.getY()) * autoScaleFactor),
-                  d_roundToIntPositive(self->getWidth() * autoScaleFactor),
-                  d_roundToIntPositive(self->getHeight() * autoScaleFactor));
+        areaX = d_roundToIntPositive(absolutePos.getX() * autoScaleFactor);
+        areaY = d_roundToIntPositive(height - (static_cast<int>(self->getHeight()) + absolutePos.getY()) * autoScaleFactor);
+        areaWidth = d_roundToIntPositive(self->getWidth() * autoScaleFactor);
+        areaHeight = d_roundToIntPositive(self->getHeight() * autoScaleFactor);
+        needsScissor = true;
+    }
+
+   #ifdef DGL_USE_COMPAT_OPENGL
+    if (cached && ! needsFullViewportForDrawing && areaWidth > 0 && areaHeight > 0)
+    {
+        OpenGLRenderCache* cache = static_cast<OpenGLRenderCache*>(renderCache);
+
+        if (cache == nullptr)
+            renderCache = cache = new OpenGLRenderCache;
 
+        const uint cacheWidth = static_cast<uint>(areaWidth);
+        const uint cacheHeight = static_cast<uint>(areaHeight);
+
+        if (cacheNeedsUpdate || cache->width != cacheWidth || cache->height != cacheHeight)
+        {
+            if (cache->begin(cacheWidth, cacheHeight))
+            {
+                // same viewport as on screen, moved so that the widget area matches the cache
+                glViewport(viewportX - areaX, viewportY - areaY, viewportWidth, viewportHeight);
+                self->onDisplay();
+                cache->end();
+                cacheNeedsUpdate = false;
+            }
+            else
+            {
+                // offscreen rendering is not possible, stop trying
+                d_stderr2("Failed to create render cache for subwidget, drawing it directly");
+                cached = false;
+                freeRenderCache();
+            }
+        }
+
+        if (renderCache != nullptr)
+        {
+            cache->draw(areaX, areaY);
+            selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
+            return;
+        }
+    }
+    else if (renderCache != nullptr)
+    {
+        freeRenderCache();
+    }
+   #endif
+
+    glViewport(viewportX, viewportY, viewportWidth, viewportHeight);
+
+    if (needsScissor)
+    {
+        glScissor(areaX, areaY, areaWidth, areaHeight);
         glEnable(GL_SCISSOR_TEST);
-        needsDisableScissor = true;
     }
 
     // display widget
     self->onDisplay();
 
-    if (needsDisableScissor)
+    if (needsScissor)
         glDisable(GL_SCISSOR_TEST);
 
     selfw->pData->displaySubWidgets(width, height, autoScaleFactor);
@@ -787,6 +1120,68 @@ void Window::PrivateData::renderToPicture(const char* const filename,
     fclose(f);
 }
 
+bool Window::PrivateData::renderToMemory(void* const pixels, const uint stride)
+{
+#ifdef DGL_USE_COMPAT_OPENGL
+    DISTRHO_SAFE_ASSERT_RETURN(view != nullptr, false);
+
+    const PuglRect rect = puglGetFrame(view);
+    const uint width = static_cast<uint>(rect.width);
+    const uint height = static_cast<uint>(rect.height);
+    DISTRHO_SAFE_ASSERT_RETURN(width > 0 && height > 0, false);
+    DISTRHO_SAFE_ASSERT_RETURN(stride >= width * 4, false);
+
+    if (! puglBackendEnter(view))
+        return false;
+
+    OpenGLFramebuffer fbo;
+    const bool ok = fbo.create(width, height);
+
+    if (ok)
+    {
+        // start from a clear image, like a freshly exposed window
+        fbo.begin();
+        glLoadIdentity();
+        displayTopLevelWidgets();
+
+        GLubyte* const rgba = new GLubyte[width * height * 4];
+        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                     GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+        fbo.end();
+
+        // framebuffer rows start at the bottom, convert to top-down native-endian ARGB
+        for (uint y = 0; y < height; ++y)
+        {
+            const GLubyte* src = rgba + (height - y - 1) * width * 4;
+            uint32_t* const dst = reinterpret_cast<uint32_t*>(static_cast<uchar*>(pixels) + y * stride);
+
+            for (uint x = 0; x < width; ++x, src += 4)
+                dst[x] = static_cast<uint32_t>(src[3]) << 24
+                       | static_cast<uint32_t>(src[0]) << 16
+                       | static_cast<uint32_t>(src[1]) << 8
+                       | static_cast<uint32_t>(src[2]);
+        }
+
+        delete[] rgba;
+    }
+    else
+    {
+        d_stderr2("Failed to create framebuffer for Window::renderToMemory");
+    }
+
+    fbo.release();
+    puglBackendLeave(view);
+    return ok;
+#else
+    // framebuffer objects are only used with compatibility OpenGL for now
+    notImplemented("Window::PrivateData::renderToMemory");
+    return false;
+    // unused
+    (void)pixels;
+    (void)stride;
+#endif
+}
+
 // -----------------------------------------------------------------------
 
 const GraphicsContext& Window::PrivateData::getGraphicsContext() const noexcept
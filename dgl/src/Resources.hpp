@@ -6,7 +6,8 @@
 namespace dpf_resources
 {
     extern const char* dejavusans_ttf;
-    const unsigned int dejavusans_ttf_size = 741536;
+    const unsigned int dejavusans_ttf_size = 445942;
+    const unsigned int dejavusans_ttf_decoded_size = 741536;
 };
 
 #endif
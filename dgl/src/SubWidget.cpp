@@ -16,8 +16,11 @@
 
 #include "SubWidgetPrivateData.hpp"
 #include "WidgetPrivateData.hpp"
+#include "WindowPrivateData.hpp"
 #include "../TopLevelWidget.hpp"
 
+#include <algorithm>
+
 START_NAMESPACE_DGL
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -106,6 +109,7 @@ void SubWidget::setAbsolutePos(const Point<int>& pos) noexcept
     ev.pos = pos;
 
     pData->absolutePos = pos;
+    pData->parentWidget->pData->subWidgetsChanged();
     onPositionChanged(ev);
 
     repaint();
@@ -119,11 +123,13 @@ Point<int> SubWidget::getMargin() const noexcept
 void SubWidget::setMargin(const int x, const int y) noexcept
 {
     pData->margin = Point<int>(x, y);
+    pData->parentWidget->pData->subWidgetsChanged();
 }
 
 void SubWidget::setMargin(const Point<int>& offset) noexcept
 {
     pData->margin = offset;
+    pData->parentWidget->pData->subWidgetsChanged();
 }
 
 Widget* SubWidget::getParentWidget() const noexcept
@@ -133,33 +139,52 @@ Widget* SubWidget::getParentWidget() const noexcept
 
 void SubWidget::repaint() noexcept
 {
+    // subwidgets drawn by their parent are part of the parent cache
+    for (SubWidget* widget = this;;)
+    {
+        widget->pData->cacheNeedsUpdate = true;
+
+        if (! widget->pData->skipDrawing || widget->pData->parentWidget == widget->getTopLevelWidget())
+            break;
+
+        widget = static_cast<SubWidget*>(widget->pData->parentWidget);
+    }
+
     if (! isVisible())
         return;
 
     if (TopLevelWidget* const topw = getTopLevelWidget())
     {
+        Window::PrivateData* const windowData = topw->getWindow().pData;
+        windowData->repaintCause = this;
+
         if (pData->needsFullViewportForDrawing)
             // repaint is virtual and we want precisely the top-level specific implementation, not any higher level
             topw->TopLevelWidget::repaint();
         else
             topw->repaint(getConstrainedAbsoluteArea());
+
+        // in case the top-level widget did not forward the request to the window
+        windowData->repaintCause = nullptr;
     }
 }
 
 void SubWidget::toBottom()
 {
-    std::list<SubWidget*>& subwidgets(pData->parentWidget->pData->subWidgets);
+    std::vector<SubWidget*>& subwidgets(pData->parentWidget->pData->subWidgets);
 
-    subwidgets.remove(this);
+    subwidgets.erase(std::remove(subwidgets.begin(), subwidgets.end(), this), subwidgets.end());
     subwidgets.insert(subwidgets.begin(), this);
+    pData->parentWidget->pData->subWidgetsChanged();
 }
 
 void SubWidget::toFront()
 {
-    std::list<SubWidget*>& subwidgets(pData->parentWidget->pData->subWidgets);
+    std::vector<SubWidget*>& subwidgets(pData->parentWidget->pData->subWidgets);
 
-    subwidgets.remove(this);
+    subwidgets.erase(std::remove(subwidgets.begin(), subwidgets.end(), this), subwidgets.end());
     subwidgets.push_back(this);
+    pData->parentWidget->pData->subWidgetsChanged();
 }
 
 void SubWidget::setNeedsFullViewportDrawing(const bool needsFullViewportForDrawing)
@@ -178,6 +203,32 @@ void SubWidget::setSkipDrawing(const bool skipDrawing)
     pData->skipDrawing = skipDrawing;
 }
 
+bool SubWidget::isCached() const noexcept
+{
+    return pData->cached;
+}
+
+void SubWidget::setCached(const bool cached)
+{
+    if (pData->cached == cached)
+        return;
+
+    // cache data is freed on the next draw, where the graphics context is active
+    pData->cached = cached;
+    pData->cacheNeedsUpdate = true;
+    repaint();
+}
+
+size_t SubWidget::getCacheSize() const noexcept
+{
+    return pData->renderCache != nullptr ? pData->renderCache->size : 0;
+}
+
+size_t SubWidget::getTotalCacheSize() noexcept
+{
+    return SubWidgetRenderCache::totalSize;
+}
+
 void SubWidget::onPositionChanged(const PositionChangedEvent&)
 {
 }
@@ -16,6 +16,9 @@
 
 #include "SubWidgetPrivateData.hpp"
 #include "WidgetPrivateData.hpp"
+#include "WindowPrivateData.hpp"
+
+#include <algorithm>
 
 START_NAMESPACE_DGL
 
@@ -30,16 +33,63 @@ SubWidget::PrivateData::PrivateData(SubWidget* const s, Widget* const pw)
       needsFullViewportForDrawing(false),
       needsViewportScaling(false),
       skipDrawing(false),
-      viewportScaleFactor(0.0)
+      usingParentContext(false),
+      viewportScaleFactor(0.0),
+      cached(false),
+      cacheNeedsUpdate(true),
+      renderCache(nullptr)
 {
     parentWidget->pData->subWidgets.push_back(self);
+    parentWidget->pData->subWidgetsChanged();
 }
 
 SubWidget::PrivateData::~PrivateData()
 {
-    parentWidget->pData->subWidgets.remove(self);
+    freeRenderCache();
+
+    std::vector<SubWidget*>& subWidgets(parentWidget->pData->subWidgets);
+    subWidgets.erase(std::remove(subWidgets.begin(), subWidgets.end(), self), subWidgets.end());
+    parentWidget->pData->subWidgetsChanged();
+
+    if (SubWidgetIndex* const index = parentWidget->pData->subWidgetIndex)
+        index->widgetRemoved(self);
+}
+
+void SubWidget::PrivateData::freeRenderCache()
+{
+    cacheNeedsUpdate = true;
+
+    if (renderCache == nullptr)
+        return;
+
+    // the window is queried now instead of when the cache was created, caches are freed before it goes away
+    if (renderCache->needsGraphicsContext())
+    {
+        Window::PrivateData* const windowData = selfw->getWindow().pData;
+
+        // the window graphics context is only active while drawing, make it active otherwise
+        if (! windowData->isDisplaying)
+        {
+            if (windowData->view != nullptr && puglBackendEnter(windowData->view))
+            {
+                delete renderCache;
+                renderCache = nullptr;
+                puglBackendLeave(windowData->view);
+                return;
+            }
+
+            renderCache->abandon();
+        }
+    }
+
+    delete renderCache;
+    renderCache = nullptr;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
+size_t SubWidgetRenderCache::totalSize = 0;
+
+// --------------------------------------------------------------------------------------------------------------------
+
 END_NAMESPACE_DGL
@@ -21,6 +21,46 @@
 
 START_NAMESPACE_DGL
 
+// --------------------------------------------------------------------------------------------------------------------
+// offscreen copy of a subwidget drawing, implemented by each graphics backend
+
+struct SubWidgetRenderCache {
+    uint width, height; // in pixels
+    size_t size;
+
+    SubWidgetRenderCache() noexcept
+        : width(0),
+          height(0),
+          size(0) {}
+
+    virtual ~SubWidgetRenderCache()
+    {
+        totalSize -= size;
+    }
+
+    // whether the destructor releases resources tied to the window graphics context
+    virtual bool needsGraphicsContext() const noexcept
+    {
+        return false;
+    }
+
+    // forget about such resources without releasing them, used when the graphics context is unavailable
+    virtual void abandon() noexcept {}
+
+    void setSize(const uint w, const uint h) noexcept
+    {
+        totalSize -= size;
+        width = w;
+        height = h;
+        size = static_cast<size_t>(w) * h * 4;
+        totalSize += size;
+    }
+
+    static size_t totalSize;
+
+    DISTRHO_DECLARE_NON_COPYABLE(SubWidgetRenderCache)
+};
+
 // --------------------------------------------------------------------------------------------------------------------
 
 struct SubWidget::PrivateData {
@@ -32,11 +72,17 @@ struct SubWidget::PrivateData {
     bool needsFullViewportForDrawing; // needed for widgets drawing out of bounds
     bool needsViewportScaling; // needed for NanoVG
     bool skipDrawing; // for context reuse in NanoVG based guis
+    bool usingParentContext; // NanoSubWidget drawn by its parent, set on creation
     double viewportScaleFactor; // auto-scaling for NanoVG
+    bool cached;
+    bool cacheNeedsUpdate;
+    SubWidgetRenderCache* renderCache;
 
     explicit PrivateData(SubWidget* const s, Widget* const pw);
     ~PrivateData();
 
+    void freeRenderCache();
+
     // NOTE display function is different depending on build type, must call displaySubWidgets at the end
     void display(uint width, uint height, double autoScaleFactor);
 
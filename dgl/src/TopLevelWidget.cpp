@@ -15,7 +15,7 @@
  */
 
 #include "TopLevelWidgetPrivateData.hpp"
-#include "../Window.hpp"
+#include "WindowPrivateData.hpp"
 
 START_NAMESPACE_DGL
 
@@ -92,12 +92,32 @@ double TopLevelWidget::getScaleFactor() const noexcept
 
 void TopLevelWidget::repaint() noexcept
 {
+    Window::PrivateData* const windowData = pData->window.pData;
+    const bool setRepaintCause = windowData->repaintCause == nullptr;
+
+    if (setRepaintCause)
+        windowData->repaintCause = this;
+
     pData->window.repaint();
+
+    // in case the window did not take the request
+    if (setRepaintCause)
+        windowData->repaintCause = nullptr;
 }
 
 void TopLevelWidget::repaint(const Rectangle<uint>& rect) noexcept
 {
+    Window::PrivateData* const windowData = pData->window.pData;
+    const bool setRepaintCause = windowData->repaintCause == nullptr;
+
+    if (setRepaintCause)
+        windowData->repaintCause = this;
+
     pData->window.repaint(rect);
+
+    // in case the window did not take the request
+    if (setRepaintCause)
+        windowData->repaintCause = nullptr;
 }
 
 void TopLevelWidget::setGeometryConstraints(const uint minimumWidth,
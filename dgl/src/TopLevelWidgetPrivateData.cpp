@@ -47,6 +47,11 @@ TopLevelWidget::PrivateData::~PrivateData()
     window.pData->topLevelWidgets.remove(self);
 }
 
+void TopLevelWidget::PrivateData::freeRenderCaches()
+{
+    selfw->pData->freeSubWidgetRenderCaches();
+}
+
 bool TopLevelWidget::PrivateData::keyboardEvent(const KeyboardEvent& ev)
 {
     // ignore event if we are not visible
@@ -236,6 +236,12 @@ void Window::PrivateData::renderToPicture(const char*, const GraphicsContext&, u
     notImplemented("Window::PrivateData::renderToPicture");
 }
 
+bool Window::PrivateData::renderToMemory(void*, uint)
+{
+    notImplemented("Window::PrivateData::renderToMemory");
+    return false;
+}
+
 // -----------------------------------------------------------------------
 
 const GraphicsContext& Window::PrivateData::getGraphicsContext() const noexcept
@@ -45,6 +45,10 @@ void Widget::setVisible(bool visible)
         return;
 
     pData->visible = visible;
+
+    if (pData->parentWidget != nullptr)
+        pData->parentWidget->pData->drawListNeedsUpdate = true;
+
     repaint();
 
     // FIXME check case of hiding a previously visible widget, does it trigger a repaint?
@@ -60,6 +64,22 @@ void Widget::hide()
     setVisible(false);
 }
 
+void Widget::setUsingSubWidgetIndex(const bool enabled)
+{
+    if (enabled == (pData->subWidgetIndex != nullptr))
+        return;
+
+    if (enabled)
+    {
+        pData->subWidgetIndex = new SubWidgetIndex;
+    }
+    else
+    {
+        delete pData->subWidgetIndex;
+        pData->subWidgetIndex = nullptr;
+    }
+}
+
 uint Widget::getWidth() const noexcept
 {
     return pData->size.getWidth();
@@ -85,6 +105,10 @@ void Widget::setWidth(uint width) noexcept
     ev.size    = Size<uint>(width, pData->size.getHeight());
 
     pData->size.setWidth(width);
+
+    if (pData->parentWidget != nullptr)
+        pData->parentWidget->pData->subWidgetsChanged();
+
     onResize(ev);
 
     repaint();
@@ -100,6 +124,10 @@ void Widget::setHeight(uint height) noexcept
     ev.size    = Size<uint>(pData->size.getWidth(), height);
 
     pData->size.setHeight(height);
+
+    if (pData->parentWidget != nullptr)
+        pData->parentWidget->pData->subWidgetsChanged();
+
     onResize(ev);
 
     repaint();
@@ -120,6 +148,10 @@ void Widget::setSize(const Size<uint>& size) noexcept
     ev.size    = size;
 
     pData->size = size;
+
+    if (pData->parentWidget != nullptr)
+        pData->parentWidget->pData->subWidgetsChanged();
+
     onResize(ev);
 
     repaint();
@@ -150,7 +182,7 @@ TopLevelWidget* Widget::getTopLevelWidget() const noexcept
 
 std::list<SubWidget*> Widget::getChildren() const noexcept
 {
-    return pData->subWidgets;
+    return std::list<SubWidget*>(pData->subWidgets.begin(), pData->subWidgets.end());
 }
 
 void Widget::repaint() noexcept
@@ -16,15 +16,20 @@
 
 #include "WidgetPrivateData.hpp"
 #include "SubWidgetPrivateData.hpp"
+#include "../Application.hpp"
 #include "../TopLevelWidget.hpp"
+#include "../Window.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 START_NAMESPACE_DGL
 
 #define FOR_EACH_SUBWIDGET(it) \
-  for (std::list<SubWidget*>::iterator it = subWidgets.begin(); it != subWidgets.end(); ++it)
+  for (std::vector<SubWidget*>::iterator it = subWidgets.begin(); it != subWidgets.end(); ++it)
 
 #define FOR_EACH_SUBWIDGET_INV(rit) \
-  for (std::list<SubWidget*>::reverse_iterator rit = subWidgets.rbegin(); rit != subWidgets.rend(); ++rit)
+  for (std::vector<SubWidget*>::reverse_iterator rit = subWidgets.rbegin(); rit != subWidgets.rend(); ++rit)
 
 // -----------------------------------------------------------------------
 
@@ -37,7 +42,10 @@ Widget::PrivateData::PrivateData(Widget* const s, TopLevelWidget* const tlw)
       needsScaling(false),
       visible(true),
       size(0, 0),
-      subWidgets() {}
+      subWidgets(),
+      subWidgetIndex(nullptr),
+      drawList(),
+      drawListNeedsUpdate(false) {}
 
 Widget::PrivateData::PrivateData(Widget* const s, Widget* const pw)
     : self(s),
@@ -48,25 +56,73 @@ Widget::PrivateData::PrivateData(Widget* const s, Widget* const pw)
       needsScaling(false),
       visible(true),
       size(0, 0),
-      subWidgets() {}
+      subWidgets(),
+      subWidgetIndex(nullptr),
+      drawList(),
+      drawListNeedsUpdate(false) {}
 
 Widget::PrivateData::~PrivateData()
 {
     subWidgets.clear();
+    delete subWidgetIndex;
     std::free(name);
 }
 
+const std::vector<SubWidget*>& Widget::PrivateData::getDrawList()
+{
+    if (drawListNeedsUpdate)
+    {
+        drawListNeedsUpdate = false;
+        drawList.clear();
+
+        FOR_EACH_SUBWIDGET(it)
+        {
+            SubWidget* const widget(*it);
+
+            if (widget->isVisible())
+                drawList.push_back(widget);
+        }
+    }
+
+    return drawList;
+}
+
 void Widget::PrivateData::displaySubWidgets(const uint width, const uint height, const double autoScaleFactor)
 {
     if (subWidgets.size() == 0)
         return;
 
-    for (std::list<SubWidget*>::iterator it = subWidgets.begin(); it != subWidgets.end(); ++it)
+    Window::DisplayTimingCallback* const timingCallback = topLevelWidget != nullptr
+                                                        ? topLevelWidget->getWindow().getDisplayTimingCallback()
+                                                        : nullptr;
+
+    const std::vector<SubWidget*>& widgets(getDrawList());
+
+    for (size_t i = 0, count = widgets.size(); i < count; ++i)
     {
-        SubWidget* const subwidget(*it);
+        SubWidget* const subwidget(widgets[i]);
 
-        if (subwidget->isVisible())
+        if (timingCallback != nullptr)
+        {
+            const double startTime = subwidget->getApp().getTime();
             subwidget->pData->display(width, height, autoScaleFactor);
+            timingCallback->widgetDisplayed(subwidget, subwidget->getApp().getTime() - startTime);
+        }
+        else
+        {
+            subwidget->pData->display(width, height, autoScaleFactor);
+        }
+    }
+}
+
+void Widget::PrivateData::freeSubWidgetRenderCaches()
+{
+    for (std::vector<SubWidget*>::iterator it = subWidgets.begin(); it != subWidgets.end(); ++it)
+    {
+        SubWidget* const subwidget(*it);
+
+        subwidget->pData->freeRenderCache();
+        subwidget->pData->selfw->pData->freeSubWidgetRenderCaches();
     }
 }
 
@@ -127,6 +183,9 @@ bool Widget::PrivateData::giveMouseEventForSubWidgets(MouseEvent& ev)
         }
     }
 
+    if (subWidgetIndex != nullptr)
+        return giveMouseEventForIndexedSubWidgets(ev, x, y);
+
     FOR_EACH_SUBWIDGET_INV(rit)
     {
         SubWidget* const widget(*rit);
@@ -163,6 +222,9 @@ bool Widget::PrivateData::giveMotionEventForSubWidgets(MotionEvent& ev)
         }
     }
 
+    if (subWidgetIndex != nullptr)
+        return giveMotionEventForIndexedSubWidgets(ev, x, y);
+
     FOR_EACH_SUBWIDGET_INV(rit)
     {
         SubWidget* const widget(*rit);
@@ -199,6 +261,9 @@ bool Widget::PrivateData::giveScrollEventForSubWidgets(ScrollEvent& ev)
         }
     }
 
+    if (subWidgetIndex != nullptr)
+        return giveScrollEventForIndexedSubWidgets(ev, x, y);
+
     FOR_EACH_SUBWIDGET_INV(rit)
     {
         SubWidget* const widget(*rit);
@@ -218,6 +283,145 @@ bool Widget::PrivateData::giveScrollEventForSubWidgets(ScrollEvent& ev)
 
 // -----------------------------------------------------------------------
 
+template<class Event>
+static inline void setEventPosForSubWidget(Event& ev, SubWidget* const widget, const double x, const double y)
+{
+    ev.pos = Point<double>(x - widget->getAbsoluteX() + widget->getMargin().getX(),
+                           y - widget->getAbsoluteY() + widget->getMargin().getY());
+}
+
+bool Widget::PrivateData::giveMouseEventForIndexedSubWidgets(MouseEvent& ev, const double x, const double y)
+{
+    SubWidgetIndex& index(*subWidgetIndex);
+
+    if (index.needsRebuild)
+        index.rebuild(subWidgets);
+
+    // the widget that accepted a button press keeps receiving events until any button is released
+    SubWidget* const grabbed = index.grabbed;
+
+    if (! ev.press)
+        index.grabbed = nullptr;
+
+    if (grabbed != nullptr && grabbed->isVisible())
+    {
+        setEventPosForSubWidget(ev, grabbed, x, y);
+
+        if (grabbed->onMouse(ev))
+            return true;
+    }
+
+    index.query(x, y);
+
+    for (std::vector<SubWidget*>::iterator it = index.candidates.begin(); it != index.candidates.end(); ++it)
+    {
+        SubWidget* const widget(*it);
+
+        if (widget == grabbed || ! widget->isVisible())
+            continue;
+
+        setEventPosForSubWidget(ev, widget, x, y);
+
+        if (widget->onMouse(ev))
+        {
+            if (ev.press)
+                index.grabbed = widget;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Widget::PrivateData::giveMotionEventForIndexedSubWidgets(MotionEvent& ev, const double x, const double y)
+{
+    SubWidgetIndex& index(*subWidgetIndex);
+
+    if (index.needsRebuild)
+        index.rebuild(subWidgets);
+
+    index.query(x, y);
+
+    // widgets the pointer just left get one last event, so they can update their hover state
+    std::vector<SubWidget*>& left(index.left);
+    left.clear();
+
+    for (std::vector<SubWidget*>::iterator it = index.hovered.begin(); it != index.hovered.end(); ++it)
+    {
+        if (std::find(index.candidates.begin(), index.candidates.end(), *it) == index.candidates.end())
+            left.push_back(*it);
+    }
+
+    // reuses the already allocated storage
+    index.hovered.assign(index.candidates.begin(), index.candidates.end());
+
+    SubWidget* const grabbed = index.grabbed;
+
+    if (grabbed != nullptr && grabbed->isVisible())
+    {
+        setEventPosForSubWidget(ev, grabbed, x, y);
+
+        if (grabbed->onMotion(ev))
+            return true;
+    }
+
+    // by index, widgets can be removed from within onMotion
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        SubWidget* const widget(left[i]);
+
+        if (widget == nullptr || widget == grabbed || ! widget->isVisible())
+            continue;
+
+        setEventPosForSubWidget(ev, widget, x, y);
+
+        if (widget->onMotion(ev))
+            return true;
+    }
+
+    for (std::vector<SubWidget*>::iterator it = index.candidates.begin(); it != index.candidates.end(); ++it)
+    {
+        SubWidget* const widget(*it);
+
+        if (widget == grabbed || ! widget->isVisible())
+            continue;
+
+        setEventPosForSubWidget(ev, widget, x, y);
+
+        if (widget->onMotion(ev))
+            return true;
+    }
+
+    return false;
+}
+
+bool Widget::PrivateData::giveScrollEventForIndexedSubWidgets(ScrollEvent& ev, const double x, const double y)
+{
+    SubWidgetIndex& index(*subWidgetIndex);
+
+    if (index.needsRebuild)
+        index.rebuild(subWidgets);
+
+    index.query(x, y);
+
+    for (std::vector<SubWidget*>::iterator it = index.candidates.begin(); it != index.candidates.end(); ++it)
+    {
+        SubWidget* const widget(*it);
+
+        if (! widget->isVisible())
+            continue;
+
+        setEventPosForSubWidget(ev, widget, x, y);
+
+        if (widget->onScroll(ev))
+            return true;
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------
+
 TopLevelWidget* Widget::PrivateData::findTopLevelWidget(Widget* const pw)
 {
     if (pw->pData->topLevelWidget != nullptr)
@@ -227,6 +431,148 @@ TopLevelWidget* Widget::PrivateData::findTopLevelWidget(Widget* const pw)
     return nullptr;
 }
 
+// -----------------------------------------------------------------------
+// SubWidgetIndex
+
+// keeps the grid small for widgets spread over a large area
+static constexpr const uint kMaxIndexGridSize = 256;
+
+SubWidgetIndex::SubWidgetIndex()
+    : needsRebuild(true),
+      widgets(),
+      areas(),
+      cellStart(),
+      cellItems(),
+      originX(0.0),
+      originY(0.0),
+      cellWidth(1.0),
+      cellHeight(1.0),
+      columns(0),
+      rows(0),
+      grabbed(nullptr),
+      hovered(),
+      left(),
+      candidates() {}
+
+void SubWidgetIndex::rebuild(const std::vector<SubWidget*>& subWidgets)
+{
+    needsRebuild = false;
+
+    widgets = subWidgets;
+    areas.resize(widgets.size());
+    cellStart.clear();
+    cellItems.clear();
+    columns = rows = 0;
+
+    if (widgets.size() == 0)
+        return;
+
+    double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0, sumWidth = 0.0, sumHeight = 0.0;
+
+    for (size_t i = 0; i < widgets.size(); ++i)
+    {
+        SubWidget* const widget(widgets[i]);
+        Area& area(areas[i]);
+
+        // same area as SubWidget::contains() in the coordinates given to giveMouseEventForSubWidgets
+        area.x1 = widget->getAbsoluteX() - widget->getMargin().getX();
+        area.y1 = widget->getAbsoluteY() - widget->getMargin().getY();
+        area.x2 = area.x1 + widget->getWidth();
+        area.y2 = area.y1 + widget->getHeight();
+
+        minX = i == 0 ? area.x1 : std::min(minX, area.x1);
+        minY = i == 0 ? area.y1 : std::min(minY, area.y1);
+        maxX = i == 0 ? area.x2 : std::max(maxX, area.x2);
+        maxY = i == 0 ? area.y2 : std::max(maxY, area.y2);
+        sumWidth += widget->getWidth();
+        sumHeight += widget->getHeight();
+    }
+
+    // cells about the size of an average widget, so that most cells only point to a few widgets
+    const double avgWidth = std::max(1.0, sumWidth / widgets.size());
+    const double avgHeight = std::max(1.0, sumHeight / widgets.size());
+
+    columns = std::min(kMaxIndexGridSize, static_cast<uint>((maxX - minX) / avgWidth) + 1);
+    rows = std::min(kMaxIndexGridSize, static_cast<uint>((maxY - minY) / avgHeight) + 1);
+    originX = minX;
+    originY = minY;
+    cellWidth = std::max(1.0, (maxX - minX) / columns);
+    cellHeight = std::max(1.0, (maxY - minY) / rows);
+
+    // first pass counts items per cell, second pass fills them in z-order
+    cellStart.assign(columns * rows + 1, 0);
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 1)
+        {
+            for (uint c = 1; c < cellStart.size(); ++c)
+                cellStart[c] += cellStart[c - 1];
+            cellItems.resize(cellStart.back());
+        }
+
+        for (size_t i = 0; i < widgets.size(); ++i)
+        {
+            const Area& area(areas[i]);
+            const uint col1 = std::min(columns - 1, static_cast<uint>((area.x1 - originX) / cellWidth));
+            const uint col2 = std::min(columns - 1, static_cast<uint>((area.x2 - originX) / cellWidth));
+            const uint row1 = std::min(rows - 1, static_cast<uint>((area.y1 - originY) / cellHeight));
+            const uint row2 = std::min(rows - 1, static_cast<uint>((area.y2 - originY) / cellHeight));
+
+            for (uint r = row1; r <= row2; ++r)
+            {
+                for (uint c = col1; c <= col2; ++c)
+                {
+                    if (pass == 0)
+                        ++cellStart[r * columns + c + 1];
+                    else
+                        cellItems[cellStart[r * columns + c]++] = static_cast<uint>(i);
+                }
+            }
+        }
+    }
+
+    // filling moved each start to the end of its cell, shift back
+    for (uint c = cellStart.size() - 1; c > 0; --c)
+        cellStart[c] = cellStart[c - 1];
+    cellStart[0] = 0;
+}
+
+void SubWidgetIndex::query(const double x, const double y)
+{
+    candidates.clear();
+
+    if (columns == 0 || rows == 0)
+        return;
+    if (x < originX || y < originY)
+        return;
+
+    const uint col = std::min(columns - 1, static_cast<uint>((x - originX) / cellWidth));
+    const uint row = std::min(rows - 1, static_cast<uint>((y - originY) / cellHeight));
+    const uint cell = row * columns + col;
+
+    for (uint i = cellStart[cell + 1]; i > cellStart[cell]; --i)
+    {
+        const uint item = cellItems[i - 1];
+        const Area& area(areas[item]);
+
+        if (x >= area.x1 && y >= area.y1 && x <= area.x2 && y <= area.y2)
+            candidates.push_back(widgets[item]);
+    }
+}
+
+void SubWidgetIndex::widgetRemoved(SubWidget* const widget)
+{
+    needsRebuild = true;
+
+    if (grabbed == widget)
+        grabbed = nullptr;
+
+    hovered.erase(std::remove(hovered.begin(), hovered.end(), widget), hovered.end());
+    std::replace(left.begin(), left.end(), widget, static_cast<SubWidget*>(nullptr));
+    candidates.erase(std::remove(candidates.begin(), candidates.end(), widget), candidates.end());
+}
+
 // -----------------------------------------------------------------------
 
 END_NAMESPACE_DGL
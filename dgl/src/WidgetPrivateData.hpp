@@ -19,10 +19,53 @@
 
 #include "../Widget.hpp"
 
-#include <list>
+#include <vector>
 
 START_NAMESPACE_DGL
 
+// --------------------------------------------------------------------------------------------------------------------
+// uniform grid of subwidget areas, used for finding the subwidgets under the pointer without visiting all of them
+
+struct SubWidgetIndex {
+    struct Area {
+        double x1, y1, x2, y2;
+    };
+
+    /** Whether a subwidget was added, removed, moved, resized or restacked since the last rebuild. */
+    bool needsRebuild;
+
+    /** Indexed subwidgets in z-order, with their areas in the parent event coordinates. */
+    std::vector<SubWidget*> widgets;
+    std::vector<Area> areas;
+
+    /** Grid cells, the items of cell N are indexes into @a widgets in the range [cellStart[N], cellStart[N+1]). */
+    std::vector<uint> cellStart;
+    std::vector<uint> cellItems;
+    double originX, originY;
+    double cellWidth, cellHeight;
+    uint columns, rows;
+
+    /** Subwidget that accepted the last button press, receives all mouse and motion events until released. */
+    SubWidget* grabbed;
+
+    /** Subwidgets under the pointer on the last motion event. */
+    std::vector<SubWidget*> hovered;
+
+    /** Subwidgets the pointer just left, reused across motion events. Removed ones are set to null. */
+    std::vector<SubWidget*> left;
+
+    /** Result of the last query, top-most first. */
+    std::vector<SubWidget*> candidates;
+
+    SubWidgetIndex();
+
+    void rebuild(const std::vector<SubWidget*>& subWidgets);
+    void query(double x, double y);
+    void widgetRemoved(SubWidget* widget);
+
+    DISTRHO_DECLARE_NON_COPYABLE(SubWidgetIndex)
+};
+
 // --------------------------------------------------------------------------------------------------------------------
 
 struct Widget::PrivateData {
@@ -34,7 +77,12 @@ struct Widget::PrivateData {
     bool needsScaling;
     bool visible;
     Size<uint> size;
-    std::list<SubWidget*> subWidgets;
+    std::vector<SubWidget*> subWidgets;
+    SubWidgetIndex* subWidgetIndex;
+
+    /** Visible subwidgets in z-order, rebuilt on the next draw after subwidget or visibility changes. */
+    std::vector<SubWidget*> drawList;
+    bool drawListNeedsUpdate;
 
     // called via TopLevelWidget
     explicit PrivateData(Widget* const s, TopLevelWidget* const tlw);
@@ -42,14 +90,33 @@ struct Widget::PrivateData {
     explicit PrivateData(Widget* const s, Widget* const pw);
     ~PrivateData();
 
+    /** Flag subwidget index for rebuild, called when a subwidget is added, removed, moved, resized or restacked. */
+    void subWidgetsChanged() noexcept
+    {
+        drawListNeedsUpdate = true;
+
+        if (subWidgetIndex != nullptr)
+            subWidgetIndex->needsRebuild = true;
+    }
+
+    const std::vector<SubWidget*>& getDrawList();
+
     void displaySubWidgets(uint width, uint height, double autoScaleFactor);
 
+    // free render caches of all subwidgets recursively, called before the window goes away
+    void freeSubWidgetRenderCaches();
+
     bool giveKeyboardEventForSubWidgets(const KeyboardEvent& ev);
     bool giveCharacterInputEventForSubWidgets(const CharacterInputEvent& ev);
     bool giveMouseEventForSubWidgets(MouseEvent& ev);
     bool giveMotionEventForSubWidgets(MotionEvent& ev);
     bool giveScrollEventForSubWidgets(ScrollEvent& ev);
 
+    // used when subWidgetIndex is set, @a x and @a y are the original event coordinates
+    bool giveMouseEventForIndexedSubWidgets(MouseEvent& ev, double x, double y);
+    bool giveMotionEventForIndexedSubWidgets(MotionEvent& ev, double x, double y);
+    bool giveScrollEventForIndexedSubWidgets(ScrollEvent& ev, double x, double y);
+
     static TopLevelWidget* findTopLevelWidget(Widget* const w);
 
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PrivateData)
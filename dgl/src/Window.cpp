@@ -15,10 +15,22 @@
  */
 
 #include "WindowPrivateData.hpp"
+#include "../Application.hpp"
+#include "../SubWidget.hpp"
 #include "../TopLevelWidget.hpp"
+#include "../../distrho/extra/String.hpp"
 
 #include "pugl.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <typeinfo>
+
+#if defined(__GNUC__) && !defined(_MSC_VER)
+# include <cxxabi.h>
+#endif
+
 START_NAMESPACE_DGL
 
 // -----------------------------------------------------------------------
@@ -426,8 +438,15 @@ void Window::repaint() noexcept
     if (pData->view == nullptr)
         return;
 
+    pData->repaintRequested();
+
     if (pData->usesScheduledRepaints)
+    {
+        pData->hasPendingFullRepaint = true;
+        pData->pendingRepaintRects.clear();
         pData->appData->needsRepaint = true;
+        return;
+    }
 
     puglPostRedisplay(pData->view);
 }
@@ -437,25 +456,16 @@ void Window::repaint(const Rectangle<uint>& rect) noexcept
     if (pData->view == nullptr)
         return;
 
-    if (pData->usesScheduledRepaints)
-        pData->appData->needsRepaint = true;
+    pData->repaintRequested();
 
-    PuglRect prect = {
-        static_cast<PuglCoord>(rect.getX()),
-        static_cast<PuglCoord>(rect.getY()),
-        static_cast<PuglSpan>(rect.getWidth()),
-        static_cast<PuglSpan>(rect.getHeight()),
-    };
-    if (pData->autoScaling)
+    if (pData->usesScheduledRepaints)
     {
-        const double autoScaleFactor = pData->autoScaleFactor;
-
-        prect.x = static_cast<PuglCoord>(prect.x * autoScaleFactor);
-        prect.y = static_cast<PuglCoord>(prect.y * autoScaleFactor);
-        prect.width = static_cast<PuglSpan>(prect.width * autoScaleFactor + 0.5);
-        prect.height = static_cast<PuglSpan>(prect.height * autoScaleFactor + 0.5);
+        pData->addPendingRepaint(rect);
+        pData->appData->needsRepaint = true;
+        return;
     }
-    puglPostRedisplayRect(pData->view, prect);
+
+    pData->postRepaint(rect);
 }
 
 void Window::renderToPicture(const char* const filename)
@@ -463,6 +473,52 @@ void Window::renderToPicture(const char* const filename)
     pData->filenameToRenderInto = strdup(filename);
 }
 
+bool Window::renderToMemory(void* const pixels, const uint stride)
+{
+    DISTRHO_SAFE_ASSERT_RETURN(pixels != nullptr, false);
+
+    return pData->renderToMemory(pixels, stride);
+}
+
+Window::DisplayTimingCallback* Window::getDisplayTimingCallback() const noexcept
+{
+    return pData->displayTimingCallback;
+}
+
+void Window::setDisplayTimingCallback(DisplayTimingCallback* const callback) noexcept
+{
+    pData->displayTimingCallback = callback;
+}
+
+Window::FrameStats Window::getFrameStats() const noexcept
+{
+    FrameStats stats = pData->frameStats;
+
+    if (stats.numFrames != 0)
+        stats.averageFrameTime = pData->totalFrameTime / stats.numFrames;
+
+    return stats;
+}
+
+void Window::resetFrameStats() noexcept
+{
+    pData->resetFrameStats();
+}
+
+bool Window::isFrameStatsOverlayVisible() const noexcept
+{
+    return pData->frameStatsOverlayVisible;
+}
+
+void Window::setFrameStatsOverlayVisible(const bool visible)
+{
+    if (pData->frameStatsOverlayVisible == visible)
+        return;
+
+    pData->frameStatsOverlayVisible = visible;
+    repaint();
+}
+
 void Window::runAsModal(bool blockWait)
 {
     pData->runAsModal(blockWait);
@@ -580,6 +636,311 @@ void Window::onFileSelected(const char*)
 }
 #endif
 
+// -----------------------------------------------------------------------
+// FrameTracer
+
+struct Window::FrameTracer::PrivateData {
+    enum EventType {
+        kEventFrame,
+        kEventWidget,
+        kEventRepaint
+    };
+
+    struct Event {
+        EventType type;
+        uint widgetIndex;
+        double time;
+        double duration;
+    };
+
+    struct WidgetInfo {
+        const char* typeName; // null until resolved
+        String name;
+        uint numRepaints;
+        uint lastSeenFrame;
+    };
+
+    Window& window;
+    Application& app;
+    const uint maxEvents;
+    uint numFramesSeen;
+    std::vector<Event> events;
+    std::vector<WidgetInfo> widgets;
+    std::map<Widget*, uint> widgetIndexes;
+
+    PrivateData(Window& w, const uint maxEvents_)
+        : window(w),
+          app(w.getApp()),
+          maxEvents(maxEvents_),
+          numFramesSeen(0),
+          events(),
+          widgets(),
+          widgetIndexes()
+    {
+        events.reserve(std::min(maxEvents, 4096u));
+    }
+
+    // widgets are only identified by address when recording, as they can request repaints while still being
+    // constructed (or destroyed), where their type is not the final one. see resolveWidget for type names
+    uint getWidgetIndex(Widget* const widget)
+    {
+        if (widget == nullptr)
+            return UINT32_MAX;
+
+        const std::map<Widget*, uint>::iterator it = widgetIndexes.find(widget);
+
+        if (it != widgetIndexes.end())
+            return it->second;
+
+        const WidgetInfo info = { nullptr, String(), 0, numFramesSeen };
+
+        const uint index = static_cast<uint>(widgets.size());
+        widgets.push_back(info);
+        widgetIndexes[widget] = index;
+        return index;
+    }
+
+    // resolve the type name of a widget known to be alive and fully constructed, being drawn or in the widget tree
+    void resolveWidget(Widget* const widget)
+    {
+        std::map<Widget*, uint>::iterator it = widgetIndexes.find(widget);
+
+        if (it == widgetIndexes.end())
+            return;
+
+        const char* const typeName = typeid(*widget).name();
+
+        // a different widget was allocated at the same address as a deleted one, give it its own entry
+        if (widgets[it->second].typeName != nullptr && widgets[it->second].typeName != typeName)
+        {
+            widgetIndexes.erase(it);
+            getWidgetIndex(widget);
+            it = widgetIndexes.find(widget);
+        }
+
+        WidgetInfo& info(widgets[it->second]);
+        info.lastSeenFrame = numFramesSeen;
+
+        if (info.typeName != nullptr)
+            return;
+
+        info.typeName = typeName;
+
+       #if defined(__GNUC__) && !defined(_MSC_VER)
+        int status = 0;
+        if (char* const demangled = abi::__cxa_demangle(typeName, nullptr, nullptr, &status))
+            info.name = String(demangled, false);
+        else
+       #endif
+            info.name = typeName;
+    }
+
+    void resolveWidgetAndChildren(Widget* const widget)
+    {
+        resolveWidget(widget);
+
+        const std::list<SubWidget*> children(widget->getChildren());
+
+        for (std::list<SubWidget*>::const_iterator it = children.begin(); it != children.end(); ++it)
+            resolveWidgetAndChildren(*it);
+    }
+
+    // called after each frame, when no widget is under construction.
+    // widgets no longer in the widget tree are forgotten, they are gone and their address can be reused
+    void resolveWidgetTree(const std::list<TopLevelWidget*>& topLevelWidgets)
+    {
+        if (widgetIndexes.empty())
+            return;
+
+        ++numFramesSeen;
+
+        for (std::list<TopLevelWidget*>::const_iterator it = topLevelWidgets.begin(); it != topLevelWidgets.end(); ++it)
+            resolveWidgetAndChildren(*it);
+
+        for (std::map<Widget*, uint>::iterator it = widgetIndexes.begin(); it != widgetIndexes.end();)
+        {
+            if (widgets[it->second].lastSeenFrame != numFramesSeen)
+                widgetIndexes.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+    void addEvent(const EventType type, Widget* const widget, const double duration)
+    {
+        if (events.size() >= maxEvents)
+            return;
+
+        const Event event = { type, getWidgetIndex(widget), app.getTime() - duration, duration };
+        events.push_back(event);
+    }
+
+    const char* getWidgetName(const uint widgetIndex) const noexcept
+    {
+        return widgetIndex < widgets.size() ? getWidgetName(widgets[widgetIndex]) : "Window";
+    }
+
+    // widgets gone before a frame was drawn never get their type resolved
+    static const char* getWidgetName(const WidgetInfo& info) noexcept
+    {
+        return info.typeName != nullptr ? info.name.buffer() : "(unknown widget)";
+    }
+
+    static bool hasMoreRepaints(const WidgetInfo* const a, const WidgetInfo* const b) noexcept
+    {
+        return a->numRepaints > b->numRepaints;
+    }
+
+    static void writeEscaped(FILE* const fp, const char* str)
+    {
+        for (; *str != '\0'; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+                std::fputc('\\', fp);
+            std::fputc(*str, fp);
+        }
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(PrivateData)
+};
+
+Window::FrameTracer::FrameTracer(Window& window, const uint maxEvents)
+    : pData(new PrivateData(window, maxEvents)) {}
+
+Window::FrameTracer::~FrameTracer()
+{
+    delete pData;
+}
+
+void Window::FrameTracer::clear() noexcept
+{
+    pData->events.clear();
+    pData->widgets.clear();
+    pData->widgetIndexes.clear();
+}
+
+uint Window::FrameTracer::getNumEvents() const noexcept
+{
+    return static_cast<uint>(pData->events.size());
+}
+
+void Window::FrameTracer::printRepaintSummary() const
+{
+    if (pData->events.empty())
+    {
+        d_stdout("FrameTracer: no events recorded");
+        return;
+    }
+
+    const double duration = pData->events.back().time - pData->events.front().time;
+    uint numFrames = 0, numWindowRepaints = 0;
+
+    for (std::vector<PrivateData::Event>::const_iterator it = pData->events.begin(); it != pData->events.end(); ++it)
+    {
+        const PrivateData::Event& event(*it);
+
+        if (event.type == PrivateData::kEventFrame)
+            ++numFrames;
+        else if (event.type == PrivateData::kEventRepaint && event.widgetIndex == UINT32_MAX)
+            ++numWindowRepaints;
+    }
+
+    std::vector<const PrivateData::WidgetInfo*> sorted;
+
+    for (std::vector<PrivateData::WidgetInfo>::const_iterator it = pData->widgets.begin();
+         it != pData->widgets.end(); ++it)
+    {
+        if (it->numRepaints != 0)
+            sorted.push_back(&*it);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), PrivateData::hasMoreRepaints);
+
+    const double rateScale = duration > 0.0 ? 1.0 / duration : 0.0;
+
+    d_stdout("FrameTracer: %u frames in %.3f seconds (%.1f fps)", numFrames, duration, numFrames * rateScale);
+
+    if (numWindowRepaints != 0)
+        d_stdout("  %6u repaints (%.1f/s) from Window", numWindowRepaints, numWindowRepaints * rateScale);
+
+    for (std::vector<const PrivateData::WidgetInfo*>::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+        const PrivateData::WidgetInfo* const info = *it;
+        d_stdout("  %6u repaints (%.1f/s) from %s",
+                 info->numRepaints, info->numRepaints * rateScale, PrivateData::getWidgetName(*info));
+    }
+}
+
+bool Window::FrameTracer::writeToFile(const char* const filename) const
+{
+    DISTRHO_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+
+    FILE* const fp = std::fopen(filename, "w");
+    DISTRHO_SAFE_ASSERT_RETURN(fp != nullptr, false);
+
+    std::fputs("{\"traceEvents\":[\n", fp);
+
+    for (std::vector<PrivateData::Event>::const_iterator it = pData->events.begin(); it != pData->events.end(); ++it)
+    {
+        const PrivateData::Event& event(*it);
+
+        if (it != pData->events.begin())
+            std::fputs(",\n", fp);
+
+        const double timestamp = event.time * 1000000.0;
+
+        switch (event.type)
+        {
+        case PrivateData::kEventFrame:
+            std::fprintf(fp, "{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                             "\"ts\":%.3f,\"dur\":%.3f}", timestamp, event.duration * 1000000.0);
+            break;
+        case PrivateData::kEventWidget:
+            std::fputs("{\"name\":\"", fp);
+            PrivateData::writeEscaped(fp, pData->getWidgetName(event.widgetIndex));
+            std::fprintf(fp, "\",\"cat\":\"widget\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                             "\"ts\":%.3f,\"dur\":%.3f}", timestamp, event.duration * 1000000.0);
+            break;
+        case PrivateData::kEventRepaint:
+            std::fputs("{\"name\":\"Repaint ", fp);
+            PrivateData::writeEscaped(fp, pData->getWidgetName(event.widgetIndex));
+            std::fprintf(fp, "\",\"cat\":\"repaint\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,"
+                             "\"ts\":%.3f}", timestamp);
+            break;
+        }
+    }
+
+    std::fputs("\n]}\n", fp);
+
+    const bool ok = std::ferror(fp) == 0;
+    return std::fclose(fp) == 0 && ok;
+}
+
+void Window::FrameTracer::widgetDisplayed(Widget* const widget, const double seconds)
+{
+    // a widget being drawn is alive and fully constructed
+    pData->getWidgetIndex(widget);
+    pData->resolveWidget(widget);
+    pData->addEvent(PrivateData::kEventWidget, widget, seconds);
+}
+
+void Window::FrameTracer::frameDisplayed(const double seconds)
+{
+    pData->addEvent(PrivateData::kEventFrame, nullptr, seconds);
+    pData->resolveWidgetTree(pData->window.pData->topLevelWidgets);
+}
+
+void Window::FrameTracer::repaintRequested(Widget* const widget)
+{
+    if (pData->events.size() >= pData->maxEvents)
+        return;
+
+    pData->addEvent(PrivateData::kEventRepaint, widget, 0.0);
+
+    if (widget != nullptr)
+        ++pData->widgets[pData->events.back().widgetIndex].numRepaints;
+}
+
 // -----------------------------------------------------------------------
 
 END_NAMESPACE_DGL
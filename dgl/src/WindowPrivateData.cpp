@@ -17,8 +17,12 @@
 #include "WindowPrivateData.hpp"
 #include "TopLevelWidgetPrivateData.hpp"
 
+#include "../Color.hpp"
+
 #include "pugl.hpp"
 
+#include <algorithm>
+
 // #define DGL_DEBUG_EVENTS
 
 #if defined(DEBUG) && defined(DGL_DEBUG_EVENTS)
@@ -128,6 +132,18 @@ Window::PrivateData::PrivateData(Application& a, Window* const s)
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      offscreenContext(nullptr),
+      displayTimingCallback(nullptr),
+      frameStats(),
+      totalFrameTime(0.0),
+      repaintCause(nullptr),
+      isDisplaying(false),
+      frameStatsOverlayVisible(false),
+      frameTimeHistoryIndex(0),
+      pendingMotion(),
+      hasPendingMotion(false),
+      pendingRepaintRects(),
+      hasPendingFullRepaint(false),
      #ifndef DGL_FILE_BROWSER_DISABLED
       fileBrowserHandle(nullptr),
      #endif
@@ -158,6 +174,18 @@ Window::PrivateData::PrivateData(Application& a, Window* const s, PrivateData* c
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      offscreenContext(nullptr),
+      displayTimingCallback(nullptr),
+      frameStats(),
+      totalFrameTime(0.0),
+      repaintCause(nullptr),
+      isDisplaying(false),
+      frameStatsOverlayVisible(false),
+      frameTimeHistoryIndex(0),
+      pendingMotion(),
+      hasPendingMotion(false),
+      pendingRepaintRects(),
+      hasPendingFullRepaint(false),
      #ifndef DGL_FILE_BROWSER_DISABLED
       fileBrowserHandle(nullptr),
      #endif
@@ -190,6 +218,18 @@ Window::PrivateData::PrivateData(Application& a, Window* const s,
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      offscreenContext(nullptr),
+      displayTimingCallback(nullptr),
+      frameStats(),
+      totalFrameTime(0.0),
+      repaintCause(nullptr),
+      isDisplaying(false),
+      frameStatsOverlayVisible(false),
+      frameTimeHistoryIndex(0),
+      pendingMotion(),
+      hasPendingMotion(false),
+      pendingRepaintRects(),
+      hasPendingFullRepaint(false),
      #ifndef DGL_FILE_BROWSER_DISABLED
       fileBrowserHandle(nullptr),
      #endif
@@ -225,6 +265,18 @@ Window::PrivateData::PrivateData(Application& a, Window* const s,
       waitingForClipboardEvents(false),
       clipboardTypeId(0),
       filenameToRenderInto(nullptr),
+      offscreenContext(nullptr),
+      displayTimingCallback(nullptr),
+      frameStats(),
+      totalFrameTime(0.0),
+      repaintCause(nullptr),
+      isDisplaying(false),
+      frameStatsOverlayVisible(false),
+      frameTimeHistoryIndex(0),
+      pendingMotion(),
+      hasPendingMotion(false),
+      pendingRepaintRects(),
+      hasPendingFullRepaint(false),
      #ifndef DGL_FILE_BROWSER_DISABLED
       fileBrowserHandle(nullptr),
      #endif
@@ -242,6 +294,15 @@ Window::PrivateData::~PrivateData()
     if (view == nullptr)
         return;
 
+   #ifndef DPF_TEST_WINDOW_CPP
+    // subwidget render caches might hold resources of this window graphics context, free them while it exists
+    FOR_EACH_TOP_LEVEL_WIDGET(it)
+    {
+        TopLevelWidget* const widget(*it);
+        widget->pData->freeRenderCaches();
+    }
+   #endif
+
     if (isEmbed)
     {
        #ifndef DGL_FILE_BROWSER_DISABLED
@@ -264,6 +325,7 @@ void Window::PrivateData::initPre(const uint width, const uint height, const boo
     appData->windows.push_back(self);
     appData->idleCallbacks.push_back(this);
     memset(graphicsContext, 0, sizeof(graphicsContext));
+    resetFrameStats();
 
     if (view == nullptr)
     {
@@ -629,13 +691,12 @@ void Window::PrivateData::onPuglExpose()
     puglOnDisplayPrepare(view);
 
 #ifndef DPF_TEST_WINDOW_CPP
-    FOR_EACH_TOP_LEVEL_WIDGET(it)
-    {
-        TopLevelWidget* const widget(*it);
+    const double startTime = appData->getTime();
+    displayTopLevelWidgets();
+    frameDisplayed(appData->getTime() - startTime);
 
-        if (widget->isVisible())
-            widget->pData->display();
-    }
+    if (frameStatsOverlayVisible)
+        drawFrameStatsOverlay();
 
     if (char* const filename = filenameToRenderInto)
     {
@@ -647,6 +708,110 @@ void Window::PrivateData::onPuglExpose()
 #endif
 }
 
+void Window::PrivateData::displayTopLevelWidgets()
+{
+#ifndef DPF_TEST_WINDOW_CPP
+    isDisplaying = true;
+
+    FOR_EACH_TOP_LEVEL_WIDGET(it)
+    {
+        TopLevelWidget* const widget(*it);
+
+        if (! widget->isVisible())
+            continue;
+
+        if (displayTimingCallback != nullptr)
+        {
+            const double startTime = appData->getTime();
+            widget->pData->display();
+            displayTimingCallback->widgetDisplayed(widget, appData->getTime() - startTime);
+        }
+        else
+        {
+            widget->pData->display();
+        }
+    }
+
+    isDisplaying = false;
+#endif
+}
+
+void Window::PrivateData::frameDisplayed(const double seconds)
+{
+    ++frameStats.numFrames;
+    frameStats.lastFrameTime = seconds;
+    totalFrameTime += seconds;
+
+    if (frameStats.maxFrameTime < seconds)
+        frameStats.maxFrameTime = seconds;
+
+    frameTimeHistory[frameTimeHistoryIndex] = seconds;
+    frameTimeHistoryIndex = (frameTimeHistoryIndex + 1) % kFrameTimeHistorySize;
+
+    if (displayTimingCallback != nullptr)
+        displayTimingCallback->frameDisplayed(seconds);
+}
+
+void Window::PrivateData::repaintRequested()
+{
+    Widget* const widget = repaintCause;
+    repaintCause = nullptr;
+
+    ++frameStats.numRepaintRequests;
+    frameStats.lastRepaintWidget = widget;
+
+    if (displayTimingCallback != nullptr)
+        displayTimingCallback->repaintRequested(widget);
+}
+
+void Window::PrivateData::resetFrameStats()
+{
+    std::memset(&frameStats, 0, sizeof(frameStats));
+    std::memset(frameTimeHistory, 0, sizeof(frameTimeHistory));
+    totalFrameTime = 0.0;
+    frameTimeHistoryIndex = 0;
+}
+
+void Window::PrivateData::drawFrameStatsOverlay()
+{
+#ifndef DPF_TEST_WINDOW_CPP
+    static constexpr const int kBarWidth = 2;
+    static constexpr const int kHeight = 60;
+    static constexpr const double kFrameBudget = 1.0 / 60.0;
+
+    const PuglRect rect = puglGetFrame(view);
+
+    if (! puglOnDisplayPrepareOverlay(view, static_cast<uint>(rect.width), static_cast<uint>(rect.height)))
+        return;
+
+    const GraphicsContext& context(getGraphicsContext());
+
+    Color(0.0f, 0.0f, 0.0f, 0.6f).setFor(context, true);
+    Rectangle<int>(0, 0, static_cast<int>(kFrameTimeHistorySize) * kBarWidth, kHeight).draw(context);
+
+    // oldest frame on the left
+    for (uint i = 0; i < kFrameTimeHistorySize; ++i)
+    {
+        const double frameTime = frameTimeHistory[(frameTimeHistoryIndex + i) % kFrameTimeHistorySize];
+        const int height = std::min(kHeight, d_roundToIntPositive(frameTime / kFrameBudget * kHeight / 2));
+
+        if (height == 0)
+            continue;
+
+        if (frameTime > kFrameBudget)
+            Color(1.0f, 0.2f, 0.2f).setFor(context);
+        else
+            Color(0.2f, 1.0f, 0.2f).setFor(context);
+
+        Rectangle<int>(static_cast<int>(i) * kBarWidth, kHeight - height, kBarWidth - 1, height).draw(context);
+    }
+
+    // frame budget
+    Color(1.0f, 1.0f, 1.0f, 0.5f).setFor(context, true);
+    Rectangle<int>(0, kHeight / 2, static_cast<int>(kFrameTimeHistorySize) * kBarWidth, 1).draw(context);
+#endif
+}
+
 void Window::PrivateData::onPuglClose()
 {
     DGL_DBG("PUGL: onClose\n");
@@ -762,6 +927,122 @@ void Window::PrivateData::onPuglMotion(const Widget::MotionEvent& ev)
 #endif
 }
 
+void Window::PrivateData::flushPendingMotion()
+{
+    if (! hasPendingMotion)
+        return;
+
+    hasPendingMotion = false;
+    onPuglMotion(pendingMotion);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool rectanglesOverlapOrTouch(const Rectangle<uint>& a, const Rectangle<uint>& b) noexcept
+{
+    return a.getX() <= b.getX() + b.getWidth() && b.getX() <= a.getX() + a.getWidth()
+        && a.getY() <= b.getY() + b.getHeight() && b.getY() <= a.getY() + a.getHeight();
+}
+
+static Rectangle<uint> rectanglesBounds(const Rectangle<uint>& a, const Rectangle<uint>& b) noexcept
+{
+    const uint x1 = std::min(a.getX(), b.getX());
+    const uint y1 = std::min(a.getY(), b.getY());
+    const uint x2 = std::max(a.getX() + a.getWidth(), b.getX() + b.getWidth());
+    const uint y2 = std::max(a.getY() + a.getHeight(), b.getY() + b.getHeight());
+
+    return Rectangle<uint>(x1, y1, x2 - x1, y2 - y1);
+}
+
+static uint64_t rectangleArea(const Rectangle<uint>& rect) noexcept
+{
+    return static_cast<uint64_t>(rect.getWidth()) * rect.getHeight();
+}
+
+void Window::PrivateData::postRepaint(const Rectangle<uint>& rect)
+{
+    PuglRect prect = {
+        static_cast<PuglCoord>(rect.getX()),
+        static_cast<PuglCoord>(rect.getY()),
+        static_cast<PuglSpan>(rect.getWidth()),
+        static_cast<PuglSpan>(rect.getHeight()),
+    };
+    if (autoScaling)
+    {
+        prect.x = static_cast<PuglCoord>(prect.x * autoScaleFactor);
+        prect.y = static_cast<PuglCoord>(prect.y * autoScaleFactor);
+        prect.width = static_cast<PuglSpan>(prect.width * autoScaleFactor + 0.5);
+        prect.height = static_cast<PuglSpan>(prect.height * autoScaleFactor + 0.5);
+    }
+    puglPostRedisplayRect(view, prect);
+}
+
+void Window::PrivateData::addPendingRepaint(const Rectangle<uint>& rect)
+{
+    if (hasPendingFullRepaint || rect.isInvalid())
+        return;
+
+    Rectangle<uint> area(rect);
+
+    // merge with overlapping or adjacent areas, the result might then reach areas that were apart before
+    for (size_t i = 0; i < pendingRepaintRects.size();)
+    {
+        if (rectanglesOverlapOrTouch(pendingRepaintRects[i], area))
+        {
+            area = rectanglesBounds(pendingRepaintRects[i], area);
+            pendingRepaintRects.erase(pendingRepaintRects.begin() + i);
+            i = 0;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if (pendingRepaintRects.size() < kMaxPendingRepaintRects)
+    {
+        pendingRepaintRects.push_back(area);
+        return;
+    }
+
+    // too many separate areas, grow the one that adds the least extra painting
+    size_t best = 0;
+    uint64_t bestGrowth = UINT64_MAX;
+
+    for (size_t i = 0; i < pendingRepaintRects.size(); ++i)
+    {
+        const uint64_t growth = rectangleArea(rectanglesBounds(pendingRepaintRects[i], area))
+                              - rectangleArea(pendingRepaintRects[i]);
+
+        if (growth < bestGrowth)
+        {
+            best = i;
+            bestGrowth = growth;
+        }
+    }
+
+    pendingRepaintRects[best] = rectanglesBounds(pendingRepaintRects[best], area);
+}
+
+void Window::PrivateData::flushPendingRepaints()
+{
+    if (view == nullptr)
+        return;
+
+    if (hasPendingFullRepaint)
+    {
+        hasPendingFullRepaint = false;
+        pendingRepaintRects.clear();
+        puglPostRedisplay(view);
+        return;
+    }
+
+    for (size_t i = 0; i < pendingRepaintRects.size(); ++i)
+        postRepaint(pendingRepaintRects[i]);
+
+    pendingRepaintRects.clear();
+}
+
 void Window::PrivateData::onPuglScroll(const Widget::ScrollEvent& ev)
 {
     DGL_DBGp("onPuglScroll : %f %f %f %f\n", ev.pos.getX(), ev.pos.getY(), ev.delta.getX(), ev.delta.getY());
@@ -895,6 +1176,10 @@ PuglStatus Window::PrivateData::puglEventCallback(PuglView* const view, const Pu
         }
     }
 
+    // a newer motion event replaces the pending one, any other event must see it first
+    if (pData->hasPendingMotion && event->type != PUGL_MOTION)
+        pData->flushPendingMotion();
+
     switch (event->type)
     {
     ///< No event
@@ -903,6 +1188,8 @@ PuglStatus Window::PrivateData::puglEventCallback(PuglView* const view, const Pu
 
     ///< View realized, a #PuglRealizeEvent
     case PUGL_REALIZE:
+        pData->appData->setRefreshRate(puglGetViewHint(view, PUGL_REFRESH_RATE));
+
         if (! pData->isEmbed && ! puglGetTransientParent(view))
         {
            #if defined(DISTRHO_OS_WINDOWS) && defined(DGL_WINDOWS_ICON_ID)
@@ -1042,7 +1329,17 @@ PuglStatus Window::PrivateData::puglEventCallback(PuglView* const view, const Pu
             ev.pos = Point<double>(event->motion.x, event->motion.y);
         }
         ev.absolutePos = ev.pos;
-        pData->onPuglMotion(ev);
+
+        // coalesce motion while processing pending events, only the last one is relevant
+        if (pData->appData->isProcessingEvents)
+        {
+            pData->pendingMotion = ev;
+            pData->hasPendingMotion = true;
+        }
+        else
+        {
+            pData->onPuglMotion(ev);
+        }
         break;
     }
 
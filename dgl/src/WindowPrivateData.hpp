@@ -90,6 +90,38 @@ struct Window::PrivateData : IdleCallback {
     /** Render to a picture file when non-null, automatically free+unset after saving. */
     char* filenameToRenderInto;
 
+    /** Graphics context to draw into instead of the native window, only set during renderToMemory. */
+    void* offscreenContext;
+
+    /** Optional callback for widget draw timings. */
+    DisplayTimingCallback* displayTimingCallback;
+
+    /** Frame statistics, average frame time is calculated on request. */
+    FrameStats frameStats;
+    double totalFrameTime;
+
+    /** Widget currently requesting a repaint, reported as the cause of the next repaint request. */
+    Widget* repaintCause;
+
+    /** Whether top-level widgets are being drawn, which means the graphics context is active. */
+    bool isDisplaying;
+
+    /** Most recent frame times, shown as a graph on top of the window when the overlay is visible. */
+    static constexpr const uint kFrameTimeHistorySize = 100;
+    bool frameStatsOverlayVisible;
+    uint frameTimeHistoryIndex;
+    double frameTimeHistory[kFrameTimeHistorySize];
+
+    /** Last motion event received during an application idle, delivered once all pending events are processed. */
+    Widget::MotionEvent pendingMotion;
+    bool hasPendingMotion;
+
+    /** Area to repaint on the next application idle, used for scheduled repaints.
+        Requests are merged into a few rectangles in window coordinates, unless the full window needs a repaint. */
+    static constexpr const uint kMaxPendingRepaintRects = 8;
+    std::vector<Rectangle<uint>> pendingRepaintRects;
+    bool hasPendingFullRepaint;
+
    #ifndef DGL_FILE_BROWSER_DISABLED
     /** Handle for file browser dialog operations. */
     DGL_NAMESPACE::FileBrowserHandle fileBrowserHandle;
@@ -174,6 +206,16 @@ struct Window::PrivateData : IdleCallback {
    #endif
 
     static void renderToPicture(const char* filename, const GraphicsContext& context, uint width, uint height);
+    bool renderToMemory(void* pixels, uint stride);
+
+    // draw all visible top-level widgets and their subwidgets
+    void displayTopLevelWidgets();
+
+    // frame statistics
+    void frameDisplayed(double seconds);
+    void repaintRequested();
+    void resetFrameStats();
+    void drawFrameStatsOverlay();
 
     // modal handling
     void startModal();
@@ -189,6 +231,14 @@ struct Window::PrivateData : IdleCallback {
     void onPuglText(const Widget::CharacterInputEvent& ev);
     void onPuglMouse(const Widget::MouseEvent& ev);
     void onPuglMotion(const Widget::MotionEvent& ev);
+
+    // deliver coalesced motion event, if any
+    void flushPendingMotion();
+
+    // repaint handling, posting the area to pugl right away or merging it for the next application idle
+    void postRepaint(const Rectangle<uint>& rect);
+    void addPendingRepaint(const Rectangle<uint>& rect);
+    void flushPendingRepaints();
     void onPuglScroll(const Widget::ScrollEvent& ev);
 
     // clipboard related handling
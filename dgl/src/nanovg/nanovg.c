@@ -163,6 +163,7 @@ struct NVGfontContext {  // Fontstash context plus font images; shared between s
 	struct FONScontext* fs;
 	int fontImages[NVG_MAX_FONTIMAGES];
 	int fontImageIdx;
+	int atlasGeneration; // changes every time glyphs are moved into a new font image
 };
 typedef struct NVGfontContext NVGfontContext;
 
@@ -184,6 +185,51 @@ struct NVGcontext {
 	int fillTriCount;
 	int strokeTriCount;
 	int textTriCount;
+	NVGrecording* recording;
+};
+
+enum NVGrecordedCallType {
+	NVG_RECORDED_FILL = 0,
+	NVG_RECORDED_STROKE = 1,
+	NVG_RECORDED_TRIANGLES = 2,
+};
+
+struct NVGrecordedCall {
+	int type;
+	NVGpaint paint;
+	NVGcompositeOperationState compositeOperation;
+	NVGscissor scissor;
+	float bounds[4];
+	float strokeWidth;
+	int firstPath;
+	int npaths;
+	int firstVert;
+	int nverts;
+};
+typedef struct NVGrecordedCall NVGrecordedCall;
+
+// path vertices are stored as offsets into the recording vertex array
+struct NVGrecordedPath {
+	NVGpath path;
+	int fillOffset;
+	int strokeOffset;
+};
+typedef struct NVGrecordedPath NVGrecordedPath;
+
+struct NVGrecording {
+	NVGrecordedCall* calls;
+	int ncalls;
+	int ccalls;
+	NVGrecordedPath* paths;
+	int npaths;
+	int cpaths;
+	NVGvertex* verts;
+	int nverts;
+	int cverts;
+	NVGpath* drawPaths;
+	int hasText;
+	int atlasGeneration; // font atlas generation the recorded text UVs refer to
+	int failed;
 };
 
 static float nvg__sqrtf(float a) { return sqrtf(a); }
@@ -355,6 +401,7 @@ NVGcontext* nvgCreateInternal(NVGparams* params, NVGcontext* other)  // Share th
 		if (ctx->fontContext == NULL) goto error;
 		for (i = 0; i < NVG_MAX_FONTIMAGES; i++)
 			ctx->fontContext->fontImages[i] = 0;
+		ctx->fontContext->atlasGeneration = 0;
 		ctx->fontContext->refCount = 1;
 	}
 
@@ -416,6 +463,7 @@ void nvgDeleteInternal(NVGcontext* ctx)
 	if (ctx == NULL) return;
 	if (ctx->commands != NULL) free(ctx->commands);
 	if (ctx->cache != NULL) nvg__deletePathCache(ctx->cache);
+	if (ctx->recording != NULL) nvgDeleteRecording(ctx->recording);
 
 	if (ctx->fontContext != NULL && --ctx->fontContext->refCount == 0) {
 		if (ctx->fontContext->fs)
@@ -917,6 +965,20 @@ int nvgCreateImageMem(NVGcontext* ctx, int imageFlags, const unsigned char* data
 	stbi_image_free(img);
 	return image;
 }
+
+unsigned char* nvgDecodeImageMem(const unsigned char* data, int ndata, int* w, int* h)
+{
+	int n;
+	// same flags as nvgCreateImage, set for the calling thread only so decoding threads do not race on them
+	stbi_set_unpremultiply_on_load_thread(1);
+	stbi_convert_iphone_png_to_rgb_thread(1);
+	return stbi_load_from_memory(data, ndata, w, h, &n, 4);
+}
+
+void nvgFreeDecodedImage(unsigned char* pixels)
+{
+	stbi_image_free(pixels);
+}
 #endif
 
 int nvgCreateImageRaw(NVGcontext* ctx, int w, int h, int imageFlags, NVGtexture format, const unsigned char* data)
@@ -2323,6 +2385,247 @@ void nvgDebugDumpPathCache(NVGcontext* ctx)
 	}
 }
 
+static int nvg__recordingReserve(void** data, int* capacity, int count, int size)
+{
+	void* newData;
+	int newCapacity;
+
+	if (count <= *capacity)
+		return 1;
+
+	newCapacity = nvg__maxi(count, *capacity * 2);
+	newData = realloc(*data, (size_t)newCapacity * size);
+	if (newData == NULL)
+		return 0;
+
+	*data = newData;
+	*capacity = newCapacity;
+	return 1;
+}
+
+static int nvg__recordVerts(NVGrecording* rec, const NVGvertex* verts, int nverts)
+{
+	int offset = rec->nverts;
+
+	if (!nvg__recordingReserve((void**)&rec->verts, &rec->cverts, rec->nverts + nverts, sizeof(NVGvertex)))
+		return -1;
+
+	if (nverts > 0)
+		memcpy(&rec->verts[offset], verts, sizeof(NVGvertex)*nverts);
+	rec->nverts += nverts;
+	return offset;
+}
+
+static void nvg__recordCall(NVGrecording* rec, int type, const NVGpaint* paint, const NVGstate* state,
+							const float* bounds, float strokeWidth,
+							const NVGpath* paths, int npaths, const NVGvertex* verts, int nverts)
+{
+	NVGrecordedCall* call;
+	int i;
+
+	if (rec->failed)
+		return;
+
+	if (!nvg__recordingReserve((void**)&rec->calls, &rec->ccalls, rec->ncalls + 1, sizeof(NVGrecordedCall)) ||
+		!nvg__recordingReserve((void**)&rec->paths, &rec->cpaths, rec->npaths + npaths, sizeof(NVGrecordedPath)))
+		goto error;
+
+	call = &rec->calls[rec->ncalls];
+	memset(call, 0, sizeof(*call));
+	call->type = type;
+	call->paint = *paint;
+	call->compositeOperation = state->compositeOperation;
+	call->scissor = state->scissor;
+	call->strokeWidth = strokeWidth;
+	call->firstPath = rec->npaths;
+	call->npaths = npaths;
+	if (bounds != NULL)
+		memcpy(call->bounds, bounds, sizeof(call->bounds));
+
+	for (i = 0; i < npaths; i++) {
+		NVGrecordedPath* rpath = &rec->paths[rec->npaths + i];
+		rpath->path = paths[i];
+		rpath->path.fill = NULL;
+		rpath->path.stroke = NULL;
+		rpath->fillOffset = nvg__recordVerts(rec, paths[i].fill, paths[i].nfill);
+		rpath->strokeOffset = nvg__recordVerts(rec, paths[i].stroke, paths[i].nstroke);
+		if (rpath->fillOffset < 0 || rpath->strokeOffset < 0)
+			goto error;
+	}
+
+	call->firstVert = nvg__recordVerts(rec, verts, nverts);
+	call->nverts = nverts;
+	if (call->firstVert < 0)
+		goto error;
+
+	rec->npaths += npaths;
+	rec->ncalls++;
+	return;
+
+error:
+	rec->failed = 1;
+}
+
+void nvgBeginRecording(NVGcontext* ctx)
+{
+	if (ctx->recording != NULL)
+		return;
+
+	ctx->recording = (NVGrecording*)malloc(sizeof(NVGrecording));
+	if (ctx->recording == NULL)
+		return;
+	memset(ctx->recording, 0, sizeof(NVGrecording));
+}
+
+NVGrecording* nvgEndRecording(NVGcontext* ctx)
+{
+	NVGrecording* rec = ctx->recording;
+
+	if (rec == NULL)
+		return NULL;
+
+	ctx->recording = NULL;
+
+	if (rec->failed) {
+		nvgDeleteRecording(rec);
+		return NULL;
+	}
+
+	// scratch paths used for drawing
+	if (rec->npaths > 0) {
+		rec->drawPaths = (NVGpath*)malloc(sizeof(NVGpath)*rec->npaths);
+		if (rec->drawPaths == NULL) {
+			nvgDeleteRecording(rec);
+			return NULL;
+		}
+	}
+
+	return rec;
+}
+
+int nvgIsRecording(NVGcontext* ctx)
+{
+	return ctx->recording != NULL;
+}
+
+int nvgIsRecordingOutdated(NVGcontext* ctx, NVGrecording* rec)
+{
+	return rec->hasText && rec->atlasGeneration != ctx->fontContext->atlasGeneration;
+}
+
+void nvgDrawRecording(NVGcontext* ctx, NVGrecording* rec)
+{
+	NVGstate* state = nvg__getState(ctx);
+	const float* t = state->xform;
+	const NVGvertex* verts;
+	int identity, i, j;
+
+	if (rec == NULL || rec->ncalls == 0 || ctx->recording != NULL)
+		return;
+
+	// recorded text would sample glyphs from an old font atlas
+	if (nvgIsRecordingOutdated(ctx, rec))
+		return;
+
+	identity = t[0] == 1.0f && t[1] == 0.0f && t[2] == 0.0f && t[3] == 1.0f && t[4] == 0.0f && t[5] == 0.0f;
+
+	// recorded vertices are used as-is when there is no transform
+	if (identity) {
+		verts = rec->verts;
+	} else {
+		NVGvertex* dst = nvg__allocTempVerts(ctx, rec->nverts);
+		if (dst == NULL)
+			return;
+		for (i = 0; i < rec->nverts; i++) {
+			const NVGvertex* src = &rec->verts[i];
+			dst[i].x = src->x*t[0] + src->y*t[2] + t[4];
+			dst[i].y = src->x*t[1] + src->y*t[3] + t[5];
+			dst[i].u = src->u;
+			dst[i].v = src->v;
+		}
+		verts = dst;
+	}
+
+	for (i = 0; i < rec->ncalls; i++) {
+		const NVGrecordedCall* call = &rec->calls[i];
+		NVGpaint paint = call->paint;
+		NVGscissor scissor = call->scissor;
+		NVGpath* paths = rec->drawPaths + call->firstPath;
+
+		for (j = 0; j < 4; j++) {
+			paint.innerColor.rgba[j] *= state->tint.rgba[j];
+			paint.outerColor.rgba[j] *= state->tint.rgba[j];
+		}
+
+		if (scissor.extent[0] < -0.5f) {
+			scissor = state->scissor;
+		} else if (!identity) {
+			nvgTransformMultiply(scissor.xform, t);
+		}
+
+		if (!identity)
+			nvgTransformMultiply(paint.xform, t);
+
+		for (j = 0; j < call->npaths; j++) {
+			const NVGrecordedPath* rpath = &rec->paths[call->firstPath + j];
+			paths[j] = rpath->path;
+			paths[j].fill = rpath->path.nfill > 0 ? (NVGvertex*)&verts[rpath->fillOffset] : NULL;
+			paths[j].stroke = rpath->path.nstroke > 0 ? (NVGvertex*)&verts[rpath->strokeOffset] : NULL;
+		}
+
+		switch (call->type) {
+		case NVG_RECORDED_FILL: {
+			float bounds[4];
+			if (identity) {
+				memcpy(bounds, call->bounds, sizeof(bounds));
+			} else {
+				float x[4], y[4];
+				nvgTransformPoint(&x[0], &y[0], t, call->bounds[0], call->bounds[1]);
+				nvgTransformPoint(&x[1], &y[1], t, call->bounds[2], call->bounds[1]);
+				nvgTransformPoint(&x[2], &y[2], t, call->bounds[2], call->bounds[3]);
+				nvgTransformPoint(&x[3], &y[3], t, call->bounds[0], call->bounds[3]);
+				bounds[0] = nvg__minf(nvg__minf(x[0], x[1]), nvg__minf(x[2], x[3]));
+				bounds[1] = nvg__minf(nvg__minf(y[0], y[1]), nvg__minf(y[2], y[3]));
+				bounds[2] = nvg__maxf(nvg__maxf(x[0], x[1]), nvg__maxf(x[2], x[3]));
+				bounds[3] = nvg__maxf(nvg__maxf(y[0], y[1]), nvg__maxf(y[2], y[3]));
+			}
+			ctx->params.renderFill(ctx->params.userPtr, &paint, call->compositeOperation, &scissor, ctx->fringeWidth,
+								   bounds, paths, call->npaths);
+			for (j = 0; j < call->npaths; j++) {
+				ctx->fillTriCount += paths[j].nfill-2;
+				ctx->fillTriCount += paths[j].nstroke-2;
+				ctx->drawCallCount += 2;
+			}
+			break;
+		}
+		case NVG_RECORDED_STROKE:
+			ctx->params.renderStroke(ctx->params.userPtr, &paint, call->compositeOperation, &scissor, ctx->fringeWidth,
+									 call->strokeWidth, paths, call->npaths);
+			for (j = 0; j < call->npaths; j++) {
+				ctx->strokeTriCount += paths[j].nstroke-2;
+				ctx->drawCallCount++;
+			}
+			break;
+		case NVG_RECORDED_TRIANGLES:
+			ctx->params.renderTriangles(ctx->params.userPtr, &paint, call->compositeOperation, &scissor,
+										&verts[call->firstVert], call->nverts, ctx->fringeWidth);
+			ctx->textTriCount += call->nverts/3;
+			ctx->drawCallCount++;
+			break;
+		}
+	}
+}
+
+void nvgDeleteRecording(NVGrecording* rec)
+{
+	if (rec == NULL) return;
+	free(rec->calls);
+	free(rec->paths);
+	free(rec->verts);
+	free(rec->drawPaths);
+	free(rec);
+}
+
 void nvgFill(NVGcontext* ctx)
 {
 	NVGstate* state = nvg__getState(ctx);
@@ -2342,6 +2645,12 @@ void nvgFill(NVGcontext* ctx)
 		fillPaint.outerColor.rgba[i] *= state->tint.rgba[i];
 	}
 
+	if (ctx->recording != NULL) {
+		nvg__recordCall(ctx->recording, NVG_RECORDED_FILL, &fillPaint, state, ctx->cache->bounds, 0.0f,
+						ctx->cache->paths, ctx->cache->npaths, NULL, 0);
+		return;
+	}
+
 	ctx->params.renderFill(ctx->params.userPtr, &fillPaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
 						   ctx->cache->bounds, ctx->cache->paths, ctx->cache->npaths);
 
@@ -2386,6 +2695,12 @@ void nvgStroke(NVGcontext* ctx)
 	else
 		nvg__expandStroke(ctx, strokeWidth*0.5f, 0.0f, state->lineCap, state->lineJoin, state->miterLimit);
 
+	if (ctx->recording != NULL) {
+		nvg__recordCall(ctx->recording, NVG_RECORDED_STROKE, &strokePaint, state, NULL, strokeWidth,
+						ctx->cache->paths, ctx->cache->npaths, NULL, 0);
+		return;
+	}
+
 	ctx->params.renderStroke(ctx->params.userPtr, &strokePaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
 							 strokeWidth, ctx->cache->paths, ctx->cache->npaths);
 
@@ -2540,6 +2855,7 @@ static int nvg__allocTextAtlas(NVGcontext* ctx)
 			                                  NVG_TEXTURE_ALPHA, iw, ih, NVG_FONT_TEXTURE_FLAGS, NULL);
 	}
 	++ctx->fontContext->fontImageIdx;
+	++ctx->fontContext->atlasGeneration;
 	fonsResetAtlas(ctx->fontContext->fs, iw, ih);
 	return 1;
 }
@@ -2559,6 +2875,17 @@ static void nvg__renderText(NVGcontext* ctx, NVGvertex* verts, int nverts)
 		paint.outerColor.rgba[i] *= state->tint.rgba[i];
 	}
 
+	if (ctx->recording != NULL) {
+		NVGrecording* rec = ctx->recording;
+		// text recorded before the atlas was reset refers to glyphs that are gone, record again next time
+		if (rec->hasText && rec->atlasGeneration != ctx->fontContext->atlasGeneration)
+			rec->failed = 1;
+		rec->hasText = 1;
+		rec->atlasGeneration = ctx->fontContext->atlasGeneration;
+		nvg__recordCall(rec, NVG_RECORDED_TRIANGLES, &paint, state, NULL, 0.0f, NULL, 0, verts, nverts);
+		return;
+	}
+
 	ctx->params.renderTriangles(ctx->params.userPtr, &paint, state->compositeOperation, &state->scissor, verts, nverts, ctx->fringeWidth);
 
 	ctx->drawCallCount++;
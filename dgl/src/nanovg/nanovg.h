@@ -387,6 +387,14 @@ int nvgCreateImage(NVGcontext* ctx, const char* filename, int imageFlags);
 // Returns handle to the image.
 int nvgCreateImageMem(NVGcontext* ctx, int imageFlags, const unsigned char* data, int ndata);
 
+// Decodes image from the specified chunk of memory into 32bit RGBA pixels, without creating a texture.
+// Does not use the context and can be called from any thread.
+// Returns pixel data to be freed with nvgFreeDecodedImage(), or NULL on failure.
+unsigned char* nvgDecodeImageMem(const unsigned char* data, int ndata, int* w, int* h);
+
+// Frees pixel data returned by nvgDecodeImageMem().
+void nvgFreeDecodedImage(unsigned char* pixels);
+
 // Creates image from specified image data and texture format.
 // Returns handle to the image.
 int nvgCreateImageRaw(NVGcontext* ctx, int w, int h, int imageFlags, enum NVGtexture format, const unsigned char* data);
@@ -525,6 +533,43 @@ void nvgFill(NVGcontext* ctx);
 void nvgStroke(NVGcontext* ctx);
 
 
+//
+// Recordings
+//
+// Recordings store fills, strokes and text after they have been flattened and tessellated,
+// so that static content can be drawn again later without redoing that work.
+//
+// Drawing calls made between nvgBeginRecording() and nvgEndRecording() are captured but not rendered.
+// A recording is drawn with nvgDrawRecording(), using the current transform and global tint (alpha);
+// the current scissor applies to recorded content that had no scissor of its own.
+// Because geometry and anti-aliasing fringes are already tessellated, recordings are best
+// drawn with the same scale they were recorded with, translation and alpha changes are free.
+// Images and fonts used while recording must stay valid for as long as the recording is drawn.
+// Recorded text refers to the current font atlas, once the atlas grows or resets the recording is outdated
+// and must be recorded again; outdated recordings are not drawn.
+
+typedef struct NVGrecording NVGrecording;
+
+// Begins capturing drawing calls into a new recording.
+void nvgBeginRecording(NVGcontext* ctx);
+
+// Ends capturing drawing calls, returns the new recording or NULL on failure.
+// The returned recording is not tied to the context and must be deleted with nvgDeleteRecording().
+NVGrecording* nvgEndRecording(NVGcontext* ctx);
+
+// Returns 1 if drawing calls are currently being captured.
+int nvgIsRecording(NVGcontext* ctx);
+
+// Returns 1 if the recording contains text from a font atlas that has since been replaced.
+int nvgIsRecordingOutdated(NVGcontext* ctx, NVGrecording* rec);
+
+// Draws a recording using the current transform and global tint, does nothing if the recording is outdated.
+void nvgDrawRecording(NVGcontext* ctx, NVGrecording* rec);
+
+// Deletes a recording.
+void nvgDeleteRecording(NVGrecording* rec);
+
+
 //
 // Text
 //
@@ -439,6 +439,29 @@ void puglOnDisplayPrepare(PuglView*)
   #endif
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// DGL specific, build-specific overlay drawing prepare
+
+bool puglOnDisplayPrepareOverlay(PuglView*, const uint width, const uint height)
+{
+  #if defined(DGL_CAIRO)
+    return true;
+    // unused
+    (void)width;
+    (void)height;
+  #elif defined(DGL_OPENGL) && ! defined(DGL_USE_OPENGL3)
+    // subwidgets may leave a partial viewport behind
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+    return true;
+  #else
+    return false;
+    // unused
+    (void)width;
+    (void)height;
+  #endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // DGL specific, build-specific fallback resize
 
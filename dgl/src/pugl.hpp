@@ -84,6 +84,9 @@ PuglStatus puglSetSizeAndDefault(PuglView* view, uint width, uint height);
 // DGL specific, build-specific drawing prepare
 void puglOnDisplayPrepare(PuglView* view);
 
+// DGL specific, build-specific overlay drawing prepare, returns false if not supported
+bool puglOnDisplayPrepareOverlay(PuglView* view, uint width, uint height);
+
 // DGL specific, build-specific fallback resize
 void puglFallbackOnResize(PuglView* view, uint width, uint height);
 
@@ -512,12 +512,32 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_HAS_UI 1
 
+/**
+   Process audio in blocks of a fixed amount of frames, regardless of what the host uses.@n
+   When set to a non-zero value, Plugin::run() always receives exactly this many frames.
+   Audio and MIDI are rebuffered by DPF, which adds a latency of the same amount of frames.@n
+   This latency is added to the one set by the plugin and reported to the host automatically,
+   @ref DISTRHO_PLUGIN_WANT_LATENCY is enabled when this is set.@n
+   Parameter changes take effect at the start of the next block.
+   @see Plugin::setLatency(uint32_t)
+ */
+#define DISTRHO_PLUGIN_FIXED_BLOCK_SIZE 256
+
 /**
    Whether the plugin processing is realtime-safe.@n
    TODO - list rtsafe requirements
  */
 #define DISTRHO_PLUGIN_IS_RT_SAFE 1
 
+/**
+   Whether the plugin can process audio in-place, that is, with input and output buffers pointing to the same memory.@n
+   This is the default, and how most hosts call plugins.@n
+   When disabled, hosts are told to use separate buffers where the plugin format allows it,
+   and DPF copies the inputs into preallocated buffers whenever a host still passes overlapping ones,
+   so Plugin::run() never sees an input that aliases an output.
+ */
+#define DISTRHO_PLUGIN_SUPPORTS_IN_PLACE 1
+
 /**
    Whether the plugin is a synth.@n
    @ref DISTRHO_PLUGIN_WANT_MIDI_INPUT is automatically enabled when this is too.
@@ -597,6 +617,13 @@ START_NAMESPACE_DISTRHO
  */
 #define DISTRHO_PLUGIN_WANT_FULL_STATE 1
 
+/**
+   Whether the plugin wants to run independent tasks in parallel during processing.@n
+   Tasks use the host thread pool when available (CLAP only), otherwise a DPF-owned pool of worker threads shared by all plugin instances.
+   @see Plugin::runTasks(uint32_t)
+ */
+#define DISTRHO_PLUGIN_WANT_THREAD_POOL 1
+
 /**
    Whether the plugin wants time position information from the host.
    @see Plugin::getTimePosition()
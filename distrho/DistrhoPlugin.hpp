@@ -78,7 +78,8 @@ public:
       Get the current buffer size that will probably be used during processing, in frames.@n
       This value will remain constant between activate and deactivate.
       @note This value is only a hint!@n
-            Hosts might call run() with a higher or lower number of frames.
+            Hosts might call run() with a higher or lower number of frames.@n
+            When @ref DISTRHO_PLUGIN_FIXED_BLOCK_SIZE is set, this always returns that value.
       @see bufferSizeChanged(uint32_t)
     */
     uint32_t getBufferSize() const noexcept;
@@ -129,7 +130,8 @@ public:
 #if DISTRHO_PLUGIN_WANT_LATENCY
    /**
       Change the plugin audio output latency to @a frames.@n
-      This function should only be called in the constructor, activate() and run().
+      This function should only be called in the constructor, activate() and run().@n
+      The latency added by @ref DISTRHO_PLUGIN_FIXED_BLOCK_SIZE is not included here, DPF reports it on top of this value.
       @note This function is only available if DISTRHO_PLUGIN_WANT_LATENCY is enabled.
     */
     void setLatency(uint32_t frames) noexcept;
@@ -162,6 +164,17 @@ public:
     bool requestParameterValueChange(uint32_t index, float value) noexcept;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+   /**
+      Run @a count independent tasks in parallel, calling runTask(uint32_t) once for each task index.@n
+      The tasks run on the host thread pool when available, otherwise on a pool of DPF-owned worker threads shared by all plugin instances.@n
+      This function blocks until all tasks are done, the calling thread takes part in the processing too.@n
+      This function must only be called during run().
+      @note This function is only available if DISTRHO_PLUGIN_WANT_THREAD_POOL is enabled.
+    */
+    void runTasks(uint32_t count) noexcept;
+#endif
+
 #if DISTRHO_PLUGIN_WANT_STATE
    /**
       Set state value and notify the host about the change.@n
@@ -343,6 +356,8 @@ protected:
    /**
       Run/process function for plugins with MIDI input.
       @note Some parameters might be null if there are no audio inputs/outputs or MIDI events.
+      @note Input and output buffers might point to the same memory,
+            unless @ref DISTRHO_PLUGIN_SUPPORTS_IN_PLACE is disabled.
     */
     virtual void run(const float** inputs, float** outputs, uint32_t frames,
                      const MidiEvent* midiEvents, uint32_t midiEventCount) = 0;
@@ -350,10 +365,21 @@ protected:
    /**
       Run/process function for plugins without MIDI input.
       @note Some parameters might be null if there are no audio inputs or outputs.
+      @note Input and output buffers might point to the same memory,
+            unless @ref DISTRHO_PLUGIN_SUPPORTS_IN_PLACE is disabled.
     */
     virtual void run(const float** inputs, float** outputs, uint32_t frames) = 0;
 #endif
 
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+   /**
+      Run a single task, as requested by runTasks(uint32_t).@n
+      This function is called concurrently from multiple threads, once for each task index.@n
+      Must be implemented by your plugin class only if DISTRHO_PLUGIN_WANT_THREAD_POOL is enabled.
+    */
+    virtual void runTask(uint32_t taskIndex) = 0;
+#endif
+
    /* --------------------------------------------------------------------------------------------------------
     * Callbacks (optional) */
 
@@ -1,6 +1,6 @@
 /*
  * DISTRHO Plugin Framework (DPF)
- * Copyright (C) 2012-2021 Filipe Coelho <falktx@falktx.com>
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
  *
  * Permission to use, copy, modify, and/or distribute this software for any purpose with
  * or without fee is hereby granted, provided that the above copyright notice and this
@@ -101,6 +101,8 @@ const char* getResourcePath(const char* bundlePath) noexcept;
     1. MidiEvent::frame retains its original value, but it is useless, do not use it.
     2. The class variable names are the same as the default ones in the run function.
        Keep that in mind and try to avoid typos. :)
+
+   @deprecated Use SubBlockSplitter instead, which also advances input buffers and can split on parameter events.
  */
 struct AudioMidiSyncHelper
 {
@@ -208,6 +210,631 @@ private:
 };
 #endif
 
+/**
+   Parameter change at a specific frame within a run() buffer, for use with SubBlockSplitter.@n
+   DPF itself does not provide these, they are meant to be filled by the plugin from its own sources
+   (such as smoothed automation or queued %UI changes).
+ */
+struct ParameterEvent {
+   /**
+      Frame offset within the run() buffer, events must be sorted by frame.
+    */
+    uint32_t frame;
+
+   /**
+      Parameter index.
+    */
+    uint32_t index;
+
+   /**
+      Parameter value.
+    */
+    float value;
+};
+
+/**
+   Iterator-style helper that splits a run() buffer into sub-blocks.
+
+   A new sub-block starts at every MIDI or parameter event, and optionally at every multiple of a maximum size,
+   so that plugins can process events at their exact frame and keep a stable control rate.@n
+   Both input and output buffers are advanced to the start of each sub-block.
+   @code
+    void run(const float** inputs, float** outputs, uint32_t frames,
+             const MidiEvent* midiEvents, uint32_t midiEventCount) override
+    {
+        SubBlockSplitter<> splitter(inputs, outputs, frames, 32);
+        splitter.setMidiEvents(midiEvents, midiEventCount);
+
+        while (splitter.next())
+        {
+            for (uint32_t i=0; i<splitter.midiEventCount; ++i)
+            {
+                const MidiEvent& ev(splitter.midiEvents[i]);
+                // ... do something with the midi event
+            }
+
+            updateControlRate();
+            renderSynth(splitter.inputs, splitter.outputs, splitter.frames);
+        }
+    }
+   @endcode
+
+   All events of a sub-block happen at its first frame, which is at @a offset frames from the start of the run() buffer,
+   so their relative frame is always 0 (or @a offset when comparing with MidiEvent::frame or ParameterEvent::frame).@n
+   Events placed before the current position (unsorted) are reported in the next sub-block.
+   Events placed at or after the end of the buffer are ignored.
+
+   The amount of channels is a template argument (matching the plugin by default),
+   so that pointer updates compile to fixed loops without any branching on channel counts.
+ */
+template<uint32_t numInputs = DISTRHO_PLUGIN_NUM_INPUTS, uint32_t numOutputs = DISTRHO_PLUGIN_NUM_OUTPUTS>
+class SubBlockSplitter
+{
+public:
+    /** Input buffers, adjusted to the start of the current sub-block */
+    const float* inputs[numInputs != 0 ? numInputs : 1];
+
+    /** Output buffers, adjusted to the start of the current sub-block */
+    float* outputs[numOutputs != 0 ? numOutputs : 1];
+
+    /** Position of the current sub-block within the run() buffer */
+    uint32_t offset;
+
+    /** Size of the current sub-block */
+    uint32_t frames;
+
+    /** MIDI events starting at the current sub-block */
+    const MidiEvent* midiEvents;
+    uint32_t midiEventCount;
+
+    /** Parameter events starting at the current sub-block */
+    const ParameterEvent* parameterEvents;
+    uint32_t parameterEventCount;
+
+   /**
+      Constructor, using values from the run function.
+      A non-zero @a maxFrames limits the size of the sub-blocks,
+      which are then also split at every multiple of @a maxFrames counting from the start of the buffer.
+    */
+    SubBlockSplitter(const float** const in, float** const out, const uint32_t totalFrames,
+                     const uint32_t maxFrames = 0) noexcept
+        : inputs(),
+          outputs(),
+          offset(0),
+          frames(0),
+          midiEvents(nullptr),
+          midiEventCount(0),
+          parameterEvents(nullptr),
+          parameterEventCount(0),
+          fInputs(in),
+          fOutputs(out),
+          fTotalFrames(totalFrames),
+          fMaxFrames(maxFrames),
+          fNextOffset(0),
+          fMidiEvents(nullptr),
+          fMidiEventCount(0),
+          fMidiEventIndex(0),
+          fParameterEvents(nullptr),
+          fParameterEventCount(0),
+          fParameterEventIndex(0) {}
+
+   /**
+      Set the MIDI events to split on, typically the ones from the run function.
+      Must be called before the first call to next().
+    */
+    void setMidiEvents(const MidiEvent* const events, const uint32_t count) noexcept
+    {
+        fMidiEvents = events;
+        fMidiEventCount = events != nullptr ? count : 0;
+    }
+
+   /**
+      Set the parameter events to split on, sorted by frame.
+      Must be called before the first call to next().
+    */
+    void setParameterEvents(const ParameterEvent* const events, const uint32_t count) noexcept
+    {
+        fParameterEvents = events;
+        fParameterEventCount = events != nullptr ? count : 0;
+    }
+
+   /**
+      Move to the next sub-block.
+      You must not read any more values from this class after this function returns false.
+    */
+    bool next() noexcept
+    {
+        if (fNextOffset >= fTotalFrames)
+            return false;
+
+        offset = fNextOffset;
+
+        uint32_t end = fTotalFrames;
+
+        if (fMaxFrames != 0)
+            end = std::min(end, (offset / fMaxFrames + 1) * fMaxFrames);
+
+        midiEvents = fMidiEvents + fMidiEventIndex;
+        midiEventCount = 0;
+
+        for (; fMidiEventIndex < fMidiEventCount && fMidiEvents[fMidiEventIndex].frame <= offset; ++fMidiEventIndex)
+            ++midiEventCount;
+
+        if (fMidiEventIndex < fMidiEventCount)
+            end = std::min(end, fMidiEvents[fMidiEventIndex].frame);
+
+        parameterEvents = fParameterEvents + fParameterEventIndex;
+        parameterEventCount = 0;
+
+        for (; fParameterEventIndex < fParameterEventCount && fParameterEvents[fParameterEventIndex].frame <= offset;
+             ++fParameterEventIndex)
+            ++parameterEventCount;
+
+        if (fParameterEventIndex < fParameterEventCount)
+            end = std::min(end, fParameterEvents[fParameterEventIndex].frame);
+
+        for (uint32_t i=0; i<numInputs; ++i)
+            inputs[i] = fInputs[i] + offset;
+
+        for (uint32_t i=0; i<numOutputs; ++i)
+            outputs[i] = fOutputs[i] + offset;
+
+        frames = end - offset;
+        fNextOffset = end;
+        return true;
+    }
+
+private:
+    /** @internal */
+    const float** const fInputs;
+    float** const fOutputs;
+    const uint32_t fTotalFrames;
+    const uint32_t fMaxFrames;
+    uint32_t fNextOffset;
+
+    const MidiEvent* fMidiEvents;
+    uint32_t fMidiEventCount;
+    uint32_t fMidiEventIndex;
+
+    const ParameterEvent* fParameterEvents;
+    uint32_t fParameterEventCount;
+    uint32_t fParameterEventIndex;
+
+    DISTRHO_DECLARE_NON_COPYABLE(SubBlockSplitter)
+};
+
+/**
+   Transport state with Bar-Beat-Tick calculations done in a single place.
+
+   All plugin formats feed their host transport information into this class and then fill the TimePosition
+   given to the plugin by calling updateTimePosition(), so that every format reports identical values.@n
+   The musical position is stored as a single count of beats since the start of the song,
+   from which bar, beat, tick and bar start tick are derived whenever the position changes.@n
+   advance() moves the position forward by a number of frames without any host information,
+   for formats that only send transport changes.
+
+   The same class can be used by plugins for tempo sync, by creating one from the current time position:
+   @code
+    void run(const float** inputs, float** outputs, uint32_t frames) override
+    {
+        const TransportEngine transport(getTimePosition(), getSampleRate());
+
+        if (transport.isValid())
+        {
+            for (double f = transport.getFramesUntilNextBeat(); f < frames; f += transport.getFramesPerBeat())
+            {
+                // ... trigger something at frame offset f
+            }
+        }
+    }
+   @endcode
+
+   All query functions are O(1), values are precomputed when the position, tempo or time signature changes.@n
+   Positions in "beats" use the time signature beat type as unit, while "quarter notes" match PPQ values from hosts.@n
+   Positions before the start of the song are reported with bar numbers of 0 or less, bar 0 being the one right before bar 1.
+ */
+class TransportEngine
+{
+public:
+   /**
+      Constructor for an empty transport, not playing and without valid BBT information.
+    */
+    TransportEngine() noexcept
+        : fPlaying(false),
+          fFrame(0),
+          fValid(false),
+          fSampleRate(0.0),
+          fBeatsPerMinute(120.0),
+          fBeatsPerBar(4.f),
+          fBeatType(4.f),
+          fTicksPerBeat(1920.0),
+          fBeats(0.0),
+          fBarStartTickOffset(0.0),
+          fBeatsPerFrame(0.0),
+          fFramesPerBeat(0.0),
+          fBarIndex(0),
+          fBeatInBar(0.0),
+          fFramesUntilNextBeat(0.0),
+          fFramesUntilNextBar(0.0),
+          fFramesUntilNextTick(0.0) {}
+
+   /**
+      Constructor using an existing time position, typically the one from Plugin::getTimePosition().
+    */
+    TransportEngine(const TimePosition& timePosition, const double sampleRate) noexcept
+        : fPlaying(false),
+          fFrame(0),
+          fValid(false),
+          fSampleRate(0.0),
+          fBeatsPerMinute(120.0),
+          fBeatsPerBar(4.f),
+          fBeatType(4.f),
+          fTicksPerBeat(1920.0),
+          fBeats(0.0),
+          fBarStartTickOffset(0.0),
+          fBeatsPerFrame(0.0),
+          fFramesPerBeat(0.0),
+          fBarIndex(0),
+          fBeatInBar(0.0),
+          fFramesUntilNextBeat(0.0),
+          fFramesUntilNextBar(0.0),
+          fFramesUntilNextTick(0.0)
+    {
+        setSampleRate(sampleRate);
+        setFromTimePosition(timePosition);
+    }
+
+   /* --------------------------------------------------------------------------------------------------------
+    * Setters */
+
+   /**
+      Reset to an empty transport, not playing and without valid BBT information.
+      The sample rate is kept as-is.
+    */
+    void reset() noexcept
+    {
+        fPlaying = false;
+        fFrame = 0;
+        fValid = false;
+        fBeatsPerMinute = 120.0;
+        fBeatsPerBar = 4.f;
+        fBeatType = 4.f;
+        fTicksPerBeat = 1920.0;
+        fBeats = 0.0;
+        fBarStartTickOffset = 0.0;
+        updateTempo();
+    }
+
+   /**
+      Set the sample rate, needed for converting between frames and beats.
+    */
+    void setSampleRate(const double sampleRate) noexcept
+    {
+        if (d_isEqual(fSampleRate, sampleRate))
+            return;
+
+        fSampleRate = sampleRate;
+        updateTempo();
+    }
+
+   /**
+      Set the transport playing state.
+    */
+    void setPlaying(const bool playing) noexcept
+    {
+        fPlaying = playing;
+    }
+
+   /**
+      Set the transport position in frames.
+    */
+    void setFrame(const uint64_t frame) noexcept
+    {
+        fFrame = frame;
+    }
+
+   /**
+      Set the tempo in beats per minute.
+      Invalid values are ignored.
+    */
+    void setTempo(const double beatsPerMinute) noexcept
+    {
+        if (beatsPerMinute <= 0.0 || d_isEqual(fBeatsPerMinute, beatsPerMinute))
+            return;
+
+        fBeatsPerMinute = beatsPerMinute;
+        updateTempo();
+    }
+
+   /**
+      Set the time signature.
+      This must be called before setting a position in quarter notes or bars.
+      Invalid values are ignored.
+    */
+    void setTimeSignature(const float beatsPerBar, const float beatType) noexcept
+    {
+        // hosts can send bogus values on every block, so do not assert here
+        if (! (beatsPerBar > 0.f && beatType > 0.f))
+            return;
+
+        fBeatsPerBar = beatsPerBar;
+        fBeatType = beatType;
+        updatePosition();
+    }
+
+   /**
+      Set the number of ticks within a beat.
+      Invalid values are ignored.
+    */
+    void setTicksPerBeat(const double ticksPerBeat) noexcept
+    {
+        if (ticksPerBeat <= 0.0)
+            return;
+
+        fTicksPerBeat = ticksPerBeat;
+        updatePosition();
+    }
+
+   /**
+      Set the musical position as beats since the start of the song, marking the BBT information as valid.
+      Any bar start tick previously set by the host is discarded.
+    */
+    void setPositionInBeats(const double beats) noexcept
+    {
+        fValid = true;
+        fBeats = beats;
+        fBarStartTickOffset = 0.0;
+        updatePosition();
+    }
+
+   /**
+      Set the musical position as quarter notes since the start of the song (PPQ),
+      marking the BBT information as valid.
+    */
+    void setPositionInQuarterNotes(const double quarterNotes) noexcept
+    {
+        setPositionInBeats(quarterNotes * fBeatType / 4.0);
+    }
+
+   /**
+      Set the musical position as a bar index (starting from 0) plus beats within that bar,
+      marking the BBT information as valid.
+    */
+    void setPositionInBar(const int32_t barIndex, const double beatInBar) noexcept
+    {
+        setPositionInBeats(static_cast<double>(barIndex) * fBeatsPerBar + beatInBar);
+    }
+
+   /**
+      Set the number of ticks before the start of the current bar, as reported by the host.
+      Hosts that change time signature during a song know better than the bar index times a fixed bar length.
+      This must be called after setting the position, and is kept as an offset while the transport advances.
+    */
+    void setBarStartTick(const double barStartTick) noexcept
+    {
+        fBarStartTickOffset = barStartTick - fTicksPerBeat * fBeatsPerBar * fBarIndex;
+    }
+
+   /**
+      Mark the BBT information as invalid, resetting the musical position back to the start of the song.
+    */
+    void setPositionInvalid() noexcept
+    {
+        fValid = false;
+        fBeats = 0.0;
+        fBarStartTickOffset = 0.0;
+        updatePosition();
+    }
+
+   /**
+      Set everything from an existing time position.
+    */
+    void setFromTimePosition(const TimePosition& timePosition) noexcept
+    {
+        fPlaying = timePosition.playing;
+        fFrame = timePosition.frame;
+
+        if (! timePosition.bbt.valid)
+            return setPositionInvalid();
+
+        if (timePosition.bbt.beatsPerBar > 0.f && timePosition.bbt.beatType > 0.f)
+        {
+            fBeatsPerBar = timePosition.bbt.beatsPerBar;
+            fBeatType = timePosition.bbt.beatType;
+        }
+
+        if (timePosition.bbt.ticksPerBeat > 0.0)
+            fTicksPerBeat = timePosition.bbt.ticksPerBeat;
+
+        setTempo(timePosition.bbt.beatsPerMinute);
+        setPositionInBar(timePosition.bbt.bar - 1,
+                         timePosition.bbt.beat - 1 + timePosition.bbt.tick / fTicksPerBeat);
+        setBarStartTick(timePosition.bbt.barStartTick);
+    }
+
+   /**
+      Move the transport forwards (or backwards, if negative) by a number of frames,
+      using the current tempo.
+    */
+    void advance(const int64_t frames) noexcept
+    {
+        if (frames < 0 && static_cast<uint64_t>(-frames) > fFrame)
+            fFrame = 0;
+        else
+            fFrame += frames;
+
+        if (fValid)
+        {
+            fBeats += static_cast<double>(frames) * fBeatsPerFrame;
+            updatePosition();
+        }
+    }
+
+   /**
+      Fill a time position with the current values.
+    */
+    void updateTimePosition(TimePosition& timePosition) const noexcept
+    {
+        const int32_t beatIndex = static_cast<int32_t>(fBeatInBar);
+
+        timePosition.playing = fPlaying;
+        timePosition.frame = fFrame;
+        timePosition.bbt.valid = fValid;
+        timePosition.bbt.bar = fBarIndex + 1;
+        timePosition.bbt.beat = beatIndex + 1;
+        timePosition.bbt.tick = (fBeatInBar - beatIndex) * fTicksPerBeat;
+        timePosition.bbt.barStartTick = fTicksPerBeat * fBeatsPerBar * fBarIndex + fBarStartTickOffset;
+        timePosition.bbt.beatsPerBar = fBeatsPerBar;
+        timePosition.bbt.beatType = fBeatType;
+        timePosition.bbt.ticksPerBeat = fTicksPerBeat;
+        timePosition.bbt.beatsPerMinute = fBeatsPerMinute;
+    }
+
+   /* --------------------------------------------------------------------------------------------------------
+    * Queries */
+
+   /**
+      Wherever the transport has valid BBT information.
+      If false, the values returned by the other queries are not meaningful.
+    */
+    bool isValid() const noexcept
+    {
+        return fValid;
+    }
+
+   /**
+      Wherever the transport is playing.
+    */
+    bool isPlaying() const noexcept
+    {
+        return fPlaying;
+    }
+
+   /**
+      Get the number of frames within a beat, or 0 if the sample rate is not set.
+    */
+    double getFramesPerBeat() const noexcept
+    {
+        return fFramesPerBeat;
+    }
+
+   /**
+      Get the number of beats within a frame, or 0 if the sample rate is not set.
+    */
+    double getBeatsPerFrame() const noexcept
+    {
+        return fBeatsPerFrame;
+    }
+
+   /**
+      Get the musical position in beats since the start of the song, at a frame offset of the current block.
+    */
+    double getBeatsAtFrame(const uint32_t frame) const noexcept
+    {
+        return fBeats + frame * fBeatsPerFrame;
+    }
+
+   /**
+      Get the musical position in quarter notes since the start of the song (PPQ),
+      at a frame offset of the current block.
+    */
+    double getQuarterNotesAtFrame(const uint32_t frame) const noexcept
+    {
+        return getBeatsAtFrame(frame) * 4.0 / fBeatType;
+    }
+
+   /**
+      Get the frame offset of the next beat boundary, relative to the start of the current block.
+      Returns 0 if the current block starts exactly on a beat.
+    */
+    double getFramesUntilNextBeat() const noexcept
+    {
+        return fFramesUntilNextBeat;
+    }
+
+   /**
+      Get the frame offset of the next bar boundary, relative to the start of the current block.
+      Returns 0 if the current block starts exactly on a bar.
+    */
+    double getFramesUntilNextBar() const noexcept
+    {
+        return fFramesUntilNextBar;
+    }
+
+   /**
+      Get the frame offset of the next tick boundary, relative to the start of the current block.
+      Returns 0 if the current block starts exactly on a tick.
+    */
+    double getFramesUntilNextTick() const noexcept
+    {
+        return fFramesUntilNextTick;
+    }
+
+private:
+    /** @internal */
+    bool fPlaying;
+    uint64_t fFrame;
+    bool fValid;
+    double fSampleRate;
+    double fBeatsPerMinute;
+    float fBeatsPerBar;
+    float fBeatType;
+    double fTicksPerBeat;
+    double fBeats;
+    double fBarStartTickOffset;
+
+    /** @internal values derived from the ones above */
+    double fBeatsPerFrame;
+    double fFramesPerBeat;
+    int32_t fBarIndex;
+    double fBeatInBar;
+    double fFramesUntilNextBeat;
+    double fFramesUntilNextBar;
+    double fFramesUntilNextTick;
+
+    void updateTempo() noexcept
+    {
+        if (fSampleRate > 0.0)
+        {
+            fBeatsPerFrame = fBeatsPerMinute / (60.0 * fSampleRate);
+            fFramesPerBeat = 60.0 * fSampleRate / fBeatsPerMinute;
+        }
+        else
+        {
+            fBeatsPerFrame = fFramesPerBeat = 0.0;
+        }
+
+        updatePosition();
+    }
+
+    void updatePosition() noexcept
+    {
+        const double barIndex = std::floor(fBeats / fBeatsPerBar);
+
+        fBarIndex = static_cast<int32_t>(barIndex);
+        fBeatInBar = fBeats - barIndex * fBeatsPerBar;
+
+        // guard against rounding errors around bar boundaries
+        if (fBeatInBar < 0.0)
+        {
+            fBeatInBar = 0.0;
+        }
+        else if (fBeatInBar >= fBeatsPerBar)
+        {
+            ++fBarIndex;
+            fBeatInBar = 0.0;
+        }
+
+        const double beatFraction = fBeatInBar - std::floor(fBeatInBar);
+        const double tickPosition = beatFraction * fTicksPerBeat;
+        const double tickFraction = tickPosition - std::floor(tickPosition);
+
+        fFramesUntilNextBeat = d_isZero(beatFraction) ? 0.0 : (1.0 - beatFraction) * fFramesPerBeat;
+        fFramesUntilNextBar  = d_isZero(fBeatInBar) ? 0.0 : (fBeatsPerBar - fBeatInBar) * fFramesPerBeat;
+        fFramesUntilNextTick = d_isZero(tickFraction) ? 0.0 : (1.0 - tickFraction) * fFramesPerBeat / fTicksPerBeat;
+    }
+};
+
 /** @} */
 
 // -----------------------------------------------------------------------------------------------------------
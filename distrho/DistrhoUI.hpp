@@ -188,6 +188,15 @@ public:
       A note with zero velocity will be sent as note-off (MIDI 0x80), otherwise note-on (MIDI 0x90).
     */
     void sendNote(uint8_t channel, uint8_t note, uint8_t velocity);
+
+   /**
+      Bind a parameter to the next MIDI CC message received by the plugin DSP side, also known as MIDI learn.@n
+      The new binding replaces the current one of the parameter, as set by Parameter::midiCC.
+      Passing a negative @a index cancels a pending request.
+      In VST3 the learned bindings are saved and restored as part of the plugin state.
+      @note Only supported in JACK standalones and VST3 for now, does nothing in other plugin formats.
+    */
+    void requestParameterMidiLearn(int32_t index);
 #endif
 
 #if DISTRHO_UI_FILE_BROWSER
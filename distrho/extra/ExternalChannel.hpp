@@ -0,0 +1,629 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_EXTERNAL_CHANNEL_HPP_INCLUDED
+#define DISTRHO_EXTERNAL_CHANNEL_HPP_INCLUDED
+
+#include "RingBuffer.hpp"
+#include "String.hpp"
+
+#ifndef DISTRHO_OS_WINDOWS
+# include <cerrno>
+# include <cstdlib>
+# include <fcntl.h>
+# include <poll.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// ExternalChannel class
+
+/**
+   Environment variable used to pass the channel connection details to the external process.
+ */
+static constexpr const char* const kExternalChannelEnvVar = "DPF_EXTERNAL_CHANNEL";
+
+/**
+   Bidirectional message channel between a plugin UI and an external process.
+
+   Messages are stored in ring buffers placed in shared memory, so that no data goes through pipes or sockets
+   and nothing is allocated while sending or receiving.
+   A pipe per direction is only used as wakeup mechanism, a single byte is written to it whenever
+   new messages are committed, which allows the receiving side to sleep or poll() on its file descriptor.
+
+   The side starting the external process calls create(), passes getEnvironmentValue() to the new process
+   under the @ref kExternalChannelEnvVar environment variable, and then calls closeRemoteEnds().
+   The external process calls attach() to connect to the same channel.
+   ExternalWindow does all of this automatically when starting a process through startExternalProcess().
+
+   Each direction has a single writer and a single reader, sending from multiple threads at once is not allowed.
+   Sending and receiving never block.
+   If the receiving side is not keeping up and a ring buffer gets full, new messages are dropped.
+
+   Small messages go through a 64Kb ring buffer.
+   State and custom data messages larger than 16Kb go through a separate 4Mb ring buffer,
+   with their order kept relative to other messages.
+   Messages larger than @ref kMaxMessageSize cannot be sent.
+
+   @note Not available on Windows yet, create() and attach() always fail there.
+ */
+class ExternalChannel
+{
+public:
+   /**
+      Maximum size of a single state or custom data message, including the state key and value null terminators.
+    */
+    static constexpr const uint32_t kMaxMessageSize = 2 * 1024 * 1024;
+
+   /**
+      Interface for receiving messages, see readMessages().
+      The pointers passed to these functions are only valid during the call.
+    */
+    struct Receiver {
+        virtual ~Receiver() {}
+        virtual void parameterReceived(uint32_t index, float value) = 0;
+        virtual void stateReceived(const char* /* key */, const char* /* value */) {}
+        virtual void noteReceived(uint8_t /* channel */, uint8_t /* note */, uint8_t /* velocity */) {}
+        virtual void dataReceived(const void* /* data */, uint32_t /* size */) {}
+    };
+
+   /**
+      Constructor.
+      The channel is invalid until create() or attach() succeeds.
+    */
+    ExternalChannel() noexcept
+        : fShared(nullptr),
+          fScratch(nullptr),
+          fReadFd(-1),
+          fWriteFd(-1),
+          fRemoteReadFd(-1),
+          fRemoteWriteFd(-1),
+          fIsOwner(false),
+          fName(),
+          fWriter(),
+          fReader(),
+          fBulkWriter(),
+          fBulkReader() {}
+
+   /**
+      Destructor.
+    */
+    ~ExternalChannel() noexcept
+    {
+        close();
+    }
+
+   /**
+      Check if this channel is connected and ready to be used.
+    */
+    bool isValid() const noexcept
+    {
+        return fShared != nullptr;
+    }
+
+   /**
+      Create a new channel, meant to be called before starting the external process.
+    */
+    bool create() noexcept
+    {
+        close();
+
+#ifndef DISTRHO_OS_WINDOWS
+        static uint32_t counter = 0;
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "/dpf-ext-%d-%u", static_cast<int>(::getpid()), ++counter);
+
+        const int fd = ::shm_open(name, O_CREAT|O_EXCL|O_RDWR, 0600);
+        DISTRHO_SAFE_ASSERT_RETURN(fd >= 0, false);
+
+        if (::ftruncate(fd, sizeof(SharedData)) != 0)
+        {
+            ::close(fd);
+            ::shm_unlink(name);
+            d_stderr2("ExternalChannel: failed to resize shared memory");
+            return false;
+        }
+
+        void* const ptr = ::mmap(nullptr, sizeof(SharedData), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (ptr == MAP_FAILED)
+        {
+            ::shm_unlink(name);
+            d_stderr2("ExternalChannel: failed to map shared memory");
+            return false;
+        }
+
+        int toRemote[2] = { -1, -1 };
+        int fromRemote[2] = { -1, -1 };
+
+        if (::pipe(toRemote) != 0 || ::pipe(fromRemote) != 0)
+        {
+            closeFd(toRemote[0]);
+            closeFd(toRemote[1]);
+            ::munmap(ptr, sizeof(SharedData));
+            ::shm_unlink(name);
+            d_stderr2("ExternalChannel: failed to create wakeup pipes");
+            return false;
+        }
+
+        // local ends are private to this process, remote ends are inherited by the external one
+        setupFd(toRemote[1], true);
+        setupFd(fromRemote[0], true);
+        setupFd(toRemote[0], false);
+        setupFd(fromRemote[1], false);
+
+        fShared = static_cast<SharedData*>(ptr);
+        fShared->magic = kMagic;
+        fName = name;
+        fIsOwner = true;
+        fWriteFd = toRemote[1];
+        fReadFd = fromRemote[0];
+        fRemoteReadFd = toRemote[0];
+        fRemoteWriteFd = fromRemote[1];
+
+        setup(&fShared->toExternal, &fShared->fromExternal,
+              &fShared->toExternalBulk, &fShared->fromExternalBulk, true);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+   /**
+      Attach to a channel created by the parent process.
+      The connection details are taken from the @ref kExternalChannelEnvVar environment variable if @a value is null.
+    */
+    bool attach(const char* value = nullptr) noexcept
+    {
+        close();
+
+#ifndef DISTRHO_OS_WINDOWS
+        if (value == nullptr)
+            value = std::getenv(kExternalChannelEnvVar);
+        if (value == nullptr || value[0] == '\0')
+            return false;
+
+        char name[64];
+        int readFd, writeFd;
+
+        if (std::sscanf(value, "%63[^:]:%d:%d", name, &readFd, &writeFd) != 3 || readFd < 0 || writeFd < 0)
+        {
+            d_stderr2("ExternalChannel: invalid connection details '%s'", value);
+            return false;
+        }
+
+        const int fd = ::shm_open(name, O_RDWR, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fd >= 0, false);
+
+        void* const ptr = ::mmap(nullptr, sizeof(SharedData), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        DISTRHO_SAFE_ASSERT_RETURN(ptr != MAP_FAILED, false);
+
+        fShared = static_cast<SharedData*>(ptr);
+
+        if (fShared->magic != kMagic)
+        {
+            ::munmap(ptr, sizeof(SharedData));
+            fShared = nullptr;
+            d_stderr2("ExternalChannel: version mismatch");
+            return false;
+        }
+
+        // do not pass these down to our own children
+        setupFd(readFd, true);
+        setupFd(writeFd, true);
+
+        fName = name;
+        fReadFd = readFd;
+        fWriteFd = writeFd;
+
+        setup(&fShared->fromExternal, &fShared->toExternal,
+              &fShared->fromExternalBulk, &fShared->toExternalBulk, false);
+        return true;
+#else
+        (void)value;
+        return false;
+#endif
+    }
+
+   /**
+      Close the channel, releasing all resources.
+    */
+    void close() noexcept
+    {
+#ifndef DISTRHO_OS_WINDOWS
+        if (fShared != nullptr)
+        {
+            fWriter.setRingBuffer(nullptr, false);
+            fReader.setRingBuffer(nullptr, false);
+            fBulkWriter.setRingBuffer(nullptr, false);
+            fBulkReader.setRingBuffer(nullptr, false);
+            ::munmap(fShared, sizeof(SharedData));
+            fShared = nullptr;
+        }
+
+        if (fIsOwner)
+        {
+            ::shm_unlink(fName);
+            fIsOwner = false;
+        }
+
+        closeFd(fReadFd);
+        closeFd(fWriteFd);
+        closeRemoteEnds();
+#endif
+        fName.clear();
+
+        delete[] fScratch;
+        fScratch = nullptr;
+    }
+
+   /**
+      Get the value to set under @ref kExternalChannelEnvVar for the external process.
+      Only valid on the side that called create(), and before closeRemoteEnds().
+    */
+    String getEnvironmentValue() const
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fIsOwner && fRemoteReadFd >= 0, String());
+
+        String value(fName);
+        value += ":";
+        value += String(fRemoteReadFd);
+        value += ":";
+        value += String(fRemoteWriteFd);
+        return value;
+    }
+
+   /**
+      Close the file descriptors meant for the external process.
+      Must be called once the external process has been started.
+    */
+    void closeRemoteEnds() noexcept
+    {
+#ifndef DISTRHO_OS_WINDOWS
+        closeFd(fRemoteReadFd);
+        closeFd(fRemoteWriteFd);
+#endif
+    }
+
+   /**
+      Get the file descriptor that becomes readable when new messages arrive, for use in poll() or select().
+      Returns -1 if the channel is not valid.
+    */
+    int getWakeupFd() const noexcept
+    {
+        return fReadFd;
+    }
+
+   /**
+      Wait until new messages arrive or @a timeoutInMs passes.
+      A negative timeout waits forever.
+    */
+    bool waitForMessages(const int timeoutInMs) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fShared != nullptr, false);
+
+        if (fReader.isDataAvailableForReading())
+            return true;
+
+#ifndef DISTRHO_OS_WINDOWS
+        struct pollfd pfd;
+        pfd.fd = fReadFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        return ::poll(&pfd, 1, timeoutInMs) > 0 && (pfd.revents & POLLIN) != 0;
+#else
+        (void)timeoutInMs;
+        return false;
+#endif
+    }
+
+    // -------------------------------------------------------------------
+    // sending
+
+    bool sendParameter(const uint32_t index, const float value) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fShared != nullptr, false);
+
+        fWriter.writeByte(kMessageParameter);
+        fWriter.writeUInt(index);
+        fWriter.writeFloat(value);
+        return commit();
+    }
+
+    bool sendState(const char* const key, const char* const value) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fShared != nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
+        DISTRHO_SAFE_ASSERT_RETURN(value != nullptr, false);
+
+        const uint32_t keySize = static_cast<uint32_t>(std::strlen(key)) + 1;
+        const uint32_t valueSize = static_cast<uint32_t>(std::strlen(value)) + 1;
+
+        return sendMessage(kMessageState, key, keySize, value, valueSize);
+    }
+
+    bool sendNote(const uint8_t channel, const uint8_t note, const uint8_t velocity) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fShared != nullptr, false);
+
+        fWriter.writeByte(kMessageNote);
+        fWriter.writeByte(channel);
+        fWriter.writeByte(note);
+        fWriter.writeByte(velocity);
+        return commit();
+    }
+
+   /**
+      Send a block of custom data, of up to @ref kMaxMessageSize bytes.
+    */
+    bool sendData(const void* const data, const uint32_t size) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fShared != nullptr, false);
+        DISTRHO_SAFE_ASSERT_RETURN(data != nullptr && size != 0, false);
+
+        return sendMessage(kMessageData, data, size, nullptr, 0);
+    }
+
+    // -------------------------------------------------------------------
+    // receiving
+
+   /**
+      Read all pending messages, calling the matching @a receiver function for each one.
+      Returns the number of messages read.
+    */
+    uint32_t readMessages(Receiver& receiver) noexcept
+    {
+        if (fShared == nullptr)
+            return 0;
+
+        // drain wakeup notifications first, so that messages committed from now on trigger a new one
+        drainWakeupFd();
+
+        uint32_t count = 0;
+
+        while (fReader.isDataAvailableForReading())
+        {
+            const uint8_t type = fReader.readByte();
+
+            switch (type)
+            {
+            case kMessageParameter:
+            {
+                const uint32_t index = fReader.readUInt();
+                const float value = fReader.readFloat();
+                receiver.parameterReceived(index, value);
+                ++count;
+                break;
+            }
+            case kMessageState:
+            case kMessageData:
+            case kMessageBulkState:
+            case kMessageBulkData:
+                if (! readPayloadMessage(receiver, type))
+                {
+                    discardPendingData();
+                    return count;
+                }
+                ++count;
+                break;
+            case kMessageNote:
+            {
+                const uint8_t channel = fReader.readByte();
+                const uint8_t note = fReader.readByte();
+                const uint8_t velocity = fReader.readByte();
+                receiver.noteReceived(channel, note, velocity);
+                ++count;
+                break;
+            }
+            default:
+                // unknown message, the stream cannot be trusted anymore
+                discardPendingData();
+                return count;
+            }
+        }
+
+        return count;
+    }
+
+private:
+    static constexpr const uint32_t kMagic = 0x44504603; // "DPF" + version
+    static constexpr const uint32_t kMaxInlineMessageSize = HugeStackBuffer::size / 4;
+
+    enum MessageType {
+        kMessageParameter = 1,
+        kMessageState,
+        kMessageNote,
+        kMessageData,
+        kMessageBulkState,
+        kMessageBulkData
+    };
+
+    // ring buffer for large messages, only holds their payload
+    struct BulkBuffer {
+        static const uint32_t size = 2 * kMaxMessageSize;
+        uint32_t head, tail, wrtn;
+        bool     invalidateCommit;
+        uint8_t  buf[size];
+    };
+
+    struct SharedData {
+        uint32_t magic;
+        HugeStackBuffer toExternal;
+        HugeStackBuffer fromExternal;
+        BulkBuffer toExternalBulk;
+        BulkBuffer fromExternalBulk;
+    };
+
+    SharedData* fShared;
+    char* fScratch; // kMaxMessageSize, for received state and data messages
+    int fReadFd;
+    int fWriteFd;
+    int fRemoteReadFd;
+    int fRemoteWriteFd;
+    bool fIsOwner;
+    String fName;
+
+    RingBufferControl<HugeStackBuffer> fWriter;
+    RingBufferControl<HugeStackBuffer> fReader;
+    RingBufferControl<BulkBuffer> fBulkWriter;
+    RingBufferControl<BulkBuffer> fBulkReader;
+
+    void setup(HugeStackBuffer* const writeBuf, HugeStackBuffer* const readBuf,
+               BulkBuffer* const bulkWriteBuf, BulkBuffer* const bulkReadBuf, const bool clear)
+    {
+        fScratch = new char[kMaxMessageSize];
+        fWriter.setRingBuffer(writeBuf, clear);
+        fReader.setRingBuffer(readBuf, clear);
+
+        // new shared memory is zero-filled, no need to touch all of it here
+        fBulkWriter.setRingBuffer(bulkWriteBuf, false);
+        fBulkReader.setRingBuffer(bulkReadBuf, false);
+    }
+
+    // message payload is the concatenation of data1 and data2
+    // small messages are stored inline, large ones have their payload in the bulk ring buffer
+    bool sendMessage(const uint8_t type,
+                     const void* const data1, const uint32_t size1,
+                     const void* const data2, const uint32_t size2) noexcept
+    {
+        const uint32_t totalSize = size1 + size2;
+
+        if (totalSize > kMaxMessageSize)
+        {
+            d_stderr2("ExternalChannel: message of %u bytes is too large, dropped", totalSize);
+            return false;
+        }
+
+        if (totalSize <= kMaxInlineMessageSize)
+        {
+            fWriter.writeByte(type);
+            fWriter.writeUInt(totalSize);
+            fWriter.writeCustomData(data1, size1);
+            if (size2 != 0)
+                fWriter.writeCustomData(data2, size2);
+            return commit();
+        }
+
+        // both parts must fit, so that the receiver never sees a payload without its message or vice-versa
+        if (fBulkWriter.getWritableDataSize() <= totalSize ||
+            fWriter.getWritableDataSize() <= sizeof(uint8_t) + sizeof(uint32_t))
+        {
+            d_stderr2("ExternalChannel: receiver is not keeping up, message of %u bytes dropped", totalSize);
+            return false;
+        }
+
+        fBulkWriter.writeCustomData(data1, size1);
+        if (size2 != 0)
+            fBulkWriter.writeCustomData(data2, size2);
+
+        if (! fBulkWriter.commitWrite())
+            return false;
+
+        fWriter.writeByte(type == kMessageState ? kMessageBulkState : kMessageBulkData);
+        fWriter.writeUInt(totalSize);
+        return commit();
+    }
+
+    bool readPayloadMessage(Receiver& receiver, const uint8_t type) noexcept
+    {
+        const uint32_t size = fReader.readUInt();
+        const bool bulk = type == kMessageBulkState || type == kMessageBulkData;
+        const uint32_t maxSize = bulk ? static_cast<uint32_t>(kMaxMessageSize)
+                                      : static_cast<uint32_t>(kMaxInlineMessageSize);
+
+        if (size == 0 || size > maxSize)
+            return false;
+
+        if (! (bulk ? fBulkReader.readCustomData(fScratch, size) : fReader.readCustomData(fScratch, size)))
+            return false;
+
+        if (type == kMessageData || type == kMessageBulkData)
+        {
+            receiver.dataReceived(fScratch, size);
+            return true;
+        }
+
+        fScratch[size - 1] = '\0';
+
+        const char* const key = fScratch;
+        const size_t keySize = std::strlen(key) + 1;
+        DISTRHO_SAFE_ASSERT_RETURN(keySize > 1 && keySize < size, true);
+
+        receiver.stateReceived(key, key + keySize);
+        return true;
+    }
+
+    // skip everything the other side has written so far, only touching our read position
+    void discardPendingData() noexcept
+    {
+        d_stderr2("ExternalChannel: invalid message received, discarding all pending data");
+        fReader.skipReadableData();
+        fBulkReader.skipReadableData();
+    }
+
+    void drainWakeupFd() const noexcept
+    {
+#ifndef DISTRHO_OS_WINDOWS
+        char tmp[64];
+        while (::read(fReadFd, tmp, sizeof(tmp)) > 0) {}
+#endif
+    }
+
+    bool commit() noexcept
+    {
+        if (! fWriter.commitWrite())
+            return false;
+
+#ifndef DISTRHO_OS_WINDOWS
+        // wakeup the other side, a full pipe means a wakeup is already pending
+        const char c = 0;
+        if (::write(fWriteFd, &c, 1) != 1) {}
+#endif
+        return true;
+    }
+
+#ifndef DISTRHO_OS_WINDOWS
+    static void closeFd(int& fd) noexcept
+    {
+        if (fd < 0)
+            return;
+
+        ::close(fd);
+        fd = -1;
+    }
+
+    static void setupFd(const int fd, const bool closeOnExec) noexcept
+    {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, closeOnExec ? FD_CLOEXEC : 0);
+    }
+#endif
+
+    DISTRHO_DECLARE_NON_COPYABLE(ExternalChannel)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_EXTERNAL_CHANNEL_HPP_INCLUDED
@@ -17,13 +17,19 @@
 #ifndef DISTRHO_EXTERNAL_WINDOW_HPP_INCLUDED
 #define DISTRHO_EXTERNAL_WINDOW_HPP_INCLUDED
 
-#include "String.hpp"
+#include "ExternalChannel.hpp"
 
 #ifndef DISTRHO_OS_WINDOWS
 # include <cerrno>
 # include <signal.h>
+# include <spawn.h>
 # include <sys/wait.h>
 # include <unistd.h>
+# ifdef DISTRHO_OS_MAC
+#  include <crt_externs.h>
+# else
+extern char** environ;
+# endif
 #endif
 
 START_NAMESPACE_DISTRHO
@@ -398,6 +404,18 @@ protected:
 #endif
     }
 
+#ifndef DISTRHO_OS_WINDOWS
+   /**
+      Send a block of custom data to the external process, received there through ExternalChannel::readMessages().
+      Returns false if there is no running process, or if it is not keeping up with previous messages.
+      @note Not available on Windows.
+    */
+    bool sendDataToExternalProcess(const void* const data, const uint32_t size)
+    {
+        return ext.channel.isValid() && ext.channel.sendData(data, size);
+    }
+#endif
+
    /* --------------------------------------------------------------------------------------------------------
     * ExternalWindow specific callbacks */
 
@@ -436,20 +454,34 @@ protected:
         // unused, meant for custom implementations
     }
 
+#ifndef DISTRHO_OS_WINDOWS
+   /**
+      A callback for when the external process sends a block of custom data through its ExternalChannel.
+      @note Not available on Windows.
+    */
+    virtual void externalDataReceived(const void* /* data */, uint32_t /* size */)
+    {
+        // unused, meant for custom implementations
+    }
+#endif
+
 private:
     friend class PluginWindow;
     friend class UI;
+    friend class UIExporter;
 
 #ifndef DISTRHO_OS_WINDOWS
     struct ExternalProcess {
         bool inUse;
         bool isQuitting;
         mutable pid_t pid;
+        ExternalChannel channel;
 
         ExternalProcess()
             : inUse(false),
               isQuitting(false),
-              pid(0) {}
+              pid(0),
+              channel() {}
 
         bool isRunning() const noexcept
         {
@@ -472,6 +504,16 @@ private:
         {
             terminateAndWait();
 
+            if (channel.create())
+            {
+                if (spawnWithChannel(args))
+                    return true;
+
+                channel.close();
+                d_stderr("Could not start external ui");
+                return false;
+            }
+
             pid = vfork();
 
             switch (pid)
@@ -490,10 +532,52 @@ private:
             }
         }
 
+        bool spawnWithChannel(const char* args[])
+        {
+            // environment cannot be changed after vfork, so build a new one for posix_spawn
+            const String envValue(String(kExternalChannelEnvVar) + "=" + channel.getEnvironmentValue());
+
+            const size_t envVarLen = std::strlen(kExternalChannelEnvVar);
+           #ifdef DISTRHO_OS_MAC
+            char** const environ = *_NSGetEnviron();
+           #endif
+
+            size_t envCount = 0;
+            for (char** e = environ; *e != nullptr; ++e)
+                ++envCount;
+
+            const char** const envp = new const char*[envCount + 2];
+            size_t i = 0;
+            for (char** e = environ; *e != nullptr; ++e)
+            {
+                if (std::strncmp(*e, kExternalChannelEnvVar, envVarLen) == 0 && (*e)[envVarLen] == '=')
+                    continue;
+                envp[i++] = *e;
+            }
+            envp[i++] = envValue.buffer();
+            envp[i] = nullptr;
+
+            const int ret = ::posix_spawnp(&pid, args[0], nullptr, nullptr, (char**)args, (char**)envp);
+            delete[] envp;
+
+            channel.closeRemoteEnds();
+
+            if (ret != 0)
+            {
+                pid = 0;
+                return false;
+            }
+
+            return true;
+        }
+
         void terminateAndWait()
         {
             if (pid <= 0)
+            {
+                channel.close();
                 return;
+            }
 
             d_stdout("Waiting for external process to stop,,,");
 
@@ -518,6 +602,7 @@ private:
                     {
                         d_stdout("Done! (no such process)");
                         pid = 0;
+                        channel.close();
                         return;
                     }
                     break;
@@ -527,6 +612,7 @@ private:
                     {
                         d_stdout("Done! (clean wait)");
                         pid = 0;
+                        channel.close();
                         return;
                     }
                     break;
@@ -819,6 +819,8 @@ bool fileBrowserIdle(const FileBrowserHandle handle)
     if (x11display == nullptr)
         return false;
 
+    x_fib_idle(x11display);
+
     XEvent event;
     while (XPending(x11display) > 0)
     {
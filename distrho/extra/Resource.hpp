@@ -0,0 +1,421 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_RESOURCE_HPP_INCLUDED
+#define DISTRHO_RESOURCE_HPP_INCLUDED
+
+#include "Mutex.hpp"
+#include "Thread.hpp"
+
+#include <chrono>
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// Resource class
+
+/**
+   Handle to an embedded binary resource, as generated by `utils/res2c.py --compress`.
+
+   Compressed resources are stored in LZ4 block format and only decoded on first use.
+   Decoded data is cached process-wide and shared by all handles to the same resource,
+   it is freed once the last handle referencing it is released or destroyed.
+
+   Resources that were stored uncompressed (encoded size equal to decoded size) are used directly without any copy.
+
+   Typical usage:
+   @code
+   Resource font(MyResources::fontData, MyResources::fontDataSize, MyResources::fontDataDecodedSize);
+
+   // optionally start decoding in the background, so data is ready when needed
+   font.preload();
+
+   // returns decoded data, waiting for background decoding if needed
+   if (const uint8_t* const data = font.getData())
+       loadFontFromMemory(data, font.getSize());
+   @endcode
+
+   A handle must not be used concurrently from multiple threads, but different handles to the same resource can be.
+ */
+class Resource
+{
+public:
+   /**
+      Statistics about all currently decoded resources in this process.
+    */
+    struct Stats {
+        /** Number of resources with decoded data in memory. */
+        uint32_t numResident;
+        /** Total size of decoded data in memory, in bytes. */
+        size_t residentSize;
+        /** Total time spent decoding resources, in milliseconds. */
+        double decodeTimeInMs;
+    };
+
+   /**
+      Constructor, does not decode anything yet.
+    */
+    Resource(const void* const encodedData, const uint32_t encodedSize, const uint32_t decodedSize) noexcept
+        : fEncodedData(static_cast<const uint8_t*>(encodedData)),
+          fEncodedSize(encodedSize),
+          fDecodedSize(decodedSize),
+          fEntry(nullptr),
+          fData(nullptr)
+    {
+        DISTRHO_SAFE_ASSERT(encodedData != nullptr);
+        DISTRHO_SAFE_ASSERT(encodedSize <= decodedSize);
+
+        // make sure the cache outlives static handles
+        if (isCompressed())
+            getCache();
+    }
+
+   /**
+      Destructor, releases the decoded data if this is the last handle using it.
+    */
+    ~Resource() noexcept
+    {
+        release();
+    }
+
+   /**
+      Whether the resource data is compressed.
+    */
+    bool isCompressed() const noexcept
+    {
+        return fEncodedSize != fDecodedSize;
+    }
+
+   /**
+      Get the decoded size of the resource, in bytes.
+    */
+    uint32_t getSize() const noexcept
+    {
+        return fDecodedSize;
+    }
+
+   /**
+      Get the decoded resource data, decoding it now if not done yet.
+      If the resource is being decoded in the background, waits for it to finish.
+      Returns null if the data is invalid.
+    */
+    const uint8_t* getData() noexcept
+    {
+        if (! isCompressed())
+            return fEncodedData;
+
+        if (fData != nullptr)
+            return fData;
+
+        if (fEntry == nullptr)
+            fEntry = acquireEntry();
+
+        DISTRHO_SAFE_ASSERT_RETURN(fEntry != nullptr, nullptr);
+
+        decodeEntry(*fEntry);
+
+        fData = fEntry->data;
+        return fData;
+    }
+
+   /**
+      Start decoding the resource on a background thread, if not decoded yet.
+      Does nothing for uncompressed resources.
+    */
+    void preload() noexcept
+    {
+        if (! isCompressed() || fData != nullptr)
+            return;
+
+        if (fEntry == nullptr)
+            fEntry = acquireEntry();
+
+        DISTRHO_SAFE_ASSERT_RETURN(fEntry != nullptr,);
+
+        Cache& cache(getCache());
+        const MutexLocker cml(cache.mutex);
+
+        if (fEntry->loader != nullptr)
+            return;
+
+        fEntry->loader = new Loader(*fEntry);
+        fEntry->loader->startThread();
+    }
+
+   /**
+      Release the reference to the decoded data held by this handle.
+      Decoded data is freed if no other handle references it, calling getData() again decodes it anew.
+    */
+    void release() noexcept
+    {
+        Entry* const entry = fEntry;
+
+        if (entry == nullptr)
+            return;
+
+        fEntry = nullptr;
+        fData = nullptr;
+
+        Cache& cache(getCache());
+
+        {
+            const MutexLocker cml(cache.mutex);
+
+            if (--entry->refCount != 0)
+                return;
+
+            for (Entry** it = &cache.entries; *it != nullptr; it = &(*it)->next)
+            {
+                if (*it == entry)
+                {
+                    *it = entry->next;
+                    break;
+                }
+            }
+        }
+
+        if (entry->loader != nullptr)
+        {
+            entry->loader->stopThread(-1);
+            delete entry->loader;
+        }
+
+        std::free(entry->data);
+        delete entry;
+    }
+
+   /**
+      Get the time spent decoding this resource, in milliseconds.
+      Returns 0 if not decoded yet or if not compressed.
+    */
+    double getDecodeTimeInMs() const noexcept
+    {
+        if (fEntry == nullptr)
+            return 0.0;
+
+        const MutexLocker cml(fEntry->mutex);
+        return fEntry->decodeTimeInMs;
+    }
+
+   /**
+      Get statistics about all currently decoded resources in this process.
+    */
+    static Stats getStats() noexcept
+    {
+        Stats stats = { 0, 0, 0.0 };
+
+        Cache& cache(getCache());
+        const MutexLocker cml(cache.mutex);
+
+        for (Entry* entry = cache.entries; entry != nullptr; entry = entry->next)
+        {
+            const MutexLocker eml(entry->mutex);
+
+            if (entry->data == nullptr)
+                continue;
+
+            ++stats.numResident;
+            stats.residentSize += entry->decodedSize;
+            stats.decodeTimeInMs += entry->decodeTimeInMs;
+        }
+
+        return stats;
+    }
+
+   /**
+      Decode LZ4 block data from @a src into @a dst.
+      Returns false if the data is invalid or does not decode into exactly @a dstSize bytes.
+    */
+    static bool decode(const uint8_t* src, const uint32_t srcSize, uint8_t* const dst, const uint32_t dstSize) noexcept
+    {
+        const uint8_t* const srcEnd = src + srcSize;
+        const uint8_t* const dstEnd = dst + dstSize;
+        uint8_t* out = dst;
+
+        while (src < srcEnd)
+        {
+            const uint8_t token = *src++;
+
+            // literals
+            size_t length = token >> 4;
+            if (length == 15 && ! readLength(src, srcEnd, length))
+                return false;
+
+            if (length > static_cast<size_t>(srcEnd - src) || length > static_cast<size_t>(dstEnd - out))
+                return false;
+
+            std::memcpy(out, src, length);
+            src += length;
+            out += length;
+
+            // last sequence has no match
+            if (src == srcEnd)
+                break;
+
+            // match
+            if (srcEnd - src < 2)
+                return false;
+
+            const size_t offset = src[0] | (src[1] << 8);
+            src += 2;
+
+            if (offset == 0 || offset > static_cast<size_t>(out - dst))
+                return false;
+
+            length = token & 15;
+            if (length == 15 && ! readLength(src, srcEnd, length))
+                return false;
+            length += 4;
+
+            if (length > static_cast<size_t>(dstEnd - out))
+                return false;
+
+            // byte by byte, source and target may overlap
+            const uint8_t* match = out - offset;
+            for (size_t i = 0; i < length; ++i)
+                *out++ = *match++;
+        }
+
+        return out == dstEnd;
+    }
+
+private:
+    class Loader;
+
+    struct Entry {
+        const uint8_t* encodedData;
+        uint32_t encodedSize;
+        uint32_t decodedSize;
+        uint32_t refCount;
+        uint8_t* data;
+        double decodeTimeInMs;
+        Loader* loader;
+        Entry* next;
+        Mutex mutex;
+    };
+
+    struct Cache {
+        Mutex mutex;
+        Entry* entries;
+
+        Cache() noexcept
+            : mutex(),
+              entries(nullptr) {}
+    };
+
+    class Loader : public Thread
+    {
+    public:
+        Loader(Entry& entry) noexcept
+            : Thread("DPF Resource"),
+              fEntry(entry) {}
+
+    protected:
+        void run() override
+        {
+            decodeEntry(fEntry);
+        }
+
+    private:
+        Entry& fEntry;
+
+        DISTRHO_DECLARE_NON_COPYABLE(Loader)
+    };
+
+    const uint8_t* const fEncodedData;
+    const uint32_t fEncodedSize;
+    const uint32_t fDecodedSize;
+    Entry* fEntry;
+    const uint8_t* fData;
+
+    static Cache& getCache() noexcept
+    {
+        static Cache cache;
+        return cache;
+    }
+
+    Entry* acquireEntry() noexcept
+    {
+        Cache& cache(getCache());
+        const MutexLocker cml(cache.mutex);
+
+        for (Entry* entry = cache.entries; entry != nullptr; entry = entry->next)
+        {
+            if (entry->encodedData == fEncodedData)
+            {
+                ++entry->refCount;
+                return entry;
+            }
+        }
+
+        Entry* const entry = new Entry;
+        entry->encodedData = fEncodedData;
+        entry->encodedSize = fEncodedSize;
+        entry->decodedSize = fDecodedSize;
+        entry->refCount = 1;
+        entry->data = nullptr;
+        entry->decodeTimeInMs = 0.0;
+        entry->loader = nullptr;
+        entry->next = cache.entries;
+        cache.entries = entry;
+        return entry;
+    }
+
+    static void decodeEntry(Entry& entry) noexcept
+    {
+        const MutexLocker eml(entry.mutex);
+
+        if (entry.data != nullptr)
+            return;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        uint8_t* const data = static_cast<uint8_t*>(std::malloc(entry.decodedSize));
+        DISTRHO_SAFE_ASSERT_RETURN(data != nullptr,);
+
+        if (! decode(entry.encodedData, entry.encodedSize, data, entry.decodedSize))
+        {
+            d_stderr2("Resource: failed to decode %u bytes of data", entry.encodedSize);
+            std::free(data);
+            return;
+        }
+
+        entry.data = data;
+        entry.decodeTimeInMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static bool readLength(const uint8_t*& src, const uint8_t* const srcEnd, size_t& length) noexcept
+    {
+        for (uint8_t byte = 255; byte == 255;)
+        {
+            if (src == srcEnd)
+                return false;
+
+            byte = *src++;
+            length += byte;
+        }
+
+        return true;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(Resource)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_RESOURCE_HPP_INCLUDED
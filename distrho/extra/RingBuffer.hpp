@@ -265,6 +265,19 @@ public:
         errorWriting = false;
     }
 
+    /*
+     * Discard all data available for reading.
+     * Only the read position is changed, so this is safe to call from the reading side while a writer is active.
+     */
+    void skipReadableData() noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(buffer != nullptr,);
+
+        __atomic_store_n(&buffer->tail, __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+
+        errorReading = false;
+    }
+
     // -------------------------------------------------------------------
     // read operations
 
@@ -559,8 +572,8 @@ public:
         // nothing to commit?
         DISTRHO_SAFE_ASSERT_RETURN(buffer->head != buffer->wrtn, false);
 
-        // all ok
-        buffer->head = buffer->wrtn;
+        // all ok, release so that written data is visible before the new head position
+        __atomic_store_n(&buffer->head, buffer->wrtn, __ATOMIC_RELEASE);
         errorWriting = false;
         return true;
     }
@@ -605,7 +618,7 @@ protected:
 
         uint8_t* const bytebuf = static_cast<uint8_t*>(buf);
 
-        const uint32_t head = buffer->head;
+        const uint32_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
         const uint32_t tail = buffer->tail;
         const uint32_t wrap = head > tail ? 0 : buffer->size;
 
@@ -644,7 +657,7 @@ protected:
                 readto = 0;
         }
 
-        buffer->tail = readto;
+        __atomic_store_n(&buffer->tail, readto, __ATOMIC_RELEASE);
         errorReading = false;
         return true;
     }
@@ -671,7 +684,7 @@ protected:
 
         uint8_t* const bytebuf = static_cast<uint8_t*>(buf);
 
-        const uint32_t head = buffer->head;
+        const uint32_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
         const uint32_t tail = buffer->tail;
         const uint32_t wrap = head > tail ? 0 : buffer->size;
 
@@ -716,7 +729,7 @@ protected:
 
         const uint8_t* const bytebuf = static_cast<const uint8_t*>(buf);
 
-        const uint32_t tail = buffer->tail;
+        const uint32_t tail = __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE);
         const uint32_t wrtn = buffer->wrtn;
         const uint32_t wrap = tail > wrtn ? 0 : buffer->size;
 
@@ -157,9 +157,9 @@ public:
         DISTRHO_SAFE_ASSERT_RETURN(handle != 0, false);
        #endif
         pthread_detach(handle);
-        _copyFrom(handle);
 
-        // wait for thread to start
+        // wait for thread to start, it sets its own handle before reporting ready
+        // so that a thread finishing right away is never seen as still running
         fSignal.wait();
         return true;
     }
@@ -314,6 +314,8 @@ private:
         if (fName.isNotEmpty())
             setCurrentThreadName(fName);
 
+        _copyFrom(pthread_self());
+
         // report ready
         fSignal.signal();
 
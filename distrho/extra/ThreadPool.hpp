@@ -0,0 +1,262 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef DISTRHO_THREAD_POOL_HPP_INCLUDED
+#define DISTRHO_THREAD_POOL_HPP_INCLUDED
+
+#include "Thread.hpp"
+
+#ifndef DISTRHO_OS_WINDOWS
+# include <sched.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// ThreadPool class
+
+/**
+   Pool of worker threads for running a set of independent tasks in parallel.
+
+   A batch of tasks is started with runTasks(), which blocks until all of them are done.
+   Each thread, including the calling one, pulls the next unclaimed task index from a shared atomic counter,
+   so that threads finishing early keep taking work from the slower ones.
+
+   Worker threads sleep while there is no work to do and are woken up at the start of each batch.
+   Once all tasks are claimed the batch is closed, so workers that wake up late simply go back to sleep.
+   The calling thread only spins (yielding) while tasks already claimed by other threads are still running,
+   it never waits for workers that have not started yet.
+
+   A pool can be shared by multiple users, for example all plugin instances in the process.
+   If runTasks() is called while another thread is using the pool, the tasks are run on the calling thread instead.
+ */
+class ThreadPool
+{
+public:
+   /**
+      Function called for each task, with @a taskIndex in the range [0, numTasks).
+    */
+    typedef void (*TaskFunc)(void* ptr, uint32_t taskIndex);
+
+   /**
+      Constructor.
+      When @a numThreads is 0, one worker is created per available CPU core minus one (for the calling thread).
+    */
+    ThreadPool(const uint32_t numThreads = 0, const bool withRealtimePriority = true) noexcept
+        : fWorkers(nullptr),
+          fNumWorkers(numThreads != 0 ? numThreads : getDefaultNumThreads()),
+          fTaskFunc(nullptr),
+          fTaskPtr(nullptr),
+          fNumTasks(0),
+          fNextTask(0),
+          fBatchState(kBatchClosed),
+          fBusy(false)
+    {
+        if (fNumWorkers == 0)
+            return;
+
+        fWorkers = new Worker*[fNumWorkers];
+
+        for (uint32_t i=0; i < fNumWorkers; ++i)
+        {
+            fWorkers[i] = new Worker(*this);
+
+            if (! fWorkers[i]->startThread(withRealtimePriority))
+            {
+                delete fWorkers[i];
+                fNumWorkers = i;
+                break;
+            }
+        }
+    }
+
+   /**
+      Destructor.
+      Stops and waits for all worker threads.
+    */
+    ~ThreadPool() noexcept
+    {
+        for (uint32_t i=0; i < fNumWorkers; ++i)
+        {
+            fWorkers[i]->stop();
+            delete fWorkers[i];
+        }
+
+        delete[] fWorkers;
+    }
+
+   /**
+      Get the amount of worker threads, not counting the calling thread.
+    */
+    uint32_t getNumThreads() const noexcept
+    {
+        return fNumWorkers;
+    }
+
+   /**
+      Run @a numTasks tasks, calling @a func for each task index.
+      Blocks until all tasks are done, the calling thread processes tasks as well.
+      If the pool is busy with tasks from another thread, all tasks are run on the calling thread.
+    */
+    void runTasks(const TaskFunc func, void* const ptr, const uint32_t numTasks) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(func != nullptr,);
+
+        if (numTasks == 0)
+            return;
+
+        const uint32_t numWorkers = std::min(fNumWorkers, numTasks - 1);
+
+        if (numWorkers == 0 || __atomic_exchange_n(&fBusy, true, __ATOMIC_ACQUIRE))
+        {
+            for (uint32_t i=0; i < numTasks; ++i)
+                func(ptr, i);
+            return;
+        }
+
+        fTaskFunc = func;
+        fTaskPtr = ptr;
+        fNumTasks = numTasks;
+        __atomic_store_n(&fNextTask, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&fBatchState, 0, __ATOMIC_RELEASE);
+
+        for (uint32_t i=0; i < numWorkers; ++i)
+            fWorkers[i]->wakeUp();
+
+        processTasks();
+
+        // no task is left to claim, close the batch so that late workers do not join anymore
+        // and wait only for the workers that are still running a task
+        __atomic_or_fetch(&fBatchState, kBatchClosed, __ATOMIC_ACQ_REL);
+
+        while (__atomic_load_n(&fBatchState, __ATOMIC_ACQUIRE) != kBatchClosed)
+            yield();
+
+        __atomic_store_n(&fBusy, false, __ATOMIC_RELEASE);
+    }
+
+private:
+    class Worker : public Thread
+    {
+    public:
+        Worker(ThreadPool& pool) noexcept
+            : Thread("DPF ThreadPool"),
+              fPool(pool),
+              fSignal() {}
+
+        void wakeUp() noexcept
+        {
+            fSignal.signal();
+        }
+
+        void stop() noexcept
+        {
+            signalThreadShouldExit();
+            fSignal.signal();
+            stopThread(-1);
+        }
+
+    protected:
+        void run() override
+        {
+            for (;;)
+            {
+                fSignal.wait();
+
+                if (shouldThreadExit())
+                    break;
+
+                if (! fPool.joinBatch())
+                    continue;
+
+                fPool.processTasks();
+                __atomic_sub_fetch(&fPool.fBatchState, 1, __ATOMIC_RELEASE);
+            }
+        }
+
+    private:
+        ThreadPool& fPool;
+        Signal fSignal;
+
+        DISTRHO_DECLARE_NON_COPYABLE(Worker)
+    };
+
+    Worker** fWorkers;
+    uint32_t fNumWorkers;
+
+    TaskFunc fTaskFunc;
+    void*    fTaskPtr;
+    uint32_t fNumTasks;
+
+    // amount of workers running tasks of the current batch, plus kBatchClosed once no new worker can join
+    static constexpr const uint32_t kBatchClosed = 0x80000000;
+
+    volatile uint32_t fNextTask;
+    volatile uint32_t fBatchState;
+    volatile bool fBusy;
+
+    bool joinBatch() noexcept
+    {
+        uint32_t state = __atomic_load_n(&fBatchState, __ATOMIC_RELAXED);
+
+        do {
+            if (state & kBatchClosed)
+                return false;
+        } while (! __atomic_compare_exchange_n(&fBatchState, &state, state + 1, true,
+                                               __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+        return true;
+    }
+
+    void processTasks() noexcept
+    {
+        for (uint32_t index; (index = __atomic_fetch_add(&fNextTask, 1, __ATOMIC_ACQ_REL)) < fNumTasks;)
+        {
+            try {
+                fTaskFunc(fTaskPtr, index);
+            } DISTRHO_SAFE_EXCEPTION("ThreadPool task");
+        }
+    }
+
+    static void yield() noexcept
+    {
+       #ifdef DISTRHO_OS_WINDOWS
+        ::SwitchToThread();
+       #else
+        ::sched_yield();
+       #endif
+    }
+
+    static uint32_t getDefaultNumThreads() noexcept
+    {
+       #ifdef DISTRHO_OS_WINDOWS
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        const long numCPUs = static_cast<long>(info.dwNumberOfProcessors);
+       #else
+        const long numCPUs = ::sysconf(_SC_NPROCESSORS_ONLN);
+       #endif
+        return numCPUs > 1 ? static_cast<uint32_t>(numCPUs - 1) : 0;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(ThreadPool)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DISTRHO_THREAD_POOL_HPP_INCLUDED
@@ -22,7 +22,7 @@
  */
 
 /* Test and example:
- *   gcc -Wall -D SOFD_TEST -g -o sofd libsofd.c -lX11
+ *   gcc -Wall -D SOFD_TEST -g -o sofd libsofd.c -lX11 -lpthread
  *
  * public API documentation and example code at the bottom of this file
  *
@@ -339,6 +339,7 @@ const char *x_fib_recent_file(const char *appname) {
 
 #ifdef HAVE_X11
 #include <dirent.h>
+#include <pthread.h>
 
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
@@ -451,6 +452,51 @@ static int            _dircount = 0;
 static int            _pathparts = 0;
 static int            _placecnt = 0;
 
+#define FIB_JOB_BATCH 64
+#define FIB_JOB_RESORT_MS 250
+#define FIB_DIRCACHE_SIZE 4
+
+typedef struct {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	DIR *dir;
+	char path[1024];
+	char sel[256];
+	time_t mtime;
+	off_t size;
+	ino_t ino;
+	int hidden;
+	int filter;
+	int (*filter_function)(const char *filename);
+	FibFileEntry *list; // entries not yet picked up by the UI thread, protected by lock
+	int count;          // protected by lock
+	int alloc;          // protected by lock
+	uint8_t cancel;     // protected by lock
+	uint8_t done;       // protected by lock
+	uint8_t active;     // UI thread only
+	uint8_t threaded;   // UI thread only
+	uint8_t autosel;    // UI thread only, selection was not made by the user
+	uint64_t last_sort; // UI thread only
+} FibDirJob;
+
+typedef struct {
+	char path[1024];
+	time_t mtime;
+	off_t size;
+	ino_t ino;
+	int hidden;
+	int filter;
+	int (*filter_function)(const char *filename);
+	FibFileEntry *list;
+	int count;
+	unsigned long used;
+} FibDirCache;
+
+static FibDirJob     _fib_job;
+static FibDirCache   _fib_dircache[FIB_DIRCACHE_SIZE];
+static unsigned long _fib_dircache_clock = 0;
+static int           _diralloc = 0;
+
 static FibButton     _btn_ok;
 static FibButton     _btn_cancel;
 static FibButton     _btn_filter;
@@ -488,20 +534,31 @@ static int (*_fib_filter_function)(const char *filename);
 #define DOUBLE_BUFFER
 #define LIST_ENTRY_HOVER
 
+// font metrics are queried from the server once per font and kept until the
+// dialog is closed, text extents are then computed client-side.
+static XFontStruct *_fib_fontinfo = NULL;
+
+static void fib_free_fontinfo () {
+	if (!_fib_fontinfo) return;
+#ifndef DISTRHO_OS_HAIKU // FIXME
+	XFreeFontInfo (NULL, _fib_fontinfo, 1);
+#endif
+	_fib_fontinfo = NULL;
+}
+
 static int query_font_geometry (Display *dpy, GC gc, const char *txt, int *w, int *h, int *a, int *d) {
 	XCharStruct text_structure;
 	int font_direction, font_ascent, font_descent;
-	XFontStruct *fontinfo = XQueryFont (dpy, XGContextFromGC (gc));
 
-	if (!fontinfo) { return -1; }
-	XTextExtents (fontinfo, txt, strlen (txt), &font_direction, &font_ascent, &font_descent, &text_structure);
-	if (w) *w = XTextWidth (fontinfo, txt, strlen (txt));
+	if (!_fib_fontinfo) {
+		_fib_fontinfo = XQueryFont (dpy, XGContextFromGC (gc));
+	}
+	if (!_fib_fontinfo) { return -1; }
+	XTextExtents (_fib_fontinfo, txt, strlen (txt), &font_direction, &font_ascent, &font_descent, &text_structure);
+	if (w) *w = XTextWidth (_fib_fontinfo, txt, strlen (txt));
 	if (h) *h = text_structure.ascent + text_structure.descent;
 	if (a) *a = text_structure.ascent;
 	if (d) *d = text_structure.descent;
-#ifndef DISTRHO_OS_HAIKU // FIXME
-	XFreeFontInfo (NULL, fontinfo, 1);
-#endif
 	return 0;
 }
 
@@ -1064,7 +1121,7 @@ static int cmp_s_down (const void *p1, const void *p2) {
 	return a->size > b->size ? 1 : -1;
 }
 
-static void fmt_size (Display *dpy, FibFileEntry *f) {
+static void fmt_size (FibFileEntry *f) {
 	if (f->size > 10995116277760) {
 		sprintf (f->strsize, "%.0f TB", f->size / 1099511627776.f);
 	}
@@ -1092,26 +1149,31 @@ static void fmt_size (Display *dpy, FibFileEntry *f) {
 	else {
 		sprintf (f->strsize, "%.0f  B", f->size / 1.f);
 	}
-	int sw = 0;
-	query_font_geometry (dpy, _fib_gc, f->strsize, &sw, NULL, NULL, NULL);
-	if (sw > _fib_font_size_width) {
-		_fib_font_size_width = sw;
-	}
-	f->ssizew = sw;
 }
 
-static void fmt_time (Display *dpy, FibFileEntry *f) {
-	struct tm *tmp;
-	tmp = localtime (&f->mtime);
-	if (!tmp) {
+static void fmt_time (FibFileEntry *f) {
+	struct tm tmb;
+	if (!localtime_r (&f->mtime, &tmb)) {
 		return;
 	}
-	strftime (f->strtime, sizeof(f->strtime), "%F %H:%M", tmp);
+	strftime (f->strtime, sizeof(f->strtime), "%F %H:%M", &tmb);
+}
 
-	int tw = 0;
-	query_font_geometry (dpy, _fib_gc, f->strtime, &tw, NULL, NULL, NULL);
-	if (tw > _fib_font_time_width) {
-		_fib_font_time_width = tw;
+static void fmt_measure (Display *dpy, FibFileEntry *f) {
+	if (!(f->flags & 4)) {
+		int sw = 0;
+		query_font_geometry (dpy, _fib_gc, f->strsize, &sw, NULL, NULL, NULL);
+		if (sw > _fib_font_size_width) {
+			_fib_font_size_width = sw;
+		}
+		f->ssizew = sw;
+	}
+	if (f->strtime[0]) {
+		int tw = 0;
+		query_font_geometry (dpy, _fib_gc, f->strtime, &tw, NULL, NULL, NULL);
+		if (tw > _fib_font_time_width) {
+			_fib_font_time_width = tw;
+		}
 	}
 }
 
@@ -1139,6 +1201,7 @@ static void fib_resort (const char * sel) {
 }
 
 static void fib_select (Display *dpy, int item) {
+	_fib_job.autosel = 0;
 	if (_fsel >= 0) {
 		_dirlist[_fsel].flags &= ~2;
 	}
@@ -1159,46 +1222,109 @@ static void fib_select (Display *dpy, int item) {
 	fib_expose (dpy, _fib_win);
 }
 
-static inline int fib_filter (const char *name) {
-	if (_fib_filter_function) {
-		return _fib_filter_function (name);
+// thread-safe, filter settings are passed in instead of read from the globals
+static inline int fib_filter (const char *name, int filter, int (*filter_function)(const char*)) {
+	if (filter && filter_function) {
+		return filter_function (name);
 	} else {
 		return 1;
 	}
 }
 
-static void fib_pre_opendir (Display *dpy) {
-	if (_dirlist) free (_dirlist);
-	if (_pathbtn) free (_pathbtn);
-	_dirlist = NULL;
-	_pathbtn = NULL;
-	_dircount = 0;
-	_pathparts = 0;
-	query_font_geometry (dpy, _fib_gc, "Size  ", &_fib_font_size_width, NULL, NULL, NULL);
-	fib_reset ();
-	_fsel = -1;
+/* directory listing
+ *
+ * enumeration and stat() of directory entries happen in a background thread,
+ * entries are handed over to the UI thread in batches by fib_job_poll ()
+ * which measures their text, adds them to _dirlist and periodically re-sorts.
+ * complete listings are cached per directory, keyed on the directory's
+ * inode, size and mtime, since the mtime alone only has 1 second resolution.
+ */
+static uint64_t fib_now_ms () {
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
-static void fib_post_opendir (Display *dpy, const char *sel) {
-	if (_dircount > 0)
-		_fsel = 0; // select first
-	else
-		_fsel = -1;
-	fib_resort (sel);
+static int fib_dircache_load (Display *dpy, const char *path, const struct stat *fs) {
+	int i, j;
+	for (i = 0; i < FIB_DIRCACHE_SIZE; ++i) {
+		FibDirCache *c = &_fib_dircache[i];
+		if (!c->list || strcmp (c->path, path)) continue;
+		if (c->mtime != fs->st_mtime || c->size != fs->st_size || c->ino != fs->st_ino) continue;
+		if (c->hidden != _fib_hidden_fn || c->filter != _fib_filter_fn) continue;
+		if (c->filter_function != _fib_filter_function) continue;
+
+		_dirlist = (FibFileEntry*) malloc (c->count * sizeof(FibFileEntry));
+		if (!_dirlist) return 0;
+		memcpy (_dirlist, c->list, c->count * sizeof(FibFileEntry));
+		_dircount = _diralloc = c->count;
+		for (j = 0; j < _dircount; ++j) {
+			fmt_measure (dpy, &_dirlist[j]);
+		}
+		c->used = ++_fib_dircache_clock;
+		return 1;
+	}
+	return 0;
+}
 
-	if (_dircount > 0 && _fsel >= 0) {
-		fib_select (dpy, _fsel);
-	} else {
-		fib_expose (dpy, _fib_win);
+static void fib_dircache_store () {
+	int i, j;
+	FibDirCache *c = NULL;
+	if (_dircount < 1 || _fib_job.mtime == 0) return;
+
+	for (i = 0; i < FIB_DIRCACHE_SIZE && !c; ++i) {
+		if (!strcmp (_fib_dircache[i].path, _fib_job.path)) c = &_fib_dircache[i];
+	}
+	for (i = 0; i < FIB_DIRCACHE_SIZE && !c; ++i) {
+		if (!_fib_dircache[i].list) c = &_fib_dircache[i];
+	}
+	if (!c) {
+		c = &_fib_dircache[0];
+		for (i = 1; i < FIB_DIRCACHE_SIZE; ++i) {
+			if (_fib_dircache[i].used < c->used) c = &_fib_dircache[i];
+		}
+	}
+
+	free (c->list);
+	c->list = (FibFileEntry*) malloc (_dircount * sizeof(FibFileEntry));
+	if (!c->list) {
+		c->path[0] = '\0';
+		return;
 	}
+	memcpy (c->list, _dirlist, _dircount * sizeof(FibFileEntry));
+	for (j = 0; j < _dircount; ++j) {
+		c->list[j].flags &= ~2;
+	}
+	strcpy (c->path, _fib_job.path);
+	c->mtime = _fib_job.mtime;
+	c->size = _fib_job.size;
+	c->ino = _fib_job.ino;
+	c->hidden = _fib_job.hidden;
+	c->filter = _fib_job.filter;
+	c->filter_function = _fib_job.filter_function;
+	c->count = _dircount;
+	c->used = ++_fib_dircache_clock;
 }
 
-static int fib_dirlistadd (Display *dpy, const int i, const char* path, const char *name, time_t mtime) {
+static void fib_dircache_clear () {
+	int i;
+	for (i = 0; i < FIB_DIRCACHE_SIZE; ++i) {
+		free (_fib_dircache[i].list);
+	}
+	memset (_fib_dircache, 0, sizeof(_fib_dircache));
+	_fib_dircache_clock = 0;
+}
+
+// thread-safe, does not touch any X resources
+static int fib_stat_entry (FibFileEntry *f, const char* path, const char *name, time_t mtime,
+		int hidden, int filter, int (*filter_function)(const char*)) {
 	char tp[1024];
 	struct stat fs;
-	if (!_fib_hidden_fn && name[0] == '.') return -1;
+	if (!hidden && name[0] == '.') return -1;
 	if (!strcmp (name, ".")) return -1;
 	if (!strcmp (name, "..")) return -1;
+	if (strlen (path) + strlen (name) >= sizeof(tp)) return -1;
+	if (strlen (name) >= sizeof(f->name)) return -1;
 	strcpy (tp, path);
 	strcat (tp, name);
 	if (access (tp, R_OK)) {
@@ -1207,28 +1333,229 @@ static int fib_dirlistadd (Display *dpy, const int i, const char* path, const ch
 	if (stat (tp, &fs)) {
 		return -1;
 	}
-	assert (i < _dircount); // could happen if dir changes while we're reading.
-	if (i >= _dircount) return -1;
+	memset (f, 0, sizeof(FibFileEntry));
 	if (S_ISDIR (fs.st_mode)) {
-		_dirlist[i].flags |= 4;
+		f->flags |= 4;
 	}
 	else if (S_ISREG (fs.st_mode)) {
-		if (!fib_filter (name)) return -1;
+		if (!fib_filter (name, filter, filter_function)) return -1;
 	}
 #if 0 // only needed with lstat()
 	else if (S_ISLNK (fs.st_mode)) {
-		if (!fib_filter (name)) return -1;
+		if (!fib_filter (name, filter, filter_function)) return -1;
 	}
 #endif
 	else {
 		return -1;
 	}
-	strcpy (_dirlist[i].name, name);
-	_dirlist[i].mtime = mtime > 0 ? mtime : fs.st_mtime;
-	_dirlist[i].size = fs.st_size;
-	if (!(_dirlist[i].flags & 4))
-		fmt_size (dpy, &_dirlist[i]);
-	fmt_time (dpy, &_dirlist[i]);
+	strcpy (f->name, name);
+	f->mtime = mtime > 0 ? mtime : fs.st_mtime;
+	f->size = fs.st_size;
+	if (!(f->flags & 4))
+		fmt_size (f);
+	fmt_time (f);
+	return 0;
+}
+
+static void *fib_job_run (void *arg) {
+	FibDirJob *job = (FibDirJob*) arg;
+	FibFileEntry batch[FIB_JOB_BATCH];
+	struct dirent *de;
+	int n = 0;
+
+	for (;;) {
+		de = readdir (job->dir);
+		if (de && !fib_stat_entry (&batch[n], job->path, de->d_name, 0,
+					job->hidden, job->filter, job->filter_function)) {
+			++n;
+		}
+		if (de && n < FIB_JOB_BATCH) {
+			continue;
+		}
+
+		pthread_mutex_lock (&job->lock);
+		if (n > 0 && job->count + n > job->alloc) {
+			const int alloc = MAX (job->count + n, job->alloc * 2);
+			FibFileEntry *list = (FibFileEntry*) realloc (job->list, alloc * sizeof(FibFileEntry));
+			if (list) {
+				job->list = list;
+				job->alloc = alloc;
+			} else {
+				de = NULL; // out of memory, stop here
+				n = 0;
+			}
+		}
+		if (n > 0) {
+			memcpy (&job->list[job->count], batch, n * sizeof(FibFileEntry));
+			job->count += n;
+		}
+		n = 0;
+		if (!de || job->cancel) {
+			job->done = 1;
+			pthread_mutex_unlock (&job->lock);
+			break;
+		}
+		pthread_mutex_unlock (&job->lock);
+	}
+
+	closedir (job->dir);
+	job->dir = NULL;
+	return NULL;
+}
+
+static void fib_job_finish () {
+	if (_fib_job.threaded) {
+		pthread_join (_fib_job.thread, NULL);
+	}
+	pthread_mutex_destroy (&_fib_job.lock);
+	free (_fib_job.list);
+	_fib_job.list = NULL;
+	_fib_job.count = _fib_job.alloc = 0;
+	_fib_job.active = 0;
+}
+
+static void fib_job_stop () {
+	if (!_fib_job.active) return;
+	pthread_mutex_lock (&_fib_job.lock);
+	_fib_job.cancel = 1;
+	pthread_mutex_unlock (&_fib_job.lock);
+	fib_job_finish ();
+}
+
+static void fib_job_start (DIR *dir, const char *path, const struct stat *fs, const char *sel) {
+	assert (!_fib_job.active);
+	_fib_job.dir = dir;
+	strcpy (_fib_job.path, path);
+	if (sel && strlen (sel) < sizeof(_fib_job.sel)) {
+		strcpy (_fib_job.sel, sel);
+	} else {
+		_fib_job.sel[0] = '\0';
+	}
+	_fib_job.mtime = fs->st_mtime;
+	_fib_job.size = fs->st_size;
+	_fib_job.ino = fs->st_ino;
+	_fib_job.hidden = _fib_hidden_fn;
+	_fib_job.filter = _fib_filter_fn;
+	_fib_job.filter_function = _fib_filter_function;
+	_fib_job.list = NULL;
+	_fib_job.count = _fib_job.alloc = 0;
+	_fib_job.cancel = _fib_job.done = 0;
+	_fib_job.autosel = 1;
+	_fib_job.last_sort = 0;
+	_fib_job.active = 1;
+	pthread_mutex_init (&_fib_job.lock, NULL);
+
+	_fib_job.threaded = pthread_create (&_fib_job.thread, NULL, fib_job_run, &_fib_job) == 0;
+	if (!_fib_job.threaded) {
+		fib_job_run (&_fib_job);
+	}
+}
+
+static void fib_job_update (Display *dpy, int final) {
+	char sel[256];
+	const int autosel = _fib_job.autosel;
+	if (_fsel >= 0 && !autosel) {
+		strcpy (sel, _dirlist[_fsel].name);
+	} else {
+		strcpy (sel, _fib_job.sel);
+	}
+	if (_fsel >= 0) {
+		_dirlist[_fsel].flags &= ~2;
+	}
+	_fsel = _dircount > 0 ? 0 : -1;
+	fib_resort (sel[0] ? sel : NULL);
+
+	if (_fsel < 0) {
+		fib_expose (dpy, _fib_win);
+	} else if (final && autosel) {
+		fib_select (dpy, _fsel);
+	} else {
+		// do not scroll the view while entries are still being added
+		_dirlist[_fsel].flags |= 2;
+		fib_expose (dpy, _fib_win);
+	}
+	_fib_job.autosel = autosel;
+}
+
+static int fib_job_poll (Display *dpy) {
+	FibFileEntry *list;
+	int count, done, i;
+	if (!_fib_job.active) return 0;
+
+	pthread_mutex_lock (&_fib_job.lock);
+	list = _fib_job.list;
+	count = _fib_job.count;
+	done = _fib_job.done;
+	_fib_job.list = NULL;
+	_fib_job.count = _fib_job.alloc = 0;
+	pthread_mutex_unlock (&_fib_job.lock);
+
+	if (count > 0 && _dircount + count > _diralloc) {
+		const int alloc = MAX (_dircount + count, _diralloc * 2);
+		FibFileEntry *dl = (FibFileEntry*) realloc (_dirlist, alloc * sizeof(FibFileEntry));
+		if (dl) {
+			_dirlist = dl;
+			_diralloc = alloc;
+		} else {
+			count = 0;
+		}
+	}
+	for (i = 0; i < count; ++i) {
+		_dirlist[_dircount] = list[i];
+		fmt_measure (dpy, &_dirlist[_dircount]);
+		++_dircount;
+	}
+	free (list);
+
+	if (done) {
+		fib_job_finish ();
+		fib_dircache_store ();
+	}
+
+	if (count > 0 || done) {
+		const uint64_t now = fib_now_ms ();
+		if (done || now - _fib_job.last_sort >= FIB_JOB_RESORT_MS) {
+			_fib_job.last_sort = now;
+			fib_job_update (dpy, done);
+		}
+	}
+	return _fib_job.active;
+}
+
+static void fib_pre_opendir (Display *dpy) {
+	fib_job_stop ();
+	if (_dirlist) free (_dirlist);
+	if (_pathbtn) free (_pathbtn);
+	_dirlist = NULL;
+	_pathbtn = NULL;
+	_dircount = 0;
+	_diralloc = 0;
+	_pathparts = 0;
+	query_font_geometry (dpy, _fib_gc, "Size  ", &_fib_font_size_width, NULL, NULL, NULL);
+	fib_reset ();
+	_fsel = -1;
+}
+
+static void fib_post_opendir (Display *dpy, const char *sel) {
+	if (_dircount > 0)
+		_fsel = 0; // select first
+	else
+		_fsel = -1;
+	fib_resort (sel);
+
+	if (_dircount > 0 && _fsel >= 0) {
+		fib_select (dpy, _fsel);
+	} else {
+		fib_expose (dpy, _fib_win);
+	}
+}
+
+static int fib_dirlistadd (Display *dpy, const int i, const char* path, const char *name, time_t mtime) {
+	assert (i < _dircount);
+	if (i >= _dircount) return -1;
+	if (fib_stat_entry (&_dirlist[i], path, name, mtime,
+				_fib_hidden_fn, _fib_filter_fn, _fib_filter_function)) return -1;
+	fmt_measure (dpy, &_dirlist[i]);
 	return 0;
 }
 
@@ -1239,7 +1566,7 @@ static int fib_openrecent (Display *dpy, const char *sel) {
 	fib_pre_opendir (dpy);
 	query_font_geometry (dpy, _fib_gc, "Last Used", &_fib_font_time_width, NULL, NULL, NULL);
 	_dirlist = (FibFileEntry*) calloc (_recentcnt, sizeof(FibFileEntry));
-	_dircount = _recentcnt;
+	_dircount = _diralloc = _recentcnt;
 	for (j = 0, i = 0; j < _recentcnt; ++j) {
 		char base[1024];
 		char *s = strrchr (_recentlist[j].path, '/');
@@ -1258,6 +1585,8 @@ static int fib_openrecent (Display *dpy, const char *sel) {
 	return _dircount;
 }
 
+/* returns the number of entries listed so far,
+ * or at least 1 while the directory is still being read. */
 static int fib_opendir (Display *dpy, const char* path, const char *sel) {
 	char *t0, *t1;
 	int i;
@@ -1281,31 +1610,22 @@ static int fib_opendir (Display *dpy, const char* path, const char *sel) {
 	if (!dir) {
 		strcpy (_cur_path, "/");
 	} else {
-		int i;
-		struct dirent *de;
+		struct stat fs;
 		if (path != _cur_path)
 			strcpy (_cur_path, path);
 
 		if (_cur_path[strlen (_cur_path) -1] != '/')
 			strcat (_cur_path, "/");
 
-		while ((de = readdir (dir))) {
-			if (!_fib_hidden_fn && de->d_name[0] == '.') continue;
-			++_dircount;
+		if (stat (_cur_path, &fs)) {
+			memset (&fs, 0, sizeof(fs));
 		}
 
-		if (_dircount > 0)
-			_dirlist = (FibFileEntry*) calloc (_dircount, sizeof(FibFileEntry));
-
-		rewinddir (dir);
-
-		i = 0;
-		while ((de = readdir (dir))) {
-			if (!fib_dirlistadd (dpy, i, _cur_path, de->d_name, 0))
-				++i;
+		if (fs.st_mtime != 0 && fib_dircache_load (dpy, _cur_path, &fs)) {
+			closedir (dir);
+		} else {
+			fib_job_start (dir, _cur_path, &fs, sel);
 		}
-		_dircount = i;
-		closedir (dir);
 	}
 
 	t0 = _cur_path;
@@ -1332,7 +1652,8 @@ static int fib_opendir (Display *dpy, const char* path, const char *sel) {
 		++i;
 	}
 	fib_post_opendir (dpy, sel);
-	return _dircount;
+	fib_job_poll (dpy);
+	return _dircount + _fib_job.active;
 }
 
 static int fib_open (Display *dpy, int item) {
@@ -1393,6 +1714,7 @@ static void cb_places (Display *dpy) {
 }
 
 static void cb_filter (Display *dpy) {
+	fib_job_stop (); // filter callbacks may read the old setting
 	_fib_filter_fn = ! _fib_filter_fn;
 	sync_button_states ();
 	char *sel = _fsel >= 0 ? strdup (_dirlist[_fsel].name) : NULL;
@@ -2128,11 +2450,15 @@ int x_fib_show (Display *dpy, Window parent, int x, int y, double scalefactor) {
 
 void x_fib_close (Display *dpy) {
 	if (!_fib_win) return;
+	fib_job_stop ();
+	fib_dircache_clear ();
+	fib_free_fontinfo ();
 	XFreeGC (dpy, _fib_gc);
 	XDestroyWindow (dpy, _fib_win);
 	_fib_win = 0;
 	free (_dirlist);
 	_dirlist = NULL;
+	_diralloc = 0;
 	free (_pathbtn);
 	_pathbtn = NULL;
 	if (_fibfont != None) XUnloadFont (dpy, _fibfont);
@@ -2291,6 +2617,12 @@ int x_fib_handle_events (Display *dpy, XEvent *event) {
 	return _status;
 }
 
+int x_fib_idle (Display *dpy) {
+	if (!_fib_win) return 0;
+	if (_status) return 0;
+	return fib_job_poll (dpy);
+}
+
 int x_fib_status () {
 	return _status;
 }
@@ -2455,6 +2787,7 @@ int main (int argc, char **argv) {
 
 	while (1) {
 		XEvent event;
+		x_fib_idle (dpy);
 		while (XPending (dpy) > 0) {
 			XNextEvent (dpy, &event);
 			if (x_fib_handle_events (dpy, &event)) {
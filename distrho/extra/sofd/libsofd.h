@@ -64,6 +64,18 @@ void x_fib_close (Display *dpy);
  */
 int x_fib_handle_events (Display *dpy, XEvent *event);
 
+/** process pending results of the background directory listing.
+ * Directories are read in a separate thread, this function adds
+ * the entries found so far to the list and redraws it.
+ * It should be called periodically while the dialog is displayed.
+ * It is safe to run this function even if the dialog is
+ * closed or was not initialized.
+ *
+ * @param dpy X Display connection
+ * @return 1 while a directory listing is in progress, 0 otherwise
+ */
+int x_fib_idle (Display *dpy);
+
 /** last status of the dialog
  * @return >0: file was selected, <0: canceled or inactive. 0: active
  */
@@ -111,6 +123,8 @@ int x_fib_cfg_buttons (int k, int v);
  *  the callback function is called with the file name (basename only)
  *  and is expected to return 1 if the file passes the filter
  *  and 0 if the file should not be listed by default.
+ *  it is not called while 'show all' is active, and it may be called
+ *  from a background thread while a directory is being read.
  * @return 0 on success.
  */
 int x_fib_cfg_filter_callback (int (*cb)(const char*));
@@ -28,6 +28,34 @@ bool        d_nextPluginIsDummy = false;
 bool        d_nextPluginIsSelfTest = false;
 bool        d_nextCanRequestParameterValueChanges = false;
 
+#ifdef DPF_PLUGIN_USING_THREAD_POOL
+static Mutex       sSharedThreadPoolMutex;
+static ThreadPool* sSharedThreadPool = nullptr;
+static uint32_t    sSharedThreadPoolUsers = 0;
+
+ThreadPool* d_acquireSharedThreadPool()
+{
+    const MutexLocker cml(sSharedThreadPoolMutex);
+
+    if (sSharedThreadPoolUsers++ == 0)
+        sSharedThreadPool = new ThreadPool();
+
+    return sSharedThreadPool;
+}
+
+void d_releaseSharedThreadPool()
+{
+    const MutexLocker cml(sSharedThreadPoolMutex);
+    DISTRHO_SAFE_ASSERT_RETURN(sSharedThreadPoolUsers != 0,);
+
+    if (--sSharedThreadPoolUsers == 0)
+    {
+        delete sSharedThreadPool;
+        sSharedThreadPool = nullptr;
+    }
+}
+#endif
+
 /* ------------------------------------------------------------------------------------------------------------
  * Static fallback data, see DistrhoPluginInternal.hpp */
 
@@ -94,7 +122,11 @@ Plugin::~Plugin()
 
 uint32_t Plugin::getBufferSize() const noexcept
 {
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+    return DISTRHO_PLUGIN_FIXED_BLOCK_SIZE;
+#else
     return pData->bufferSize;
+#endif
 }
 
 double Plugin::getSampleRate() const noexcept
@@ -150,6 +182,28 @@ bool Plugin::requestParameterValueChange(const uint32_t index, const float value
 }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+void Plugin::runTasks(const uint32_t count) noexcept
+{
+    if (count == 0)
+        return;
+
+    if (count != 1 && pData->runTasksCallback(count))
+        return;
+
+   #ifdef DPF_PLUGIN_USING_THREAD_POOL
+    if (pData->threadPool != nullptr)
+    {
+        pData->threadPool->runTasks(PrivateData::runTaskFromThreadPool, this, count);
+        return;
+    }
+   #endif
+
+    for (uint32_t i=0; i < count; ++i)
+        runTask(i);
+}
+#endif
+
 #if DISTRHO_PLUGIN_WANT_STATE
 bool Plugin::updateStateValue(const char* const key, const char* const value) noexcept
 {
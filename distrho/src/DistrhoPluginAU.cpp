@@ -454,6 +454,7 @@ public:
        #if DISTRHO_PLUGIN_WANT_TIMEPOS
         fTimePosition.clear();
         fTimePosition.bbt.ticksPerBeat = kDefaultTicksPerBeat;
+        fTransport.reset();
        #endif
 
         fPlugin.activate();
@@ -1009,7 +1010,7 @@ public:
 
        #if DISTRHO_PLUGIN_NUM_INPUTS != 0 && DISTRHO_PLUGIN_NUM_OUTPUTS != 0
         case kAudioUnitProperty_InPlaceProcessing:
-            *static_cast<UInt32*>(outData) = 1;
+            *static_cast<UInt32*>(outData) = DISTRHO_PLUGIN_SUPPORTS_IN_PLACE ? 1 : 0;
             return noErr;
        #endif
 
@@ -1786,6 +1787,7 @@ public:
        #if DISTRHO_PLUGIN_WANT_TIMEPOS
         fTimePosition.clear();
         fTimePosition.bbt.ticksPerBeat = kDefaultTicksPerBeat;
+        fTransport.reset();
        #endif
         return noErr;
     }
@@ -2129,6 +2131,7 @@ private:
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
     HostCallbackInfo fHostCallbackInfo;
     TimePosition fTimePosition;
+    TransportEngine fTransport;
    #endif
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -2200,56 +2203,46 @@ private:
             Float64 g2 = 0.0;
             UInt32 u1 = 0;
 
+            fTransport.setSampleRate(fPlugin.getSampleRate());
+
             if (fHostCallbackInfo.musicalTimeLocationProc != nullptr
                 && fHostCallbackInfo.musicalTimeLocationProc(fHostCallbackInfo.hostUserData,
-                                                             nullptr, &f1, &u1, nullptr) == noErr)
+                                                             nullptr, &f1, &u1, nullptr) == noErr
+                && f1 > 0.f && u1 != 0)
             {
-                fTimePosition.bbt.beatsPerBar = f1;
-                fTimePosition.bbt.beatType    = u1;
+                fTransport.setTimeSignature(f1, u1);
             }
             else
             {
-                fTimePosition.bbt.beatsPerBar = 4.f;
-                fTimePosition.bbt.beatType    = 4.f;
+                fTransport.setTimeSignature(4.f, 4.f);
             }
 
             if (fHostCallbackInfo.beatAndTempoProc != nullptr
                 && fHostCallbackInfo.beatAndTempoProc(fHostCallbackInfo.hostUserData, &g1, &g2) == noErr)
             {
-                const double beat = static_cast<int32_t>(g1);
-
-                fTimePosition.bbt.valid = true;
-                fTimePosition.bbt.bar   = static_cast<int32_t>(beat / f1) + 1;
-                fTimePosition.bbt.beat  = static_cast<int32_t>(std::fmod(beat, f1)) + 1;
-                fTimePosition.bbt.tick  = std::fmod(g1, 1.0) * 1920.0;
-                fTimePosition.bbt.beatsPerMinute = g2;
+                fTransport.setTempo(g2);
+                fTransport.setPositionInBeats(g1);
             }
             else
             {
-                fTimePosition.bbt.valid = false;
-                fTimePosition.bbt.bar   = 1;
-                fTimePosition.bbt.beat  = 1;
-                fTimePosition.bbt.tick  = 0.0;
-                fTimePosition.bbt.beatsPerMinute = 120.0;
+                fTransport.setTempo(120.0);
+                fTransport.setPositionInvalid();
             }
 
             if (fHostCallbackInfo.transportStateProc != nullptr
                 && fHostCallbackInfo.transportStateProc(fHostCallbackInfo.hostUserData,
                                                         &b1, nullptr, &g1, nullptr, nullptr, nullptr) == noErr)
             {
-                fTimePosition.playing = b1;
-                fTimePosition.frame = static_cast<int64_t>(g1);
+                fTransport.setPlaying(b1);
+                fTransport.setFrame(static_cast<int64_t>(g1));
             }
             else
             {
-                fTimePosition.playing = false;
-                fTimePosition.frame = 0;
+                fTransport.setPlaying(false);
+                fTransport.setFrame(0);
             }
 
-            fTimePosition.bbt.barStartTick = kDefaultTicksPerBeat *
-                                             fTimePosition.bbt.beatsPerBar *
-                                             (fTimePosition.bbt.bar - 1);
-
+            fTransport.updateTimePosition(fTimePosition);
             fPlugin.setTimePosition(fTimePosition);
         }
        #endif
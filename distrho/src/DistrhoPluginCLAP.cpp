@@ -23,6 +23,7 @@
  */
 
 #include "DistrhoPluginInternal.hpp"
+#include "../DistrhoPluginUtils.hpp"
 #include "extra/ScopedPointer.hpp"
 
 #ifndef DISTRHO_PLUGIN_CLAP_ID
@@ -55,6 +56,7 @@
 #include "clap/ext/params.h"
 #include "clap/ext/state.h"
 #include "clap/ext/thread-check.h"
+#include "clap/ext/thread-pool.h"
 #include "clap/ext/timer-support.h"
 
 #if (defined(DISTRHO_OS_MAC) || defined(DISTRHO_OS_WINDOWS)) && ! DISTRHO_PLUGIN_HAS_EXTERNAL_UI
@@ -805,7 +807,15 @@ public:
         if (!clap_version_is_compatible(fHost->clap_version))
             return false;
 
-        return fHostExtensions.init();
+        if (! fHostExtensions.init())
+            return false;
+
+       #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+        if (fHostExtensions.threadPool != nullptr)
+            fPlugin.setRunTasksCallback(runTasksCallback);
+       #endif
+
+        return true;
     }
 
     void activate(const double sampleRate, const uint32_t maxFramesCount)
@@ -879,72 +889,32 @@ public:
        #endif
 
        #if DISTRHO_PLUGIN_WANT_TIMEPOS
+        fTransport.setSampleRate(fPlugin.getSampleRate());
+
         if (const clap_event_transport_t* const transport = process->transport)
         {
-            fTimePosition.playing = (transport->flags & CLAP_TRANSPORT_IS_PLAYING) != 0 &&
-                                    (transport->flags & CLAP_TRANSPORT_IS_WITHIN_PRE_ROLL) == 0;
-
-            fTimePosition.frame = process->steady_time >= 0 ? process->steady_time : 0;
-
-            if (transport->flags & CLAP_TRANSPORT_HAS_TEMPO)
-                fTimePosition.bbt.beatsPerMinute = transport->tempo;
-            else
-                fTimePosition.bbt.beatsPerMinute = 120.0;
-
-            // ticksPerBeat is not possible with CLAP
-            fTimePosition.bbt.ticksPerBeat = 1920.0;
+            fTransport.setPlaying((transport->flags & CLAP_TRANSPORT_IS_PLAYING) != 0 &&
+                                  (transport->flags & CLAP_TRANSPORT_IS_WITHIN_PRE_ROLL) == 0);
+            fTransport.setFrame(process->steady_time >= 0 ? process->steady_time : 0);
+            fTransport.setTempo(transport->flags & CLAP_TRANSPORT_HAS_TEMPO ? transport->tempo : 120.0);
 
             if ((transport->flags & (CLAP_TRANSPORT_HAS_BEATS_TIMELINE|CLAP_TRANSPORT_HAS_TIME_SIGNATURE)) == (CLAP_TRANSPORT_HAS_BEATS_TIMELINE|CLAP_TRANSPORT_HAS_TIME_SIGNATURE))
             {
-                if (transport->song_pos_beats >= 0)
-                {
-                    const int64_t clapPos   = std::abs(transport->song_pos_beats);
-                    const int64_t clapBeats = clapPos >> 31;
-                    const double  clapRest  = static_cast<double>(clapPos & 0x7fffffff) / CLAP_BEATTIME_FACTOR;
-
-                    fTimePosition.bbt.bar  = static_cast<int32_t>(clapBeats) / transport->tsig_num + 1;
-                    fTimePosition.bbt.beat = static_cast<int32_t>(clapBeats % transport->tsig_num) + 1;
-                    fTimePosition.bbt.tick = clapRest * fTimePosition.bbt.ticksPerBeat;
-                }
-                else
-                {
-                    fTimePosition.bbt.bar  = 1;
-                    fTimePosition.bbt.beat = 1;
-                    fTimePosition.bbt.tick = 0.0;
-                }
-
-                fTimePosition.bbt.valid       = true;
-                fTimePosition.bbt.beatsPerBar = transport->tsig_num;
-                fTimePosition.bbt.beatType    = transport->tsig_denom;
+                fTransport.setTimeSignature(transport->tsig_num, transport->tsig_denom);
+                fTransport.setPositionInBeats(static_cast<double>(transport->song_pos_beats) / CLAP_BEATTIME_FACTOR);
             }
             else
             {
-                fTimePosition.bbt.valid       = false;
-                fTimePosition.bbt.bar         = 1;
-                fTimePosition.bbt.beat        = 1;
-                fTimePosition.bbt.tick        = 0.0;
-                fTimePosition.bbt.beatsPerBar = 4.0f;
-                fTimePosition.bbt.beatType    = 4.0f;
+                fTransport.setTimeSignature(4.f, 4.f);
+                fTransport.setPositionInvalid();
             }
-
-            fTimePosition.bbt.barStartTick = fTimePosition.bbt.ticksPerBeat*
-                                             fTimePosition.bbt.beatsPerBar*
-                                             (fTimePosition.bbt.bar-1);
         }
         else
         {
-            fTimePosition.playing = false;
-            fTimePosition.frame = 0;
-            fTimePosition.bbt.valid          = false;
-            fTimePosition.bbt.beatsPerMinute = 120.0;
-            fTimePosition.bbt.bar            = 1;
-            fTimePosition.bbt.beat           = 1;
-            fTimePosition.bbt.tick           = 0.0;
-            fTimePosition.bbt.beatsPerBar    = 4.f;
-            fTimePosition.bbt.beatType       = 4.f;
-            fTimePosition.bbt.barStartTick   = 0;
+            fTransport.reset();
         }
 
+        fTransport.updateTimePosition(fTimePosition);
         fPlugin.setTimePosition(fTimePosition);
        #endif
 
@@ -1356,11 +1326,25 @@ public:
             break;
         }
 
+       #if DISTRHO_PLUGIN_SUPPORTS_IN_PLACE
         info->in_place_pair = busInfo.hasPair ? busInfo.groupId : CLAP_INVALID_ID;
+       #else
+        info->in_place_pair = CLAP_INVALID_ID;
+       #endif
         return true;
     }
    #endif
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // thread pool
+
+   #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+    void runTask(const uint32_t taskIndex)
+    {
+        fPlugin.runTask(taskIndex);
+    }
+   #endif
+
     // ----------------------------------------------------------------------------------------------------------------
     // latency
 
@@ -1811,6 +1795,7 @@ private:
   #endif
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
     TimePosition fTimePosition;
+    TransportEngine fTransport;
    #endif
 
     struct HostExtensions {
@@ -1820,6 +1805,9 @@ private:
         const clap_host_latency_t* latency;
         const clap_host_thread_check_t* threadCheck;
        #endif
+       #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+        const clap_host_thread_pool_t* threadPool;
+       #endif
 
         HostExtensions(const clap_host_t* const host)
             : host(host),
@@ -1828,6 +1816,9 @@ private:
             , latency(nullptr)
             , threadCheck(nullptr)
            #endif
+           #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+            , threadPool(nullptr)
+           #endif
         {}
 
         bool init()
@@ -1838,6 +1829,11 @@ private:
             DISTRHO_SAFE_ASSERT_RETURN(host->request_callback != nullptr, false);
             latency = static_cast<const clap_host_latency_t*>(host->get_extension(host, CLAP_EXT_LATENCY));
             threadCheck = static_cast<const clap_host_thread_check_t*>(host->get_extension(host, CLAP_EXT_THREAD_CHECK));
+           #endif
+           #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+            threadPool = static_cast<const clap_host_thread_pool_t*>(host->get_extension(host, CLAP_EXT_THREAD_POOL));
+            if (threadPool != nullptr && threadPool->request_exec == nullptr)
+                threadPool = nullptr;
            #endif
             return true;
         }
@@ -2054,6 +2050,18 @@ private:
         return static_cast<PluginCLAP*>(ptr)->updateState(key, value);
     }
    #endif
+
+   #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+    bool runTasks(const uint32_t count)
+    {
+        return fHostExtensions.threadPool->request_exec(fHost, count);
+    }
+
+    static bool runTasksCallback(void* const ptr, const uint32_t count)
+    {
+        return static_cast<PluginCLAP*>(ptr)->runTasks(count);
+    }
+   #endif
 };
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -2378,6 +2386,21 @@ static const clap_plugin_latency_t clap_plugin_latency = {
 };
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// plugin thread pool
+
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+static void CLAP_ABI clap_plugin_thread_pool_exec(const clap_plugin_t* const plugin, const uint32_t task_index)
+{
+    PluginCLAP* const instance = static_cast<PluginCLAP*>(plugin->plugin_data);
+    instance->runTask(task_index);
+}
+
+static const clap_plugin_thread_pool_t clap_plugin_thread_pool = {
+    clap_plugin_thread_pool_exec
+};
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // plugin state
 
@@ -2472,6 +2495,10 @@ static const void* CLAP_ABI clap_plugin_get_extension(const clap_plugin_t*, cons
     if (std::strcmp(id, CLAP_EXT_LATENCY) == 0)
         return &clap_plugin_latency;
    #endif
+   #if DISTRHO_PLUGIN_WANT_THREAD_POOL
+    if (std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0)
+        return &clap_plugin_thread_pool;
+   #endif
   #if DISTRHO_PLUGIN_HAS_UI
     if (std::strcmp(id, CLAP_EXT_GUI) == 0)
         return &clap_plugin_gui;
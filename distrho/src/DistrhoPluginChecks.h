@@ -57,10 +57,18 @@
 # define DISTRHO_PLUGIN_IS_RT_SAFE 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_FIXED_BLOCK_SIZE
+# define DISTRHO_PLUGIN_FIXED_BLOCK_SIZE 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_IS_SYNTH
 # define DISTRHO_PLUGIN_IS_SYNTH 0
 #endif
 
+#ifndef DISTRHO_PLUGIN_SUPPORTS_IN_PLACE
+# define DISTRHO_PLUGIN_SUPPORTS_IN_PLACE 1
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_DIRECT_ACCESS
 # define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 0
 #endif
@@ -90,6 +98,10 @@
 # define DISTRHO_PLUGIN_WANT_FULL_STATE_WAS_NOT_SET
 #endif
 
+#ifndef DISTRHO_PLUGIN_WANT_THREAD_POOL
+# define DISTRHO_PLUGIN_WANT_THREAD_POOL 0
+#endif
+
 #ifndef DISTRHO_PLUGIN_WANT_TIMEPOS
 # define DISTRHO_PLUGIN_WANT_TIMEPOS 0
 #endif
@@ -172,6 +184,14 @@
 # endif
 #endif
 
+// --------------------------------------------------------------------------------------------------------------------
+// Enable latency if plugin uses fixed block size processing
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0 && ! DISTRHO_PLUGIN_WANT_LATENCY
+# undef DISTRHO_PLUGIN_WANT_LATENCY
+# define DISTRHO_PLUGIN_WANT_LATENCY 1
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // Enable full state if plugin exports presets
 
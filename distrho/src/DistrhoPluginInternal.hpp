@@ -23,8 +23,22 @@
 # include "DistrhoPluginVST.hpp"
 #endif
 
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL && ! defined(DISTRHO_OS_WASM)
+# define DPF_PLUGIN_USING_THREAD_POOL
+# include "../extra/ThreadPool.hpp"
+#endif
+
+#include "../extra/Sleep.hpp"
+
+#include <algorithm>
+#include <chrono>
 #include <set>
 
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0 && ! DISTRHO_PLUGIN_SUPPORTS_IN_PLACE && \
+    DISTRHO_PLUGIN_NUM_INPUTS != 0 && DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+# define DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS
+#endif
+
 START_NAMESPACE_DISTRHO
 
 // -----------------------------------------------------------------------
@@ -42,12 +56,19 @@ extern bool        d_nextPluginIsDummy;
 extern bool        d_nextPluginIsSelfTest;
 extern bool        d_nextCanRequestParameterValueChanges;
 
+#ifdef DPF_PLUGIN_USING_THREAD_POOL
+// Worker threads shared by all plugin instances in the process, created on first use
+ThreadPool* d_acquireSharedThreadPool();
+void        d_releaseSharedThreadPool();
+#endif
+
 // -----------------------------------------------------------------------
 // DSP callbacks
 
 typedef bool (*writeMidiFunc) (void* ptr, const MidiEvent& midiEvent);
 typedef bool (*requestParameterValueChangeFunc) (void* ptr, uint32_t index, float value);
 typedef bool (*updateStateValueFunc) (void* ptr, const char* key, const char* value);
+typedef bool (*runTasksFunc) (void* ptr, uint32_t count);
 
 // -----------------------------------------------------------------------
 // Helpers
@@ -137,6 +158,334 @@ void snprintf_u32(char* const dst, const uint32_t value, const size_t size)
     return snprintf_t<uint32_t>(dst, value, "%u", size);
 }
 
+// -----------------------------------------------------------------------
+// Parameter data used during processing, stored as contiguous arrays
+// built once after all parameters are initialized, and never modified afterwards
+
+struct ParameterTable {
+    uint32_t  count;
+    uint32_t* hints;
+    float*    mins;
+    float*    maxs;
+    float*    defs;
+
+    ParameterTable() noexcept
+        : count(0),
+          hints(nullptr),
+          mins(nullptr),
+          maxs(nullptr),
+          defs(nullptr) {}
+
+    ~ParameterTable() noexcept
+    {
+        delete[] hints;
+        delete[] mins;
+    }
+
+    void init(const Parameter* const parameters, const uint32_t parameterCount)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(count == 0,);
+
+        if (parameterCount == 0)
+            return;
+
+        count = parameterCount;
+        hints = new uint32_t[parameterCount];
+        mins  = new float[parameterCount * 3];
+        maxs  = mins + parameterCount;
+        defs  = maxs + parameterCount;
+
+        for (uint32_t i=0; i < parameterCount; ++i)
+        {
+            hints[i] = parameters[i].hints;
+            mins[i]  = parameters[i].ranges.min;
+            maxs[i]  = parameters[i].ranges.max;
+            defs[i]  = parameters[i].ranges.def;
+        }
+    }
+
+    // same as ParameterRanges::getFixedAndNormalizedValue
+    double getNormalizedValue(const uint32_t index, const double value) const noexcept
+    {
+        const double min = mins[index];
+        const double max = maxs[index];
+
+        if (value <= min)
+            return 0.0;
+        if (value >= max)
+            return 1.0;
+
+        const double normValue = (value - min) / (max - min);
+
+        if (normValue <= 0.0)
+            return 0.0;
+        if (normValue >= 1.0)
+            return 1.0;
+
+        return normValue;
+    }
+
+    // same as ParameterRanges::getUnnormalizedValue
+    double getUnnormalizedValue(const uint32_t index, const double value) const noexcept
+    {
+        const double min = mins[index];
+        const double max = maxs[index];
+
+        if (value <= 0.0)
+            return min;
+        if (value >= 1.0)
+            return max;
+
+        return value * (max - min) + min;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(ParameterTable)
+};
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+// -----------------------------------------------------------------------
+// Rebuffering data for plugins that process audio in fixed-size blocks
+
+struct FixedBlockData {
+    // amount of frames buffered for the next block
+    uint32_t position;
+
+   #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    float* buffer;
+   #endif
+   #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+    float* inputs[DISTRHO_PLUGIN_NUM_INPUTS];
+   #endif
+   #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    float* outputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    uint32_t  midiEventCount;
+    MidiEvent midiEvents[kMaxMidiEvents];
+   #endif
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+    // host frame at which the output of the block being processed starts
+    uint32_t  midiOutputOffset;
+    uint32_t  hostFrames;
+    uint32_t  pendingMidiOutputCount;
+    MidiEvent pendingMidiOutput[kMaxMidiEvents];
+   #endif
+
+    FixedBlockData()
+        : position(0)
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        buffer = new float[DISTRHO_PLUGIN_FIXED_BLOCK_SIZE * (DISTRHO_PLUGIN_NUM_INPUTS + DISTRHO_PLUGIN_NUM_OUTPUTS)];
+       #endif
+       #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+            inputs[i] = buffer + DISTRHO_PLUGIN_FIXED_BLOCK_SIZE * i;
+       #endif
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            outputs[i] = buffer + DISTRHO_PLUGIN_FIXED_BLOCK_SIZE * (DISTRHO_PLUGIN_NUM_INPUTS + i);
+       #endif
+
+        reset();
+    }
+
+    ~FixedBlockData()
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        delete[] buffer;
+       #endif
+    }
+
+    void reset() noexcept
+    {
+        position = 0;
+       #if DISTRHO_PLUGIN_NUM_INPUTS+DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        std::memset(buffer, 0, sizeof(float) * DISTRHO_PLUGIN_FIXED_BLOCK_SIZE
+                                              * (DISTRHO_PLUGIN_NUM_INPUTS + DISTRHO_PLUGIN_NUM_OUTPUTS));
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        midiEventCount = 0;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+        midiOutputOffset = 0;
+        hostFrames = 0;
+        pendingMidiOutputCount = 0;
+       #endif
+    }
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    // copy host events within [offset, offset + frames) into the next block, starting at its @a position
+    void appendMidiEvents(const MidiEvent* const events, const uint32_t count, uint32_t& index,
+                          const uint32_t offset, const uint32_t frames) noexcept
+    {
+        for (; index < count && events[index].frame < offset + frames; ++index)
+        {
+            if (midiEventCount == kMaxMidiEvents)
+                continue;
+
+            MidiEvent& event(midiEvents[midiEventCount++]);
+            std::memcpy(&event, &events[index], sizeof(MidiEvent));
+            event.frame = event.frame - offset + position;
+        }
+    }
+   #endif
+
+    DISTRHO_DECLARE_NON_COPYABLE(FixedBlockData)
+};
+#endif
+
+// -----------------------------------------------------------------------
+// Parameter changes done outside of the audio thread (typically from the UI), applied by the audio thread.
+// Changes are timestamped with a monotonic clock when written, and placed at the matching frame offset of the
+// block processed right after them, so that their relative timing is kept (delayed by one block).
+// Repeated changes to the same parameter are coalesced, the queue never holds more than one entry per parameter.
+// Only one thread may write changes, and only one thread may read them.
+
+struct ParameterEdit {
+    uint32_t index;
+    uint32_t frame;
+    float value;
+};
+
+class ParameterEditQueue
+{
+public:
+    ParameterEditQueue() noexcept
+        : fCount(0),
+          fValues(nullptr),
+          fTimes(nullptr),
+          fPending(nullptr),
+          fFifo(nullptr),
+          fEdits(nullptr),
+          fWritePos(0),
+          fReadPos(0) {}
+
+    ~ParameterEditQueue() noexcept
+    {
+        delete[] fValues;
+        delete[] fTimes;
+        delete[] fPending;
+        delete[] fFifo;
+        delete[] fEdits;
+    }
+
+    void init(const uint32_t parameterCount)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fCount == 0,);
+
+        if (parameterCount == 0)
+            return;
+
+        fCount   = parameterCount;
+        fValues  = new float[parameterCount];
+        fTimes   = new int64_t[parameterCount];
+        fPending = new bool[parameterCount];
+        fFifo    = new uint32_t[parameterCount];
+        fEdits   = new ParameterEdit[parameterCount];
+
+        std::memset(fPending, 0, sizeof(bool) * parameterCount);
+    }
+
+    // -------------------------------------------------------------------
+    // writer side
+
+    void write(const uint32_t index, const float value) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < fCount, index, fCount,);
+
+        // sequentially consistent, pairs with the reader clearing the pending flag before reading the value
+        __atomic_store(&fValues[index], &value, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&fPending[index], __ATOMIC_SEQ_CST))
+            return;
+
+        // first change since the reader picked up this parameter, the timestamp of later changes is ignored
+        fTimes[index] = getCurrentTime();
+        __atomic_store_n(&fPending[index], true, __ATOMIC_RELEASE);
+
+        const uint32_t writePos = __atomic_load_n(&fWritePos, __ATOMIC_RELAXED);
+        fFifo[writePos % fCount] = index;
+        __atomic_store_n(&fWritePos, writePos + 1, __ATOMIC_RELEASE);
+    }
+
+    // get the value of a parameter change not yet picked up by the reader, if any
+    bool getPendingValue(const uint32_t index, float& value) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < fCount, index, fCount, false);
+
+        if (! __atomic_load_n(&fPending[index], __ATOMIC_ACQUIRE))
+            return false;
+
+        __atomic_load(&fValues[index], &value, __ATOMIC_ACQUIRE);
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // reader side
+
+    // get all changes written since the previous call, sorted by frame offset within a block of @a frames
+    // returns the number of changes, stored in @a edits until the next call
+    uint32_t read(const uint32_t frames, const double sampleRate, const ParameterEdit*& edits) noexcept
+    {
+        const uint32_t writePos = __atomic_load_n(&fWritePos, __ATOMIC_ACQUIRE);
+        uint32_t readPos = fReadPos;
+
+        if (readPos == writePos)
+            return 0;
+
+        // changes made during the previous block period are mapped into this block
+        const int64_t blockStartTime = getCurrentTime() - static_cast<int64_t>(frames * 1e9 / sampleRate + 0.5);
+        const double framesPerNanosecond = sampleRate * 1e-9;
+        uint32_t count = 0;
+
+        for (; readPos != writePos; ++readPos)
+        {
+            const uint32_t index = fFifo[readPos % fCount];
+            const int64_t time = fTimes[index];
+
+            // release the fifo slot before the parameter, so that the writer can always queue it again
+            __atomic_store_n(&fReadPos, readPos + 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&fPending[index], false, __ATOMIC_SEQ_CST);
+
+            ParameterEdit& edit(fEdits[count++]);
+            edit.index = index;
+            __atomic_load(&fValues[index], &edit.value, __ATOMIC_SEQ_CST);
+
+            if (time <= blockStartTime || frames == 0)
+                edit.frame = 0;
+            else
+                edit.frame = std::min<uint32_t>(frames - 1, static_cast<uint32_t>((time - blockStartTime) * framesPerNanosecond));
+
+            // timestamps come from a single writer, but keep the order in case of clock adjustments
+            if (count > 1 && edit.frame < fEdits[count - 2].frame)
+                edit.frame = fEdits[count - 2].frame;
+        }
+
+        edits = fEdits;
+        return count;
+    }
+
+private:
+    uint32_t fCount;
+    float* fValues;
+    int64_t* fTimes;
+    bool* fPending;
+    uint32_t* fFifo;
+    ParameterEdit* fEdits;
+    uint32_t fWritePos;
+    uint32_t fReadPos;
+
+    static int64_t getCurrentTime() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(ParameterEditQueue)
+};
+
 // -----------------------------------------------------------------------
 // Plugin private data
 
@@ -153,6 +502,7 @@ struct Plugin::PrivateData {
     uint32_t   parameterCount;
     uint32_t   parameterOffset;
     Parameter* parameters;
+    ParameterTable parameterTable;
 
     uint32_t         portGroupCount;
     PortGroupWithId* portGroups;
@@ -175,11 +525,27 @@ struct Plugin::PrivateData {
     TimePosition timePosition;
 #endif
 
+#ifdef DPF_PLUGIN_USING_THREAD_POOL
+    ThreadPool* threadPool;
+#endif
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+    FixedBlockData fixedBlock;
+#endif
+
+#ifdef DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS
+    float*   separateInputBuffer;
+    uint32_t separateInputBufferSize;
+#endif
+
     // Callbacks
     void*         callbacksPtr;
     writeMidiFunc writeMidiCallbackFunc;
     requestParameterValueChangeFunc requestParameterValueChangeCallbackFunc;
     updateStateValueFunc updateStateValueCallbackFunc;
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+    runTasksFunc runTasksCallbackFunc;
+#endif
 
     uint32_t bufferSize;
     double   sampleRate;
@@ -208,11 +574,21 @@ struct Plugin::PrivateData {
 #endif
 #if DISTRHO_PLUGIN_WANT_LATENCY
           latency(0),
+#endif
+#ifdef DPF_PLUGIN_USING_THREAD_POOL
+          threadPool(nullptr),
+#endif
+#ifdef DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS
+          separateInputBuffer(nullptr),
+          separateInputBufferSize(0),
 #endif
           callbacksPtr(nullptr),
           writeMidiCallbackFunc(nullptr),
           requestParameterValueChangeCallbackFunc(nullptr),
           updateStateValueCallbackFunc(nullptr),
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+          runTasksCallbackFunc(nullptr),
+#endif
           bufferSize(d_nextBufferSize),
           sampleRate(d_nextSampleRate),
           bundlePath(d_nextBundlePath != nullptr ? strdup(d_nextBundlePath) : nullptr)
@@ -279,6 +655,22 @@ struct Plugin::PrivateData {
         }
 #endif
 
+#ifdef DPF_PLUGIN_USING_THREAD_POOL
+        if (threadPool != nullptr)
+        {
+            d_releaseSharedThreadPool();
+            threadPool = nullptr;
+        }
+#endif
+
+#ifdef DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS
+        if (separateInputBuffer != nullptr)
+        {
+            delete[] separateInputBuffer;
+            separateInputBuffer = nullptr;
+        }
+#endif
+
         if (bundlePath != nullptr)
         {
             std::free(bundlePath);
@@ -289,8 +681,32 @@ struct Plugin::PrivateData {
 #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
     bool writeMidiCallback(const MidiEvent& midiEvent)
     {
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        // move event from block to host time, keeping the ones past the current host buffer for later
+        MidiEvent event;
+        std::memcpy(&event, &midiEvent, sizeof(MidiEvent));
+        event.frame += fixedBlock.midiOutputOffset;
+
+        if (event.frame >= fixedBlock.hostFrames)
+        {
+            // external data might not be valid anymore by the next host buffer, send it now
+            if (event.size > MidiEvent::kDataSize || fixedBlock.pendingMidiOutputCount == kMaxMidiEvents)
+            {
+                event.frame = fixedBlock.hostFrames - 1;
+            }
+            else
+            {
+                std::memcpy(&fixedBlock.pendingMidiOutput[fixedBlock.pendingMidiOutputCount++], &event, sizeof(MidiEvent));
+                return true;
+            }
+        }
+
+        if (writeMidiCallbackFunc != nullptr)
+            return writeMidiCallbackFunc(callbacksPtr, event);
+       #else
         if (writeMidiCallbackFunc != nullptr)
             return writeMidiCallbackFunc(callbacksPtr, midiEvent);
+       #endif
 
         return false;
     }
@@ -316,6 +732,21 @@ struct Plugin::PrivateData {
         return false;
     }
 #endif
+
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+    bool runTasksCallback(const uint32_t count)
+    {
+        if (runTasksCallbackFunc != nullptr)
+            return runTasksCallbackFunc(callbacksPtr, count);
+
+        return false;
+    }
+
+    static void runTaskFromThreadPool(void* const ptr, const uint32_t taskIndex)
+    {
+        static_cast<Plugin*>(ptr)->runTask(taskIndex);
+    }
+#endif
 };
 
 // -----------------------------------------------------------------------
@@ -426,6 +857,8 @@ public:
         for (uint32_t i=0, count=fData->parameterCount; i < count; ++i)
             fPlugin->initParameter(i, fData->parameters[i]);
 
+        fData->parameterTable.init(fData->parameters, fData->parameterCount);
+
         {
             std::set<uint32_t> portGroupIndices;
 
@@ -548,7 +981,11 @@ public:
     {
         DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
 
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        return fData->latency + DISTRHO_PLUGIN_FIXED_BLOCK_SIZE;
+       #else
         return fData->latency;
+       #endif
     }
 #endif
 
@@ -625,9 +1062,9 @@ public:
 
     uint32_t getParameterHints(const uint32_t index) const noexcept
     {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0x0);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterTable.count, 0x0);
 
-        return fData->parameters[index].hints;
+        return fData->parameterTable.hints[index];
     }
 
     ParameterDesignation getParameterDesignation(const uint32_t index) const noexcept
@@ -735,9 +1172,37 @@ public:
     float getParameterDefault(const uint32_t index) const
     {
         DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr, 0.0f);
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterCount, 0.0f);
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterTable.count, 0.0f);
+
+        return fData->parameterTable.defs[index];
+    }
+
+    float getParameterMinimum(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterTable.count, 0.0f);
+
+        return fData->parameterTable.mins[index];
+    }
+
+    float getParameterMaximum(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterTable.count, 1.0f);
+
+        return fData->parameterTable.maxs[index];
+    }
+
+    double getNormalizedParameterValue(const uint32_t index, const double value) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterTable.count, 0.0);
+
+        return fData->parameterTable.getNormalizedValue(index, value);
+    }
+
+    double getUnnormalizedParameterValue(const uint32_t index, const double normalized) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr && index < fData->parameterTable.count, 0.0);
 
-        return fData->parameters[index].ranges.def;
+        return fData->parameterTable.getUnnormalizedValue(index, normalized);
     }
 
     float getParameterValue(const uint32_t index) const
@@ -756,24 +1221,6 @@ public:
         fPlugin->setParameterValue(index, value);
     }
 
-    /*
-    bool getParameterIndexForSymbol(const char* const symbol, uint32_t& index)
-    {
-        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
-
-        for (uint32_t i=0; i < fData->parameterCount; ++i)
-        {
-            if (fData->parameters[i].symbol == symbol)
-            {
-                index = i;
-                return true;
-            }
-        }
-
-        return false;
-    }
-    */
-
     uint32_t getPortGroupCount() const noexcept
     {
         DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, 0);
@@ -929,6 +1376,23 @@ public:
     }
 #endif
 
+#if DISTRHO_PLUGIN_WANT_THREAD_POOL
+    // must be called before activation
+    void setRunTasksCallback(const runTasksFunc runTasksCall) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        fData->runTasksCallbackFunc = runTasksCall;
+    }
+
+    void runTask(const uint32_t taskIndex)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
+
+        fPlugin->runTask(taskIndex);
+    }
+#endif
+
     // -------------------------------------------------------------------
 
     bool isActive() const noexcept
@@ -941,6 +1405,12 @@ public:
         DISTRHO_SAFE_ASSERT_RETURN(fPlugin != nullptr,);
         DISTRHO_SAFE_ASSERT_RETURN(! fIsActive,);
 
+        initThreadPoolIfNeeded();
+        initSeparateBuffersIfNeeded();
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        fData->fixedBlock.reset();
+       #endif
+
         fIsActive = true;
         fPlugin->activate();
     }
@@ -974,12 +1444,23 @@ public:
 
         if (! fIsActive)
         {
+            initThreadPoolIfNeeded();
+            initSeparateBuffersIfNeeded();
+           #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+            fData->fixedBlock.reset();
+           #endif
             fIsActive = true;
             fPlugin->activate();
         }
 
         fData->isProcessing = true;
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        runInFixedBlocks(inputs, outputs, frames, midiEvents, midiEventCount);
+       #elif defined(DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS)
+        fPlugin->run(getSeparateInputs(inputs, outputs, frames), outputs, frames, midiEvents, midiEventCount);
+       #else
         fPlugin->run(inputs, outputs, frames, midiEvents, midiEventCount);
+       #endif
         fData->isProcessing = false;
     }
    #else
@@ -990,16 +1471,98 @@ public:
 
         if (! fIsActive)
         {
+            initThreadPoolIfNeeded();
+            initSeparateBuffersIfNeeded();
+           #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+            fData->fixedBlock.reset();
+           #endif
             fIsActive = true;
             fPlugin->activate();
         }
 
         fData->isProcessing = true;
+       #if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+        runInFixedBlocks(inputs, outputs, frames, nullptr, 0);
+       #elif defined(DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS)
+        fPlugin->run(getSeparateInputs(inputs, outputs, frames), outputs, frames);
+       #else
         fPlugin->run(inputs, outputs, frames);
+       #endif
         fData->isProcessing = false;
     }
    #endif
 
+    // run split into sub-blocks at the frame offsets of parameter changes, which are applied in between
+    // the changes must be sorted by frame, MIDI event frames are rebased in-place to their sub-block
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    void run(const float** const inputs, float** const outputs, const uint32_t frames,
+             MidiEvent* const midiEvents, const uint32_t midiEventCount,
+             const ParameterEdit* const edits, const uint32_t editCount)
+   #else
+    void run(const float** const inputs, float** const outputs, const uint32_t frames,
+             const ParameterEdit* const edits, const uint32_t editCount)
+   #endif
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+        const float* subInputs[DISTRHO_PLUGIN_NUM_INPUTS];
+       #else
+        const float** const subInputs = inputs;
+       #endif
+       #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        float* subOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+       #else
+        float** const subOutputs = outputs;
+       #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        uint32_t midiIndex = 0;
+       #endif
+
+        for (uint32_t i = 0, offset = 0;;)
+        {
+            // apply all changes due at the current offset, or all remaining ones once the block is done
+            for (; i < editCount && (edits[i].frame <= offset || offset == frames); ++i)
+                setParameterValue(edits[i].index, edits[i].value);
+
+            const uint32_t end = i < editCount ? std::min(edits[i].frame, frames) : frames;
+
+            if (end > offset)
+            {
+               #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+                for (uint32_t j=0; j < DISTRHO_PLUGIN_NUM_INPUTS; ++j)
+                    subInputs[j] = inputs[j] != nullptr ? inputs[j] + offset : nullptr;
+               #endif
+               #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+                for (uint32_t j=0; j < DISTRHO_PLUGIN_NUM_OUTPUTS; ++j)
+                    subOutputs[j] = outputs[j] != nullptr ? outputs[j] + offset : nullptr;
+               #endif
+
+               #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                uint32_t midiCount = 0;
+
+                for (; midiIndex + midiCount < midiEventCount; ++midiCount)
+                {
+                    MidiEvent& event(midiEvents[midiIndex + midiCount]);
+
+                    if (end != frames && event.frame >= end)
+                        break;
+
+                    event.frame = event.frame > offset ? event.frame - offset : 0;
+                }
+
+                run(subInputs, subOutputs, end - offset, midiEvents + midiIndex, midiCount);
+                midiIndex += midiCount;
+               #else
+                run(subInputs, subOutputs, end - offset);
+               #endif
+
+                offset = end;
+            }
+
+            if (i == editCount)
+                break;
+        }
+    }
+
     // -------------------------------------------------------------------
 
    #ifdef DISTRHO_PLUGIN_TARGET_AU
@@ -1039,7 +1602,15 @@ public:
 
         fData->bufferSize = bufferSize;
 
-        if (doCallback)
+        // buffers sized to the previous buffer size are otherwise only resized on next activation
+        if (fIsActive)
+        {
+            initThreadPoolIfNeeded();
+            initSeparateBuffersIfNeeded();
+        }
+
+        // plugins using fixed block size processing never see a buffer size change
+        if (doCallback && DISTRHO_PLUGIN_FIXED_BLOCK_SIZE == 0)
         {
             if (fIsActive) fPlugin->deactivate();
             fPlugin->bufferSizeChanged(bufferSize);
@@ -1076,6 +1647,253 @@ private:
     Plugin::PrivateData* const fData;
     bool fIsActive;
 
+    // -------------------------------------------------------------------
+    // DPF-owned worker threads, only created if the host does not provide its own thread pool
+
+    void initThreadPoolIfNeeded()
+    {
+       #ifdef DPF_PLUGIN_USING_THREAD_POOL
+        if (fData->threadPool != nullptr || fData->runTasksCallbackFunc != nullptr || fData->isDummy)
+            return;
+
+        fData->threadPool = d_acquireSharedThreadPool();
+       #endif
+    }
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0
+    // -------------------------------------------------------------------
+    // Fixed block size processing
+
+    void runInFixedBlocks(const float** const inputs, float** const outputs, const uint32_t frames,
+                          const MidiEvent* const midiEvents, const uint32_t midiEventCount)
+    {
+        static constexpr const uint32_t kBlockSize = DISTRHO_PLUGIN_FIXED_BLOCK_SIZE;
+
+        if (frames == 0)
+            return;
+
+        FixedBlockData& fb(fData->fixedBlock);
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+        flushPendingMidiOutput(frames);
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        uint32_t midiEventIndex = 0;
+       #else
+        // unused
+        (void)midiEvents;
+        (void)midiEventCount;
+       #endif
+
+        if (fb.position == 0 && frames % kBlockSize == 0 && ! buffersOverlap(inputs, outputs, frames))
+        {
+            // zero-copy, each block writes directly to host buffers right after the output of the previous one
+           #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            const float* blockInputs[DISTRHO_PLUGIN_NUM_INPUTS];
+           #else
+            const float** const blockInputs = nullptr;
+           #endif
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            float* blockOutputs[DISTRHO_PLUGIN_NUM_OUTPUTS];
+
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+                std::memcpy(outputs[i], fb.outputs[i], sizeof(float) * kBlockSize);
+           #else
+            float** const blockOutputs = nullptr;
+           #endif
+
+            for (uint32_t offset = 0; offset < frames; offset += kBlockSize)
+            {
+               #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+                for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+                    blockInputs[i] = inputs[i] + offset;
+               #endif
+               #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+                for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+                    blockOutputs[i] = offset + kBlockSize < frames ? outputs[i] + offset + kBlockSize : fb.outputs[i];
+               #endif
+               #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                fb.appendMidiEvents(midiEvents, midiEventCount, midiEventIndex, offset, kBlockSize);
+               #endif
+
+                runFixedBlock(blockInputs, blockOutputs, offset + kBlockSize);
+            }
+
+            return;
+        }
+
+        // buffered, audio output is read from the previous block while input is collected for the next one
+        for (uint32_t offset = 0; offset < frames;)
+        {
+            const uint32_t count = std::min(kBlockSize - fb.position, frames - offset);
+
+           #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+                std::memcpy(fb.inputs[i] + fb.position, inputs[i] + offset, sizeof(float) * count);
+           #endif
+           #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+                std::memcpy(outputs[i] + offset, fb.outputs[i] + fb.position, sizeof(float) * count);
+           #endif
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            fb.appendMidiEvents(midiEvents, midiEventCount, midiEventIndex, offset, count);
+           #endif
+
+            fb.position += count;
+            offset += count;
+
+            if (fb.position == kBlockSize)
+            {
+               #if DISTRHO_PLUGIN_NUM_INPUTS > 0
+                runFixedBlock(const_cast<const float**>(fb.inputs),
+               #else
+                runFixedBlock(nullptr,
+               #endif
+               #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+                              fb.outputs,
+               #else
+                              nullptr,
+               #endif
+                              offset);
+                fb.position = 0;
+            }
+        }
+    }
+
+    void runFixedBlock(const float** const inputs, float** const outputs, const uint32_t outputOffset)
+    {
+        FixedBlockData& fb(fData->fixedBlock);
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+        fb.midiOutputOffset = outputOffset;
+       #else
+        // unused
+        (void)outputOffset;
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin->run(inputs, outputs, DISTRHO_PLUGIN_FIXED_BLOCK_SIZE, fb.midiEvents, fb.midiEventCount);
+        fb.midiEventCount = 0;
+       #else
+        fPlugin->run(inputs, outputs, DISTRHO_PLUGIN_FIXED_BLOCK_SIZE);
+        // unused
+        (void)fb;
+       #endif
+    }
+
+   #if DISTRHO_PLUGIN_WANT_MIDI_OUTPUT
+    // send events left from the previous host buffer that fall within this one, and move the others forward
+    void flushPendingMidiOutput(const uint32_t frames)
+    {
+        FixedBlockData& fb(fData->fixedBlock);
+
+        uint32_t kept = 0;
+
+        for (uint32_t i=0; i < fb.pendingMidiOutputCount; ++i)
+        {
+            MidiEvent& event(fb.pendingMidiOutput[i]);
+            event.frame -= fb.hostFrames;
+
+            if (event.frame < frames)
+            {
+                if (fData->writeMidiCallbackFunc != nullptr)
+                    fData->writeMidiCallbackFunc(fData->callbacksPtr, event);
+            }
+            else if (kept != i)
+            {
+                std::memcpy(&fb.pendingMidiOutput[kept++], &event, sizeof(MidiEvent));
+            }
+            else
+            {
+                ++kept;
+            }
+        }
+
+        fb.pendingMidiOutputCount = kept;
+        fb.hostFrames = frames;
+    }
+   #endif
+#endif
+
+#ifdef DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS
+    // -------------------------------------------------------------------
+    // Copies of host inputs, for plugins that cannot process in-place
+
+    void initSeparateBuffersIfNeeded()
+    {
+        if (fData->separateInputBufferSize >= fData->bufferSize || fData->isDummy)
+            return;
+
+        delete[] fData->separateInputBuffer;
+        fData->separateInputBuffer = new float[fData->bufferSize * DISTRHO_PLUGIN_NUM_INPUTS];
+        fData->separateInputBufferSize = fData->bufferSize;
+    }
+
+    // returns the host inputs as-is, unless they overlap with any output
+    const float** getSeparateInputs(const float** const inputs, float** const outputs, const uint32_t frames)
+    {
+        if (! buffersOverlap(inputs, outputs, frames))
+            return inputs;
+
+        DISTRHO_SAFE_ASSERT_UINT2_RETURN(frames <= fData->separateInputBufferSize,
+                                         frames, fData->separateInputBufferSize, inputs);
+
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+        {
+            float* const buffer = fData->separateInputBuffer + fData->separateInputBufferSize * i;
+
+            if (inputs[i] != nullptr)
+                std::memcpy(buffer, inputs[i], sizeof(float) * frames);
+            else
+                std::memset(buffer, 0, sizeof(float) * frames);
+
+            fSeparateInputs[i] = buffer;
+        }
+
+        return fSeparateInputs;
+    }
+
+    const float* fSeparateInputs[DISTRHO_PLUGIN_NUM_INPUTS];
+#else
+    void initSeparateBuffersIfNeeded() noexcept {}
+#endif
+
+#if DISTRHO_PLUGIN_FIXED_BLOCK_SIZE != 0 || defined(DPF_PLUGIN_NEEDS_SEPARATE_BUFFERS)
+    static bool buffersOverlap(const float* const* const inputs, const float* const* const outputs, const uint32_t frames) noexcept
+    {
+       #if DISTRHO_PLUGIN_NUM_INPUTS > 0 && DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+        {
+            if (inputs[i] == nullptr)
+                continue;
+
+            const uintptr_t inStart = reinterpret_cast<uintptr_t>(inputs[i]);
+            const uintptr_t inEnd = reinterpret_cast<uintptr_t>(inputs[i] + frames);
+
+            for (uint32_t j=0; j < DISTRHO_PLUGIN_NUM_OUTPUTS; ++j)
+            {
+                if (outputs[j] == nullptr)
+                    continue;
+
+                const uintptr_t outStart = reinterpret_cast<uintptr_t>(outputs[j]);
+                const uintptr_t outEnd = reinterpret_cast<uintptr_t>(outputs[j] + frames);
+
+                if (inStart < outEnd && outStart < inEnd)
+                    return true;
+            }
+        }
+       #else
+        // unused
+        (void)inputs;
+        (void)outputs;
+        (void)frames;
+       #endif
+
+        return false;
+    }
+#endif
+
     // -------------------------------------------------------------------
     // Static fallback data, see DistrhoPlugin.cpp
 
@@ -1088,6 +1906,363 @@ private:
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginExporter)
 };
 
+// -----------------------------------------------------------------------
+// MIDI CC to parameter routing, for wrappers that receive raw MIDI control changes.
+// Bindings start from each parameter's midiCC (on the 1st MIDI channel) and can be changed at runtime,
+// including through MIDI learn. The routing table is rebuilt on the non-realtime side whenever bindings change,
+// published as pending and adopted by the realtime side at the start of its next processing block.
+// Neither side ever waits on the other, replaced tables are handed back to the non-realtime side for freeing.
+// Wrappers apply bound CC values once per processing block, the last value received wins.
+
+class MidiControlMap
+{
+    struct Table;
+
+public:
+    static const uint8_t kNone = 0xff;
+
+    MidiControlMap() noexcept
+        : fCount(0),
+          fChannels(nullptr),
+          fControls(nullptr),
+          fDefaultChannels(nullptr),
+          fDefaultControls(nullptr),
+          fTable(nullptr),
+          fPendingTable(nullptr),
+          fRetiredTable(nullptr),
+          fLearnIndex(-1),
+          fLearnedIndex(0),
+          fLearnedChannel(0),
+          fLearnedControl(0),
+          fHasLearned(false) {}
+
+    ~MidiControlMap() noexcept
+    {
+        delete fTable;
+        delete fPendingTable;
+        delete fRetiredTable;
+        delete[] fChannels;
+    }
+
+    // set up default bindings from the plugin parameters, must be called before processing starts
+    void init(const PluginExporter& plugin)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fCount == 0,);
+
+        fCount = plugin.getParameterCount();
+
+        if (fCount == 0)
+            return;
+
+        fChannels = new uint8_t[fCount * 4];
+        fControls = fChannels + fCount;
+        fDefaultChannels = fControls + fCount;
+        fDefaultControls = fDefaultChannels + fCount;
+
+        for (uint32_t i=0; i < fCount; ++i)
+        {
+            const uint8_t midiCC = plugin.getParameterMidiCC(i);
+
+            // same rules as Parameter::midiCC, 0, 32 (bank change) and anything higher than 120 are invalid
+            if (plugin.isParameterInput(i) && midiCC != 0 && midiCC != 32 && midiCC <= 120)
+            {
+                fDefaultChannels[i] = 0;
+                fDefaultControls[i] = midiCC;
+            }
+            else
+            {
+                fDefaultChannels[i] = fDefaultControls[i] = kNone;
+            }
+        }
+
+        std::memcpy(fChannels, fDefaultChannels, fCount * 2);
+        rebuild();
+    }
+
+    // bind a parameter to a MIDI channel and CC, replacing its previous binding
+    void setParameterControl(const uint32_t index, const uint8_t channel, const uint8_t control)
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(index < fCount, index,);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(channel < 16, channel,);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(control < 128, control,);
+
+        if (fChannels[index] == channel && fControls[index] == control)
+            return;
+
+        fChannels[index] = channel;
+        fControls[index] = control;
+        rebuild();
+    }
+
+    // remove the MIDI binding of a parameter
+    void clearParameterControl(const uint32_t index)
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(index < fCount, index,);
+
+        if (fControls[index] == kNone)
+            return;
+
+        fChannels[index] = fControls[index] = kNone;
+        rebuild();
+    }
+
+    // get the MIDI binding of a parameter, returns false if not bound
+    bool getParameterControl(const uint32_t index, uint8_t& channel, uint8_t& control) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(index < fCount, index, false);
+
+        if (fControls[index] == kNone)
+            return false;
+
+        channel = fChannels[index];
+        control = fControls[index];
+        return true;
+    }
+
+    // go back to the bindings set by the parameter midiCC hints
+    void resetParameterControls()
+    {
+        if (fCount == 0 || std::memcmp(fChannels, fDefaultChannels, fCount * 2) == 0)
+            return;
+
+        std::memcpy(fChannels, fDefaultChannels, fCount * 2);
+        rebuild();
+    }
+
+    // -------------------------------------------------------------------
+    // bindings as text, for saving in plugin state
+
+    // whether the binding of a parameter differs from its midiCC hint, only those need to be saved
+    bool isParameterControlModified(const uint32_t index) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(index < fCount, index, false);
+
+        return fChannels[index] != fDefaultChannels[index] || fControls[index] != fDefaultControls[index];
+    }
+
+    // "none" if not bound, otherwise "<channel>:<control>" with channel starting at 1
+    String getParameterControlText(const uint32_t index) const
+    {
+        uint8_t channel, control;
+
+        if (! getParameterControl(index, channel, control))
+            return String("none");
+
+        char text[8];
+        std::snprintf(text, sizeof(text), "%u:%u", channel + 1u, static_cast<uint>(control));
+        return String(text);
+    }
+
+    // opposite of getParameterControlText, returns false if the text is not valid
+    bool setParameterControlFromText(const uint32_t index, const char* const text)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(text != nullptr, false);
+
+        if (std::strcmp(text, "none") == 0)
+        {
+            clearParameterControl(index);
+            return true;
+        }
+
+        uint channel, control;
+        DISTRHO_SAFE_ASSERT_RETURN(std::sscanf(text, "%u:%u", &channel, &control) == 2, false);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(channel >= 1 && channel <= 16, channel, false);
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(control < 128, control, false);
+
+        setParameterControl(index, static_cast<uint8_t>(channel - 1), static_cast<uint8_t>(control));
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // MIDI learn
+
+    // bind a parameter to the next CC received by the realtime side
+    void startLearning(const uint32_t index) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_UINT_RETURN(index < fCount, index,);
+
+        __atomic_store_n(&fLearnIndex, static_cast<int32_t>(index), __ATOMIC_RELEASE);
+    }
+
+    void cancelLearning() noexcept
+    {
+        __atomic_store_n(&fLearnIndex, -1, __ATOMIC_RELEASE);
+    }
+
+    // apply pending MIDI learn results and free old routing tables, must be called regularly on the non-realtime side
+    // returns true if a parameter binding changed through MIDI learn, with its index stored in @a learnedIndex
+    bool idle(uint32_t* const learnedIndex = nullptr)
+    {
+        bool learned = false;
+
+        if (__atomic_load_n(&fHasLearned, __ATOMIC_ACQUIRE))
+        {
+            const uint32_t index = fLearnedIndex;
+            __atomic_store_n(&fHasLearned, false, __ATOMIC_RELEASE);
+
+            setParameterControl(index, fLearnedChannel, fLearnedControl);
+
+            if (learnedIndex != nullptr)
+                *learnedIndex = index;
+
+            learned = true;
+        }
+
+        freeRetiredTable();
+        return learned;
+    }
+
+    // -------------------------------------------------------------------
+    // realtime side
+
+    // complete a pending MIDI learn with the received CC, if any
+    void learnControl(const uint8_t channel, const uint8_t control) noexcept
+    {
+        if (__atomic_load_n(&fLearnIndex, __ATOMIC_RELAXED) < 0)
+            return;
+
+        // non-realtime side has not picked up the previous result yet
+        if (__atomic_load_n(&fHasLearned, __ATOMIC_ACQUIRE))
+            return;
+
+        const int32_t index = __atomic_exchange_n(&fLearnIndex, -1, __ATOMIC_ACQ_REL);
+
+        if (index < 0)
+            return;
+
+        fLearnedIndex = static_cast<uint32_t>(index);
+        fLearnedChannel = channel;
+        fLearnedControl = control;
+        __atomic_store_n(&fHasLearned, true, __ATOMIC_RELEASE);
+    }
+
+    // access to the current routing table, to be kept for the duration of one processing block
+    // only one realtime thread may use this at a time
+    class ScopedReader
+    {
+    public:
+        ScopedReader(MidiControlMap& map) noexcept
+            : fTable(map.adoptPendingTable()) {}
+
+        // get the parameters bound to a MIDI channel and CC, returns their count
+        uint32_t getParameters(const uint8_t channel, const uint8_t control, const uint32_t*& indices) const noexcept
+        {
+            if (fTable == nullptr || channel >= 16 || control >= 128)
+                return 0;
+
+            const uint32_t slot = channel * 128u + control;
+            indices = fTable->indices + fTable->offsets[slot];
+            return fTable->offsets[slot + 1] - fTable->offsets[slot];
+        }
+
+    private:
+        const Table* const fTable;
+
+        DISTRHO_DECLARE_NON_COPYABLE(ScopedReader)
+    };
+
+private:
+    // parameter indices grouped by MIDI channel and CC
+    struct Table {
+        uint32_t offsets[16 * 128 + 1];
+        uint32_t* indices;
+
+        Table(const uint32_t count)
+            : indices(count != 0 ? new uint32_t[count] : nullptr) {}
+
+        ~Table() noexcept
+        {
+            delete[] indices;
+        }
+
+        DISTRHO_DECLARE_NON_COPYABLE(Table)
+    };
+
+    uint32_t fCount;
+    uint8_t* fChannels;
+    uint8_t* fControls;
+    uint8_t* fDefaultChannels;
+    uint8_t* fDefaultControls;
+
+    // table in use, only touched by the realtime side once processing started
+    Table* fTable;
+    // newest table, set by the non-realtime side and taken by the realtime side
+    Table* fPendingTable;
+    // table replaced by the realtime side, to be freed by the non-realtime side
+    Table* fRetiredTable;
+
+    int32_t fLearnIndex;
+    uint32_t fLearnedIndex;
+    uint8_t fLearnedChannel;
+    uint8_t fLearnedControl;
+    bool fHasLearned;
+
+    void rebuild()
+    {
+        uint32_t numBound = 0;
+        for (uint32_t i=0; i < fCount; ++i)
+        {
+            if (fControls[i] != kNone)
+                ++numBound;
+        }
+
+        Table* const table = new Table(numBound);
+        std::memset(table->offsets, 0, sizeof(table->offsets));
+
+        // count parameters per slot, then turn counts into offsets
+        for (uint32_t i=0; i < fCount; ++i)
+        {
+            if (fControls[i] != kNone)
+                ++table->offsets[fChannels[i] * 128u + fControls[i] + 1];
+        }
+
+        for (uint32_t s=0; s < 16 * 128; ++s)
+            table->offsets[s + 1] += table->offsets[s];
+
+        uint32_t fill[16 * 128];
+        std::memcpy(fill, table->offsets, sizeof(fill));
+
+        for (uint32_t i=0; i < fCount; ++i)
+        {
+            if (fControls[i] != kNone)
+                table->indices[fill[fChannels[i] * 128u + fControls[i]]++] = i;
+        }
+
+        // make room for the realtime side to hand back the table it replaces
+        freeRetiredTable();
+
+        // a previous pending table that the realtime side did not take yet is simply replaced
+        delete __atomic_exchange_n(&fPendingTable, table, __ATOMIC_ACQ_REL);
+    }
+
+    void freeRetiredTable() noexcept
+    {
+        if (Table* const table = __atomic_load_n(&fRetiredTable, __ATOMIC_ACQUIRE))
+        {
+            delete table;
+            __atomic_store_n(&fRetiredTable, static_cast<Table*>(nullptr), __ATOMIC_RELEASE);
+        }
+    }
+
+    // called by the realtime side, switches to the pending table if the retired slot is free to receive the old one
+    const Table* adoptPendingTable() noexcept
+    {
+        if (__atomic_load_n(&fRetiredTable, __ATOMIC_ACQUIRE) == nullptr)
+        {
+            if (Table* const table = __atomic_exchange_n(&fPendingTable, static_cast<Table*>(nullptr), __ATOMIC_ACQ_REL))
+            {
+                Table* const oldTable = fTable;
+                fTable = table;
+                __atomic_store_n(&fRetiredTable, oldTable, __ATOMIC_RELEASE);
+            }
+        }
+
+        return fTable;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(MidiControlMap)
+};
+
 // -----------------------------------------------------------------------
 
 END_NAMESPACE_DISTRHO
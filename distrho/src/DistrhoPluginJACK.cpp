@@ -16,7 +16,7 @@
 
 #include "DistrhoPluginInternal.hpp"
 
-#ifndef STATIC_BUILD
+#if ! defined(STATIC_BUILD) || DISTRHO_PLUGIN_WANT_TIMEPOS
 # include "../DistrhoPluginUtils.hpp"
 #endif
 
@@ -208,6 +208,7 @@ public:
 #if DISTRHO_PLUGIN_HAS_UI
             fParametersChanged = new bool[count];
             std::memset(fParametersChanged, 0, sizeof(bool)*count);
+            fParameterEdits.init(count);
 #endif
 
             for (uint32_t i=0; i < count; ++i)
@@ -226,6 +227,11 @@ public:
 #endif
         }
 
+        fMidiControlMap.init(fPlugin);
+#if DISTRHO_PLUGIN_HAS_UI && DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fUI.setMidiLearnCallback(midiLearnCallback);
+#endif
+
         jackbridge_set_thread_init_callback(fClient, jackThreadInitCallback, this);
         jackbridge_set_buffer_size_callback(fClient, jackBufferSizeCallback, this);
         jackbridge_set_sample_rate_callback(fClient, jackSampleRateCallback, this);
@@ -253,7 +259,10 @@ public:
         fUI.exec(this);
        #else
         while (! gCloseSignalReceived)
+        {
+            fMidiControlMap.idle();
             d_sleep(1);
+        }
 
         // unused
         (void)winId;
@@ -320,6 +329,8 @@ protected:
         if (gCloseSignalReceived)
             return fUI.quit();
 
+        fMidiControlMap.idle();
+
 # if DISTRHO_PLUGIN_WANT_PROGRAMS
         if (fProgramChanged >= 0)
         {
@@ -383,42 +394,44 @@ protected:
 
 #if DISTRHO_PLUGIN_WANT_TIMEPOS
         jack_position_t pos;
-        fTimePosition.playing = (jackbridge_transport_query(fClient, &pos) == JackTransportRolling);
+        fTransport.setSampleRate(fPlugin.getSampleRate());
+        fTransport.setPlaying(jackbridge_transport_query(fClient, &pos) == JackTransportRolling);
 
         if (pos.unique_1 == pos.unique_2)
         {
-            fTimePosition.frame = pos.frame;
+            fTransport.setFrame(pos.frame);
 
-            if (pos.valid & JackPositionBBT)
+            if ((pos.valid & JackPositionBBT) && pos.beats_per_bar > 0.f && pos.beat_type > 0.f)
             {
-                fTimePosition.bbt.valid = true;
-
-                fTimePosition.bbt.bar  = pos.bar;
-                fTimePosition.bbt.beat = pos.beat;
-                fTimePosition.bbt.tick = pos.tick;
+                double tick = pos.tick;
 #ifdef JACK_TICK_DOUBLE
                 if (pos.valid & JackTickDouble)
-                    fTimePosition.bbt.tick = pos.tick_double;
-                else
+                    tick = pos.tick_double;
 #endif
-                    fTimePosition.bbt.tick = pos.tick;
-                fTimePosition.bbt.barStartTick = pos.bar_start_tick;
-
-                fTimePosition.bbt.beatsPerBar = pos.beats_per_bar;
-                fTimePosition.bbt.beatType    = pos.beat_type;
+                fTransport.setTempo(pos.beats_per_minute);
+                fTransport.setTimeSignature(pos.beats_per_bar, pos.beat_type);
 
-                fTimePosition.bbt.ticksPerBeat   = pos.ticks_per_beat;
-                fTimePosition.bbt.beatsPerMinute = pos.beats_per_minute;
+                if (pos.ticks_per_beat > 0.0)
+                {
+                    fTransport.setTicksPerBeat(pos.ticks_per_beat);
+                    fTransport.setPositionInBar(pos.bar - 1, pos.beat - 1 + tick / pos.ticks_per_beat);
+                    fTransport.setBarStartTick(pos.bar_start_tick);
+                }
+                else
+                {
+                    fTransport.setPositionInBar(pos.bar - 1, pos.beat - 1);
+                }
             }
             else
-                fTimePosition.bbt.valid = false;
+                fTransport.setPositionInvalid();
         }
         else
         {
-            fTimePosition.bbt.valid = false;
-            fTimePosition.frame = 0;
+            fTransport.setPositionInvalid();
+            fTransport.setFrame(0);
         }
 
+        fTransport.updateTimePosition(fTimePosition);
         fPlugin.setTimePosition(fTimePosition);
 #endif
 
@@ -457,35 +470,32 @@ protected:
 
         if (const uint32_t eventCount = std::min(512u - midiEventCount, jackbridge_midi_get_event_count(midiInBuf)))
         {
+            const MidiControlMap::ScopedReader midiControls(fMidiControlMap);
             jack_midi_event_t jevent;
+            const uint32_t* indices;
 
             for (uint32_t i=0; i < eventCount; ++i)
             {
                 if (! jackbridge_midi_event_get(&jevent, midiInBuf, i))
                     break;
 
-                // Check if message is control change on channel 1
-                if (jevent.buffer[0] == 0xB0 && jevent.size == 3)
+                // Check if message is control change, and apply it to all parameters bound to it
+                if ((jevent.buffer[0] & 0xF0) == 0xB0 && jevent.size == 3)
                 {
+                    const uint8_t channel = jevent.buffer[0] & 0x0F;
                     const uint8_t control = jevent.buffer[1];
-                    const uint8_t value   = jevent.buffer[2];
+                    const float   scaled  = static_cast<float>(jevent.buffer[2])/127.0f;
+
+                    fMidiControlMap.learnControl(channel, control);
 
-                    /* NOTE: This is not optimal, we're iterating all parameters on every CC message.
-                             Since the JACK standalone is more of a test tool, this will do for now. */
-                    for (uint32_t j=0, paramCount=fPlugin.getParameterCount(); j < paramCount; ++j)
+                    for (uint32_t j=0, count=midiControls.getParameters(channel, control, indices); j < count; ++j)
                     {
-                        if (fPlugin.isParameterOutput(j))
-                            continue;
-                        if (fPlugin.getParameterMidiCC(j) != control)
-                            continue;
-
-                        const float scaled = static_cast<float>(value)/127.0f;
-                        const float fvalue = fPlugin.getParameterRanges(j).getUnnormalizedValue(scaled);
-                        fPlugin.setParameterValue(j, fvalue);
+                        const uint32_t index = indices[j];
+                        const float fvalue = fPlugin.getParameterRanges(index).getUnnormalizedValue(scaled);
+                        fPlugin.setParameterValue(index, fvalue);
 #if DISTRHO_PLUGIN_HAS_UI
-                        fParametersChanged[j] = true;
+                        fParametersChanged[index] = true;
 #endif
-                        break;
                     }
                 }
 #if DISTRHO_PLUGIN_WANT_PROGRAMS
@@ -518,7 +528,17 @@ protected:
             }
         }
 
-#if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+#if DISTRHO_PLUGIN_HAS_UI
+        // parameter changes from the UI are applied at their matching frame offset
+        const ParameterEdit* parameterEdits;
+        const uint32_t parameterEditCount = fParameterEdits.read(nframes, fPlugin.getSampleRate(), parameterEdits);
+
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.run(audioIns, audioOuts, nframes, midiEvents, midiEventCount, parameterEdits, parameterEditCount);
+# else
+        fPlugin.run(audioIns, audioOuts, nframes, parameterEdits, parameterEditCount);
+# endif
+#elif DISTRHO_PLUGIN_WANT_MIDI_INPUT
         fPlugin.run(audioIns, audioOuts, nframes, midiEvents, midiEventCount);
 #else
         fPlugin.run(audioIns, audioOuts, nframes);
@@ -543,7 +563,7 @@ protected:
 #if DISTRHO_PLUGIN_HAS_UI
     void setParameterValue(const uint32_t index, const float value)
     {
-        fPlugin.setParameterValue(index, value);
+        fParameterEdits.write(index, value);
     }
 
 # if DISTRHO_PLUGIN_WANT_MIDI_INPUT
@@ -606,14 +626,18 @@ private:
 #endif
 #if DISTRHO_PLUGIN_WANT_TIMEPOS
     TimePosition fTimePosition;
+    TransportEngine fTransport;
 #endif
 
     // Temporary data
     float* fLastOutputValues;
+    MidiControlMap fMidiControlMap;
 
 #if DISTRHO_PLUGIN_HAS_UI
     // Store DSP changes to send to UI
     bool* fParametersChanged;
+    // Store UI changes to apply in DSP
+    ParameterEditQueue fParameterEdits;
 # if DISTRHO_PLUGIN_WANT_PROGRAMS
     int fProgramChanged;
 # endif
@@ -759,6 +783,14 @@ private:
     {
         thisPtr->sendNote(channel, note, velocity);
     }
+
+    static void midiLearnCallback(void* ptr, int32_t index)
+    {
+        if (index >= 0)
+            thisPtr->fMidiControlMap.startLearning(static_cast<uint32_t>(index));
+        else
+            thisPtr->fMidiControlMap.cancelLearning();
+    }
 # endif
 
 # if DISTRHO_PLUGIN_WANT_STATE
@@ -63,7 +63,14 @@ public:
 
 #if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
         for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+        {
             fPortAudioOuts[i] = nullptr;
+            fRunAddingOuts[i] = nullptr;
+        }
+
+        fRunAddingBuffer = nullptr;
+        fRunAddingBufferSize = 0;
+        fRunAddingGain = 1.0f;
 #else
         fPortAudioOuts = nullptr;
 #endif
@@ -103,12 +110,32 @@ public:
             delete[] fLastControlValues;
             fLastControlValues = nullptr;
         }
+
+#if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        if (fRunAddingBuffer != nullptr)
+        {
+            delete[] fRunAddingBuffer;
+            fRunAddingBuffer = nullptr;
+        }
+#endif
     }
 
     // -------------------------------------------------------------------
 
     void ladspa_activate()
     {
+#if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        // temporary outputs for run_adding, allocated here to keep processing realtime-safe
+        if (fRunAddingBuffer == nullptr)
+        {
+            fRunAddingBufferSize = fPlugin.getBufferSize();
+            fRunAddingBuffer = new LADSPA_Data[fRunAddingBufferSize * DISTRHO_PLUGIN_NUM_OUTPUTS];
+
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+                fRunAddingOuts[i] = fRunAddingBuffer + fRunAddingBufferSize * i;
+        }
+#endif
+
         fPlugin.activate();
     }
 
@@ -165,15 +192,26 @@ public:
 
     // -------------------------------------------------------------------
 
+    void ladspa_set_run_adding_gain(const LADSPA_Data gain) noexcept
+    {
+#if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        fRunAddingGain = gain;
+#else
+        // unused
+        (void)gain;
+#endif
+    }
+
 #ifdef DISTRHO_PLUGIN_TARGET_DSSI
-    void ladspa_run(const ulong sampleCount)
+    void ladspa_run(const ulong sampleCount, const bool adding = false)
     {
-        dssi_run_synth(sampleCount, nullptr, 0);
+        dssi_run_synth(sampleCount, nullptr, 0, adding);
     }
 
-    void dssi_run_synth(const ulong sampleCount, snd_seq_event_t* const events, const ulong eventCount)
+    void dssi_run_synth(const ulong sampleCount, snd_seq_event_t* const events, const ulong eventCount,
+                        const bool adding = false)
 #else
-    void ladspa_run(const ulong sampleCount)
+    void ladspa_run(const ulong sampleCount, const bool adding = false)
 #endif
     {
         // pre-roll
@@ -270,9 +308,15 @@ public:
             }
         }
 
-        fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, midiEvents, midiEventCount);
+        if (adding)
+            runAdding(sampleCount, midiEvents, midiEventCount);
+        else
+            fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, midiEvents, midiEventCount);
 #else
-        fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount);
+        if (adding)
+            runAdding(sampleCount, nullptr, 0);
+        else
+            fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount);
 #endif
 
         updateParameterOutputsAndTriggers();
@@ -375,6 +419,80 @@ private:
 
     // Temporary data
     LADSPA_Data* fLastControlValues;
+#if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+    LADSPA_Data* fRunAddingOuts[DISTRHO_PLUGIN_NUM_OUTPUTS];
+    LADSPA_Data* fRunAddingBuffer;
+    uint32_t     fRunAddingBufferSize;
+    LADSPA_Data  fRunAddingGain;
+#endif
+
+    // -------------------------------------------------------------------
+
+    // run into temporary outputs and mix them into the port buffers, in chunks of the temporary buffer size
+    void runAdding(const uint32_t sampleCount, MidiEvent* const midiEvents, const uint32_t midiEventCount)
+    {
+#if DISTRHO_PLUGIN_NUM_OUTPUTS > 0
+        DISTRHO_SAFE_ASSERT_RETURN(fRunAddingBuffer != nullptr,);
+
+# if DISTRHO_PLUGIN_NUM_INPUTS > 0
+        const LADSPA_Data* inputs[DISTRHO_PLUGIN_NUM_INPUTS];
+# else
+        const LADSPA_Data** const inputs = nullptr;
+# endif
+        const LADSPA_Data gain = fRunAddingGain;
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        uint32_t midiEventIndex = 0;
+# endif
+
+        for (uint32_t offset = 0, frames; offset < sampleCount; offset += frames)
+        {
+            frames = std::min(sampleCount - offset, fRunAddingBufferSize);
+
+# if DISTRHO_PLUGIN_NUM_INPUTS > 0
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_INPUTS; ++i)
+                inputs[i] = fPortAudioIns[i] + offset;
+# endif
+
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            const uint32_t firstMidiEventIndex = midiEventIndex;
+
+            for (; midiEventIndex < midiEventCount && midiEvents[midiEventIndex].frame < offset + frames; ++midiEventIndex)
+                midiEvents[midiEventIndex].frame = midiEvents[midiEventIndex].frame > offset
+                                                 ? midiEvents[midiEventIndex].frame - offset
+                                                 : 0;
+
+            fPlugin.run(inputs, fRunAddingOuts, frames,
+                        midiEvents + firstMidiEventIndex, midiEventIndex - firstMidiEventIndex);
+# else
+            fPlugin.run(inputs, fRunAddingOuts, frames);
+# endif
+
+            for (uint32_t i=0; i < DISTRHO_PLUGIN_NUM_OUTPUTS; ++i)
+            {
+                LADSPA_Data* const out = fPortAudioOuts[i] + offset;
+                const LADSPA_Data* const tmp = fRunAddingOuts[i];
+
+                for (uint32_t j=0; j < frames; ++j)
+                    out[j] += tmp[j] * gain;
+            }
+        }
+
+# if ! DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        // unused
+        (void)midiEvents;
+        (void)midiEventCount;
+# endif
+#else
+# if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount, midiEvents, midiEventCount);
+# else
+        fPlugin.run(fPortAudioIns, fPortAudioOuts, sampleCount);
+        // unused
+        (void)midiEvents;
+        (void)midiEventCount;
+# endif
+#endif
+    }
 
     // -------------------------------------------------------------------
 
@@ -442,6 +560,16 @@ static void ladspa_run(LADSPA_Handle instance, ulong sampleCount)
     instancePtr->ladspa_run(sampleCount);
 }
 
+static void ladspa_run_adding(LADSPA_Handle instance, ulong sampleCount)
+{
+    instancePtr->ladspa_run(sampleCount, true);
+}
+
+static void ladspa_set_run_adding_gain(LADSPA_Handle instance, LADSPA_Data gain)
+{
+    instancePtr->ladspa_set_run_adding_gain(gain);
+}
+
 static void ladspa_deactivate(LADSPA_Handle instance)
 {
     instancePtr->ladspa_deactivate();
@@ -482,6 +610,25 @@ static void dssi_run_synth(LADSPA_Handle instance, ulong sampleCount, snd_seq_ev
 {
     instancePtr->dssi_run_synth(sampleCount, events, eventCount);
 }
+
+static void dssi_run_synth_adding(LADSPA_Handle instance, ulong sampleCount, snd_seq_event_t* events, ulong eventCount)
+{
+    instancePtr->dssi_run_synth(sampleCount, events, eventCount, true);
+}
+
+static void dssi_run_multiple_synths(ulong instanceCount, LADSPA_Handle* instances, ulong sampleCount,
+                                     snd_seq_event_t** events, ulong* eventCounts)
+{
+    for (ulong i=0; i < instanceCount; ++i)
+        ((PluginLadspaDssi*)instances[i])->dssi_run_synth(sampleCount, events[i], eventCounts[i]);
+}
+
+static void dssi_run_multiple_synths_adding(ulong instanceCount, LADSPA_Handle* instances, ulong sampleCount,
+                                            snd_seq_event_t** events, ulong* eventCounts)
+{
+    for (ulong i=0; i < instanceCount; ++i)
+        ((PluginLadspaDssi*)instances[i])->dssi_run_synth(sampleCount, events[i], eventCounts[i], true);
+}
 # endif
 #endif
 
@@ -492,11 +639,14 @@ static void dssi_run_synth(LADSPA_Handle instance, ulong sampleCount, snd_seq_ev
 static LADSPA_Descriptor sLadspaDescriptor = {
     /* UniqueID   */ 0,
     /* Label      */ nullptr,
+    /* Properties */ 0x0
 #if DISTRHO_PLUGIN_IS_RT_SAFE
-    /* Properties */ LADSPA_PROPERTY_HARD_RT_CAPABLE,
-#else
-    /* Properties */ 0x0,
+                   | LADSPA_PROPERTY_HARD_RT_CAPABLE
+#endif
+#if ! DISTRHO_PLUGIN_SUPPORTS_IN_PLACE && DISTRHO_PLUGIN_NUM_INPUTS != 0 && DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+                   | LADSPA_PROPERTY_INPLACE_BROKEN
 #endif
+                   ,
     /* Name       */ nullptr,
     /* Maker      */ nullptr,
     /* Copyright  */ nullptr,
@@ -509,8 +659,8 @@ static LADSPA_Descriptor sLadspaDescriptor = {
     ladspa_connect_port,
     ladspa_activate,
     ladspa_run,
-    /* run_adding */          nullptr,
-    /* set_run_adding_gain */ nullptr,
+    ladspa_run_adding,
+    ladspa_set_run_adding_gain,
     ladspa_deactivate,
     ladspa_cleanup
 };
@@ -534,12 +684,15 @@ static DSSI_Descriptor sDssiDescriptor = {
     dssi_get_midi_controller_for_port,
 # if DISTRHO_PLUGIN_WANT_MIDI_INPUT
     dssi_run_synth,
+    dssi_run_synth_adding,
+    dssi_run_multiple_synths,
+    dssi_run_multiple_synths_adding,
 # else
     /* run_synth                    */ nullptr,
-# endif
     /* run_synth_adding             */ nullptr,
     /* run_multiple_synths          */ nullptr,
     /* run_multiple_synths_adding   */ nullptr,
+# endif
     nullptr, nullptr
 };
 #endif
@@ -15,6 +15,7 @@
  */
 
 #include "DistrhoPluginInternal.hpp"
+#include "../DistrhoPluginUtils.hpp"
 
 #include "lv2/atom.h"
 #include "lv2/atom-forge.h"
@@ -240,17 +241,10 @@ public:
     void lv2_activate()
     {
 #if DISTRHO_PLUGIN_WANT_TIMEPOS
-        fTimePosition.clear();
-
         // hosts may not send all values, resulting on some invalid data, let's reset everything
-        fTimePosition.bbt.bar   = 1;
-        fTimePosition.bbt.beat  = 1;
-        fTimePosition.bbt.tick  = 0.0;
-        fTimePosition.bbt.barStartTick = 0;
-        fTimePosition.bbt.beatsPerBar  = 4;
-        fTimePosition.bbt.beatType     = 4;
-        fTimePosition.bbt.ticksPerBeat = 1920.0;
-        fTimePosition.bbt.beatsPerMinute = 120.0;
+        fTransport.reset();
+        fTransport.setSampleRate(fSampleRate);
+        fTransport.updateTimePosition(fTimePosition);
 #endif
         fPlugin.activate();
     }
@@ -407,7 +401,7 @@ public:
                         d_stderr("Unknown lv2 ticksPerBeat value type");
 
                     if (fLastPositionData.ticksPerBeat > 0.0)
-                        fTimePosition.bbt.ticksPerBeat = fLastPositionData.ticksPerBeat;
+                        fTransport.setTicksPerBeat(fLastPositionData.ticksPerBeat);
                 }
 
                 // same
@@ -424,7 +418,7 @@ public:
                     else
                         d_stderr("Unknown lv2 speed value type");
 
-                    fTimePosition.playing = d_isNotZero(fLastPositionData.speed);
+                    fTransport.setPlaying(d_isNotZero(fLastPositionData.speed));
                 }
 
                 if (bar != nullptr)
@@ -439,9 +433,6 @@ public:
                         fLastPositionData.bar = ((LV2_Atom_Long*)bar)->body;
                     else
                         d_stderr("Unknown lv2 bar value type");
-
-                    if (fLastPositionData.bar >= 0)
-                        fTimePosition.bbt.bar = fLastPositionData.bar + 1;
                 }
 
                 if (barBeat != nullptr)
@@ -456,13 +447,6 @@ public:
                         fLastPositionData.barBeat = ((LV2_Atom_Long*)barBeat)->body;
                     else
                         d_stderr("Unknown lv2 barBeat value type");
-
-                    if (fLastPositionData.barBeat >= 0.0f)
-                    {
-                        const double rest = std::fmod(fLastPositionData.barBeat, 1.0);
-                        fTimePosition.bbt.beat = std::round(fLastPositionData.barBeat - rest + 1.0);
-                        fTimePosition.bbt.tick = rest * fTimePosition.bbt.ticksPerBeat;
-                    }
                 }
 
                 if (beatUnit != nullptr)
@@ -477,9 +461,6 @@ public:
                         fLastPositionData.beatUnit = ((LV2_Atom_Long*)beatUnit)->body;
                     else
                         d_stderr("Unknown lv2 beatUnit value type");
-
-                    if (fLastPositionData.beatUnit > 0)
-                        fTimePosition.bbt.beatType = fLastPositionData.beatUnit;
                 }
 
                 if (beatsPerBar != nullptr)
@@ -494,9 +475,6 @@ public:
                         fLastPositionData.beatsPerBar = ((LV2_Atom_Long*)beatsPerBar)->body;
                     else
                         d_stderr("Unknown lv2 beatsPerBar value type");
-
-                    if (fLastPositionData.beatsPerBar > 0.0f)
-                        fTimePosition.bbt.beatsPerBar = fLastPositionData.beatsPerBar;
                 }
 
                 if (beatsPerMinute != nullptr)
@@ -514,10 +492,10 @@ public:
 
                     if (fLastPositionData.beatsPerMinute > 0.0f)
                     {
-                        fTimePosition.bbt.beatsPerMinute = fLastPositionData.beatsPerMinute;
-
                         if (d_isNotZero(fLastPositionData.speed))
-                            fTimePosition.bbt.beatsPerMinute *= std::abs(fLastPositionData.speed);
+                            fTransport.setTempo(fLastPositionData.beatsPerMinute * std::abs(fLastPositionData.speed));
+                        else
+                            fTransport.setTempo(fLastPositionData.beatsPerMinute);
                     }
                 }
 
@@ -535,17 +513,25 @@ public:
                         d_stderr("Unknown lv2 frame value type");
 
                     if (fLastPositionData.frame >= 0)
-                        fTimePosition.frame = fLastPositionData.frame;
+                        fTransport.setFrame(fLastPositionData.frame);
                 }
 
-                fTimePosition.bbt.barStartTick = fTimePosition.bbt.ticksPerBeat*
-                                                 fTimePosition.bbt.beatsPerBar*
-                                                 (fTimePosition.bbt.bar-1);
+                fTransport.setSampleRate(fSampleRate);
 
-                fTimePosition.bbt.valid = (fLastPositionData.beatsPerMinute > 0.0 &&
-                                           fLastPositionData.beatUnit > 0 &&
-                                           fLastPositionData.beatsPerBar > 0.0f);
+                if (fLastPositionData.beatsPerMinute > 0.0 &&
+                    fLastPositionData.beatUnit > 0 &&
+                    fLastPositionData.beatsPerBar > 0.0f)
+                {
+                    fTransport.setTimeSignature(fLastPositionData.beatsPerBar, fLastPositionData.beatUnit);
+                    fTransport.setPositionInBar(fLastPositionData.bar >= 0 ? fLastPositionData.bar : 0,
+                                                fLastPositionData.barBeat >= 0.0f ? fLastPositionData.barBeat : 0.0);
+                }
+                else
+                {
+                    fTransport.setPositionInvalid();
+                }
 
+                fTransport.updateTimePosition(fTimePosition);
                 fPlugin.setTimePosition(fTimePosition);
 
                 continue;
@@ -639,54 +625,18 @@ public:
             // update timePos for next callback
             if (d_isNotZero(fLastPositionData.speed))
             {
-                if (fLastPositionData.speed > 0.0)
-                {
-                    // playing forwards
-                    fLastPositionData.frame += sampleCount;
-                }
-                else
-                {
-                    // playing backwards
-                    fLastPositionData.frame -= sampleCount;
+                fTransport.advance(fLastPositionData.speed > 0.0 ? static_cast<int64_t>(sampleCount)
+                                                                 : -static_cast<int64_t>(sampleCount));
+                fTransport.updateTimePosition(fTimePosition);
 
-                    if (fLastPositionData.frame < 0)
-                        fLastPositionData.frame = 0;
-                }
-
-                fTimePosition.frame = fLastPositionData.frame;
+                // keep last position in sync, in case the host only sends partial updates
+                fLastPositionData.frame = static_cast<int64_t>(fTimePosition.frame);
 
                 if (fTimePosition.bbt.valid)
                 {
-                    const double beatsPerMinute = fLastPositionData.beatsPerMinute * fLastPositionData.speed;
-                    const double framesPerBeat  = 60.0 * fSampleRate / beatsPerMinute;
-                    const double addedBarBeats  = double(sampleCount) / framesPerBeat;
-
-                    if (fLastPositionData.barBeat >= 0.0f)
-                    {
-                        fLastPositionData.barBeat = std::fmod(fLastPositionData.barBeat+addedBarBeats,
-                                                              (double)fLastPositionData.beatsPerBar);
-
-                        const double rest = std::fmod(fLastPositionData.barBeat, 1.0f);
-                        fTimePosition.bbt.beat = std::round(fLastPositionData.barBeat - rest + 1.0);
-                        fTimePosition.bbt.tick = rest * fTimePosition.bbt.ticksPerBeat;
-
-                        if (fLastPositionData.bar >= 0)
-                        {
-                            fLastPositionData.bar += std::floor((fLastPositionData.barBeat+addedBarBeats)/
-                                                             fLastPositionData.beatsPerBar);
-
-                            if (fLastPositionData.bar < 0)
-                                fLastPositionData.bar = 0;
-
-                            fTimePosition.bbt.bar = fLastPositionData.bar + 1;
-
-                            fTimePosition.bbt.barStartTick = fTimePosition.bbt.ticksPerBeat*
-                                                             fTimePosition.bbt.beatsPerBar*
-                                                            (fTimePosition.bbt.bar-1);
-                        }
-                    }
-
-                    fTimePosition.bbt.beatsPerMinute = std::abs(beatsPerMinute);
+                    fLastPositionData.bar = fTimePosition.bbt.bar - 1;
+                    fLastPositionData.barBeat = fTimePosition.bbt.beat - 1 +
+                                                fTimePosition.bbt.tick / fTimePosition.bbt.ticksPerBeat;
                 }
 
                 fPlugin.setTimePosition(fTimePosition);
@@ -1210,6 +1160,7 @@ private:
    #endif
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
     TimePosition fTimePosition;
+    TransportEngine fTransport;
 
     struct Lv2PositionData {
         int64_t  bar;
@@ -126,6 +126,9 @@ static constexpr const char* const lv2ManifestPluginOptionalFeatures[] = {
 static constexpr const char* const lv2ManifestPluginRequiredFeatures[] = {
     "opts:options",
     LV2_URID__map,
+   #if ! DISTRHO_PLUGIN_SUPPORTS_IN_PLACE && DISTRHO_PLUGIN_NUM_INPUTS != 0 && DISTRHO_PLUGIN_NUM_OUTPUTS != 0
+    LV2_CORE__inPlaceBroken,
+   #endif
    #if DISTRHO_PLUGIN_WANT_STATE
     LV2_WORKER__schedule,
    #endif
@@ -37,6 +37,12 @@
 # include "Base.hpp"
 #endif
 
+#if defined(DISTRHO_PLUGIN_TARGET_VST3) && DISTRHO_PLUGIN_WANT_STATE
+# include "../extra/String.hpp"
+# include "travesty/message.h"
+# include <map>
+#endif
+
 #if DISTRHO_PLUGIN_HAS_UI == 1 && DISTRHO_PLUGIN_WANT_DIRECT_ACCESS == 0
 # define DPF_VST3_USES_SEPARATE_CONTROLLER 1
 #else
@@ -377,6 +383,155 @@ struct ScopedUTF8String {
     }
 };
 
+#if defined(DISTRHO_PLUGIN_TARGET_VST3) && DISTRHO_PLUGIN_WANT_STATE
+// --------------------------------------------------------------------------------------------------------------------
+// state messages between component, controller and view
+// key and value are sent as UTF-8 binary attributes, with large values split over several messages:
+//  - "key": binary, key without null terminator
+//  - "value:length": int, full value length
+//  - "value:offset": int, offset of this chunk within the full value
+//  - "value": binary, chunk data (not present for empty values)
+
+static constexpr const uint32_t kVst3StateChunkSize = 256 * 1024;
+
+static inline
+void setStateMessageChunk(v3_attribute_list** const attrlist,
+                          const char* const key, const char* const value,
+                          const uint32_t valueLength, const uint32_t offset)
+{
+    v3_cpp_obj(attrlist)->set_binary(attrlist, "key", key, static_cast<uint32_t>(std::strlen(key)));
+    v3_cpp_obj(attrlist)->set_int(attrlist, "value:length", valueLength);
+    v3_cpp_obj(attrlist)->set_int(attrlist, "value:offset", offset);
+
+    if (valueLength != 0)
+        v3_cpp_obj(attrlist)->set_binary(attrlist, "value", value + offset,
+                                         std::min(valueLength - offset, kVst3StateChunkSize));
+}
+
+// reassembles chunked state messages, only one value can be in transit at a time
+struct StateMessageReceiver {
+    String key;
+    char* value;
+    uint32_t valueLength;
+    uint32_t received;
+
+    StateMessageReceiver() noexcept
+        : key(),
+          value(nullptr),
+          valueLength(0),
+          received(0) {}
+
+    ~StateMessageReceiver() noexcept
+    {
+        std::free(value);
+    }
+
+    // returns V3_OK when a complete value is available in @a key and @a value, V3_FALSE while waiting for more chunks
+    v3_result receive(v3_attribute_list** const attrs)
+    {
+        const void* keyData = nullptr;
+        const void* chunkData = nullptr;
+        uint32_t keySize = 0;
+        uint32_t chunkSize = 0;
+        int64_t length = -1;
+        int64_t offset = -1;
+        v3_result res;
+
+        res = v3_cpp_obj(attrs)->get_binary(attrs, "key", &keyData, &keySize);
+        DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+        DISTRHO_SAFE_ASSERT_RETURN(keyData != nullptr && keySize != 0, V3_INTERNAL_ERR);
+
+        res = v3_cpp_obj(attrs)->get_int(attrs, "value:length", &length);
+        DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+        DISTRHO_SAFE_ASSERT_RETURN(length >= 0 && length < UINT32_MAX, V3_INTERNAL_ERR);
+
+        res = v3_cpp_obj(attrs)->get_int(attrs, "value:offset", &offset);
+        DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+        DISTRHO_SAFE_ASSERT_RETURN(offset >= 0 && offset <= length, V3_INTERNAL_ERR);
+
+        if (length != 0)
+        {
+            res = v3_cpp_obj(attrs)->get_binary(attrs, "value", &chunkData, &chunkSize);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+            DISTRHO_SAFE_ASSERT_RETURN(chunkData != nullptr, V3_INTERNAL_ERR);
+            DISTRHO_SAFE_ASSERT_RETURN(chunkSize <= length - offset, V3_INTERNAL_ERR);
+        }
+
+        // first chunk, start a new value
+        if (offset == 0)
+        {
+            std::free(value);
+            value = static_cast<char*>(std::malloc(static_cast<size_t>(length) + 1));
+            DISTRHO_SAFE_ASSERT_RETURN(value != nullptr, V3_NOMEM);
+
+            char* const keyBuf = static_cast<char*>(std::malloc(keySize + 1));
+            DISTRHO_SAFE_ASSERT_RETURN(keyBuf != nullptr, V3_NOMEM);
+            std::memcpy(keyBuf, keyData, keySize);
+            keyBuf[keySize] = '\0';
+
+            key = String(keyBuf, false);
+            valueLength = static_cast<uint32_t>(length);
+            received = 0;
+        }
+        else
+        {
+            // chunk must continue the value currently in transit
+            DISTRHO_SAFE_ASSERT_RETURN(value != nullptr, V3_INTERNAL_ERR);
+            DISTRHO_SAFE_ASSERT_RETURN(valueLength == length && received == offset, V3_INTERNAL_ERR);
+            DISTRHO_SAFE_ASSERT_RETURN(key.length() == keySize && std::memcmp(key.buffer(), keyData, keySize) == 0,
+                                       V3_INTERNAL_ERR);
+        }
+
+        if (chunkSize != 0)
+            std::memcpy(value + received, chunkData, chunkSize);
+
+        received += chunkSize;
+
+        if (received != valueLength)
+            return V3_FALSE;
+
+        value[valueLength] = '\0';
+        return V3_OK;
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(StateMessageReceiver)
+};
+
+// content hashes of the last state values sent or received, used to skip sending unchanged values
+struct StateHashes {
+    std::map<const String, uint64_t> hashes;
+
+    // returns true if value differs from the last one seen for this key, and remembers it
+    bool update(const char* const key, const char* const value)
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (const char* s = value; *s != '\0'; ++s)
+            hash = (hash ^ static_cast<uint8_t>(*s)) * 1099511628211ULL;
+
+        const String skey(key);
+        const std::map<const String, uint64_t>::iterator it = hashes.find(skey);
+
+        if (it != hashes.end())
+        {
+            if (it->second == hash)
+                return false;
+
+            it->second = hash;
+            return true;
+        }
+
+        hashes[skey] = hash;
+        return true;
+    }
+
+    void clear()
+    {
+        hashes.clear();
+    }
+};
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 
 END_NAMESPACE_DISTRHO
@@ -107,6 +107,7 @@ struct ParameterAndNotesHelper
     float* parameterValues;
   #if DISTRHO_PLUGIN_HAS_UI
     bool* parameterChecks;
+    ParameterEditQueue parameterEdits;
    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
     SmallStackBuffer notesRingBuffer;
    #endif
@@ -305,7 +306,12 @@ protected:
         const ParameterRanges& ranges(fPlugin->getParameterRanges(index));
         const float perValue = ranges.getNormalizedValue(realValue);
 
-        fPlugin->setParameterValue(index, realValue);
+        // while processing, let the audio thread apply the change at the right time
+        if (fPlugin->isActive())
+            fUiHelper->parameterEdits.write(index, realValue);
+        else
+            fPlugin->setParameterValue(index, realValue);
+
         hostCallback(VST_HOST_OPCODE_00, index, 0, nullptr, perValue);
     }
 
@@ -427,6 +433,7 @@ public:
         {
             parameterChecks = new bool[parameterCount];
             memset(parameterChecks, 0, sizeof(bool)*parameterCount);
+            parameterEdits.init(parameterCount);
         }
 
       #ifdef DISTRHO_OS_MAC
@@ -980,6 +987,14 @@ public:
     float vst_getParameter(const uint32_t index)
     {
         const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
+
+       #if DISTRHO_PLUGIN_HAS_UI
+        // report changes from the UI right away, even if not yet applied by the audio thread
+        float value;
+        if (parameterEdits.getPendingValue(index, value))
+            return ranges.getNormalizedValue(value);
+       #endif
+
         return ranges.getNormalizedValue(fPlugin.getParameterValue(index));
     }
 
@@ -1029,56 +1044,33 @@ public:
 
         if (const VstTimeInfo* const vstTimeInfo = (const VstTimeInfo*)hostCallback(VST_HOST_OPCODE_07, 0, kWantVstTimeFlags))
         {
-            fTimePosition.frame   = vstTimeInfo->samplePos;
-            fTimePosition.playing = vstTimeInfo->flags & 0x2;
-
-            // ticksPerBeat is not possible with VST2
-            fTimePosition.bbt.ticksPerBeat = 1920.0;
-
-            if (vstTimeInfo->flags & 0x400)
-                fTimePosition.bbt.beatsPerMinute = vstTimeInfo->tempo;
-            else
-                fTimePosition.bbt.beatsPerMinute = 120.0;
+            fTransport.setSampleRate(fPlugin.getSampleRate());
+            fTransport.setFrame(vstTimeInfo->samplePos);
+            fTransport.setPlaying(vstTimeInfo->flags & 0x2);
+            fTransport.setTempo(vstTimeInfo->flags & 0x400 ? vstTimeInfo->tempo : 120.0);
 
             if ((vstTimeInfo->flags & 0x2200) == 0x2200)
             {
-                const double ppqPos    = std::abs(vstTimeInfo->ppqPos);
-                const int    ppqPerBar = vstTimeInfo->timeSigNumerator * 4 / vstTimeInfo->timeSigDenominator;
-                const double barBeats  = (std::fmod(ppqPos, ppqPerBar) / ppqPerBar) * vstTimeInfo->timeSigNumerator;
-                const double rest      =  std::fmod(barBeats, 1.0);
-
-                fTimePosition.bbt.valid       = true;
-                fTimePosition.bbt.bar         = static_cast<int32_t>(ppqPos) / ppqPerBar + 1;
-                fTimePosition.bbt.beat        = static_cast<int32_t>(barBeats - rest + 0.5) + 1;
-                fTimePosition.bbt.tick        = rest * fTimePosition.bbt.ticksPerBeat;
-                fTimePosition.bbt.beatsPerBar = vstTimeInfo->timeSigNumerator;
-                fTimePosition.bbt.beatType    = vstTimeInfo->timeSigDenominator;
-
-                if (vstTimeInfo->ppqPos < 0.0)
-                {
-                    --fTimePosition.bbt.bar;
-                    fTimePosition.bbt.beat = vstTimeInfo->timeSigNumerator - fTimePosition.bbt.beat + 1;
-                    fTimePosition.bbt.tick = fTimePosition.bbt.ticksPerBeat - fTimePosition.bbt.tick - 1;
-                }
+                fTransport.setTimeSignature(vstTimeInfo->timeSigNumerator, vstTimeInfo->timeSigDenominator);
+                fTransport.setPositionInQuarterNotes(vstTimeInfo->ppqPos);
             }
             else
             {
-                fTimePosition.bbt.valid       = false;
-                fTimePosition.bbt.bar         = 1;
-                fTimePosition.bbt.beat        = 1;
-                fTimePosition.bbt.tick        = 0.0;
-                fTimePosition.bbt.beatsPerBar = 4.0f;
-                fTimePosition.bbt.beatType    = 4.0f;
+                fTransport.setTimeSignature(4.f, 4.f);
+                fTransport.setPositionInvalid();
             }
 
-            fTimePosition.bbt.barStartTick = fTimePosition.bbt.ticksPerBeat*
-                                             fTimePosition.bbt.beatsPerBar*
-                                             (fTimePosition.bbt.bar-1);
-
+            fTransport.updateTimePosition(fTimePosition);
             fPlugin.setTimePosition(fTimePosition);
         }
        #endif
 
+       #if DISTRHO_PLUGIN_HAS_UI
+        // parameter changes from the UI are applied at their matching frame offset
+        const ParameterEdit* edits;
+        const uint32_t editCount = parameterEdits.read(sampleFrames, fPlugin.getSampleRate(), edits);
+       #endif
+
       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
        #if DISTRHO_PLUGIN_HAS_UI
         if (fMidiEventCount != kMaxMidiEvents && fNotesRingBuffer.isDataAvailableForReading())
@@ -1102,8 +1094,14 @@ public:
         }
        #endif
 
+       #if DISTRHO_PLUGIN_HAS_UI
+        fPlugin.run(inputs, outputs, sampleFrames, fMidiEvents, fMidiEventCount, edits, editCount);
+       #else
         fPlugin.run(inputs, outputs, sampleFrames, fMidiEvents, fMidiEventCount);
+       #endif
         fMidiEventCount = 0;
+      #elif DISTRHO_PLUGIN_HAS_UI
+        fPlugin.run(inputs, outputs, sampleFrames, edits, editCount);
       #else
         fPlugin.run(inputs, outputs, sampleFrames);
       #endif
@@ -1133,6 +1131,7 @@ private:
 
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
     TimePosition fTimePosition;
+    TransportEngine fTransport;
    #endif
 
     // UI stuff
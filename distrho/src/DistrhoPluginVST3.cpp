@@ -604,6 +604,9 @@ public:
         , fParameterValueChangesForUI(nullptr)
         , fConnectedToUI(false)
        #endif
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT && DPF_VST3_USES_SEPARATE_CONTROLLER
+        , fMidiLearnPending(false)
+       #endif
        #if DISTRHO_PLUGIN_WANT_LATENCY
         , fLastKnownLatency(fPlugin.getLatency())
        #endif
@@ -663,6 +666,10 @@ public:
         }
        #endif
 
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fMidiControlMap.init(fPlugin);
+       #endif
+
        #if !DISTRHO_PLUGIN_HAS_UI
         // unused
         return; (void)host;
@@ -703,26 +710,26 @@ public:
 
     double _getNormalizedParameterValue(const uint32_t index, const double plain)
     {
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
-        return ranges.getFixedAndNormalizedValue(plain);
+        return fPlugin.getNormalizedParameterValue(index, plain);
     }
 
     void _setNormalizedPluginParameterValue(const uint32_t index, const double normalized)
     {
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
         const uint32_t hints = fPlugin.getParameterHints(index);
-        float value = ranges.getUnnormalizedValue(normalized);
+        float value = fPlugin.getUnnormalizedParameterValue(index, normalized);
 
         // convert as needed as check for changes
         if (hints & kParameterIsBoolean)
         {
-            const float midRange = ranges.min + (ranges.max - ranges.min) / 2.f;
+            const float min = fPlugin.getParameterMinimum(index);
+            const float max = fPlugin.getParameterMaximum(index);
+            const float midRange = min + (max - min) / 2.f;
             const bool isHigh = value > midRange;
 
             if (isHigh == (fCachedParameterValues[kVst3InternalParameterBaseCount + index] > midRange))
                 return;
 
-            value = isHigh ? ranges.max : ranges.min;
+            value = isHigh ? max : min;
         }
         else if (hints & kParameterIsInteger)
         {
@@ -736,7 +743,7 @@ public:
         else
         {
             // deal with low resolution of some hosts, which convert double to float internally and lose precision
-            if (std::abs(ranges.getNormalizedValue(static_cast<double>(fCachedParameterValues[kVst3InternalParameterBaseCount + index])) - normalized) < 0.0000001)
+            if (std::abs(fPlugin.getNormalizedParameterValue(index, fCachedParameterValues[kVst3InternalParameterBaseCount + index]) - normalized) < 0.0000001)
                 return;
         }
 
@@ -928,6 +935,10 @@ public:
 
     v3_result setActive(const bool active)
     {
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fMidiControlMap.idle();
+       #endif
+
         if (active)
             fPlugin.activate();
         else
@@ -937,9 +948,10 @@ public:
     }
 
     /* state: we pack pairs of key-value strings each separated by a null/zero byte.
-     * current-program comes first, then dpf key/value states and then parameters.
+     * current-program comes first, then dpf key/value states, then parameters and then MIDI CC bindings.
      * parameters are simply converted to/from strings and floats.
      * the parameter symbol is used as the "key", so it is possible to reorder them or even remove and add safely.
+     * MIDI CC bindings are only stored for parameters where they differ from Parameter::midiCC.
      * there are markers for begin and end of state and parameters, so they never conflict.
      */
     v3_result setState(v3_bstream** const stream)
@@ -952,12 +964,17 @@ public:
         bool empty = true;
         bool hasValue = false;
         bool fillingKey = true; // if filling key or value
-        char queryingType = 'i'; // can be 'n', 's' or 'p' (none, states, parameters)
+        char queryingType = 'i'; // can be 'n', 's', 'p' or 'm' (none, states, parameters, MIDI CC bindings)
 
         char buffer[512], orig;
         buffer[sizeof(buffer)-1] = '\xff';
         v3_result res;
 
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        // bindings not present in the state are the default ones
+        fMidiControlMap.resetParameterControls();
+       #endif
+
         for (int32_t terminated = 0, read; terminated == 0;)
         {
             read = -1;
@@ -1043,6 +1060,25 @@ public:
                         hasValue = false;
                         continue;
                     }
+                    if (key == "__dpf_midi_controls_begin__")
+                    {
+                        DISTRHO_SAFE_ASSERT_INT_RETURN(queryingType == 'i' || queryingType == 'n' || queryingType == 'x',
+                                                       queryingType, V3_INTERNAL_ERR);
+                        queryingType = 'm';
+                        key.clear();
+                        value.clear();
+                        hasValue = false;
+                        continue;
+                    }
+                    if (key == "__dpf_midi_controls_end__")
+                    {
+                        DISTRHO_SAFE_ASSERT_INT_RETURN(queryingType == 'm', queryingType, V3_INTERNAL_ERR);
+                        queryingType = 'x';
+                        key.clear();
+                        value.clear();
+                        hasValue = false;
+                        continue;
+                    }
 
                     // no special key, swap between reading real key and value
                     fillingKey = !fillingKey;
@@ -1138,6 +1174,21 @@ public:
                             break;
                         }
                     }
+                   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                    else if (queryingType == 'm')
+                    {
+                        d_debug("found MIDI CC binding '%s' '%s'", key.buffer(), value.buffer());
+
+                        for (uint32_t j=0; j < fParameterCount; ++j)
+                        {
+                            if (fPlugin.getParameterSymbol(j) != key)
+                                continue;
+
+                            fMidiControlMap.setParameterControlFromText(j, value);
+                            break;
+                        }
+                    }
+                   #endif
 
                     key.clear();
                     value.clear();
@@ -1250,6 +1301,29 @@ public:
             }
 
             state += "__dpf_parameters_end__\xff";
+
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            // learned or otherwise changed MIDI CC bindings
+            String bindings;
+
+            for (uint32_t i=0; i<paramCount; ++i)
+            {
+                if (! fMidiControlMap.isParameterControlModified(i))
+                    continue;
+
+                bindings += fPlugin.getParameterSymbol(i);
+                bindings += "\xff";
+                bindings += fMidiControlMap.getParameterControlText(i);
+                bindings += "\xff";
+            }
+
+            if (bindings.isNotEmpty())
+            {
+                state += "__dpf_midi_controls_begin__\xff";
+                state += bindings;
+                state += "__dpf_midi_controls_end__\xff";
+            }
+           #endif
         }
 
         // terminator
@@ -1401,56 +1475,28 @@ public:
        #if DISTRHO_PLUGIN_WANT_TIMEPOS
         if (v3_process_context* const ctx = data->ctx)
         {
-            fTimePosition.playing = ctx->state & V3_PROCESS_CTX_PLAYING;
-
-            // ticksPerBeat is not possible with VST3
-            fTimePosition.bbt.ticksPerBeat = 1920.0;
+            fTransport.setSampleRate(fPlugin.getSampleRate());
+            fTransport.setPlaying(ctx->state & V3_PROCESS_CTX_PLAYING);
 
             if (ctx->state & V3_PROCESS_CTX_PROJECT_TIME_VALID)
-                fTimePosition.frame = ctx->project_time_in_samples;
+                fTransport.setFrame(ctx->project_time_in_samples);
             else if (ctx->state & V3_PROCESS_CTX_CONT_TIME_VALID)
-                fTimePosition.frame = ctx->continuous_time_in_samples;
+                fTransport.setFrame(ctx->continuous_time_in_samples);
 
-            if (ctx->state & V3_PROCESS_CTX_TEMPO_VALID)
-                fTimePosition.bbt.beatsPerMinute = ctx->bpm;
-            else
-                fTimePosition.bbt.beatsPerMinute = 120.0;
+            fTransport.setTempo(ctx->state & V3_PROCESS_CTX_TEMPO_VALID ? ctx->bpm : 120.0);
 
             if ((ctx->state & (V3_PROCESS_CTX_PROJECT_TIME_VALID|V3_PROCESS_CTX_TIME_SIG_VALID)) == (V3_PROCESS_CTX_PROJECT_TIME_VALID|V3_PROCESS_CTX_TIME_SIG_VALID))
             {
-                const double ppqPos    = std::abs(ctx->project_time_quarters);
-                const int    ppqPerBar = ctx->time_sig_numerator * 4 / ctx->time_sig_denom;
-                const double barBeats  = (std::fmod(ppqPos, ppqPerBar) / ppqPerBar) * ctx->time_sig_numerator;
-                const double rest      =  std::fmod(barBeats, 1.0);
-
-                fTimePosition.bbt.valid       = true;
-                fTimePosition.bbt.bar         = static_cast<int32_t>(ppqPos) / ppqPerBar + 1;
-                fTimePosition.bbt.beat        = static_cast<int32_t>(barBeats - rest) + 1;
-                fTimePosition.bbt.tick        = rest * fTimePosition.bbt.ticksPerBeat;
-                fTimePosition.bbt.beatsPerBar = ctx->time_sig_numerator;
-                fTimePosition.bbt.beatType    = ctx->time_sig_denom;
-
-                if (ctx->project_time_quarters < 0.0)
-                {
-                    --fTimePosition.bbt.bar;
-                    fTimePosition.bbt.beat = ctx->time_sig_numerator - fTimePosition.bbt.beat + 1;
-                    fTimePosition.bbt.tick = fTimePosition.bbt.ticksPerBeat - fTimePosition.bbt.tick - 1;
-                }
+                fTransport.setTimeSignature(ctx->time_sig_numerator, ctx->time_sig_denom);
+                fTransport.setPositionInQuarterNotes(ctx->project_time_quarters);
             }
             else
             {
-                fTimePosition.bbt.valid       = false;
-                fTimePosition.bbt.bar         = 1;
-                fTimePosition.bbt.beat        = 1;
-                fTimePosition.bbt.tick        = 0.0;
-                fTimePosition.bbt.beatsPerBar = 4.0f;
-                fTimePosition.bbt.beatType    = 4.0f;
+                fTransport.setTimeSignature(4.f, 4.f);
+                fTransport.setPositionInvalid();
             }
 
-            fTimePosition.bbt.barStartTick = fTimePosition.bbt.ticksPerBeat*
-                                             fTimePosition.bbt.beatsPerBar*
-                                             (fTimePosition.bbt.bar-1);
-
+            fTransport.updateTimePosition(fTimePosition);
             fPlugin.setTimePosition(fTimePosition);
         }
        #endif
@@ -1557,6 +1603,9 @@ public:
 
         if (v3_param_changes** const inparamsptr = data->input_params)
         {
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            const MidiControlMap::ScopedReader midiControls(fMidiControlMap);
+           #endif
             int32_t offset;
             double normalized;
 
@@ -1572,6 +1621,35 @@ public:
                 if (rindex < kVst3InternalParameterCount)
                 {
                    #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+                    // apply MIDI CC events to the parameters bound to them, before running the plugin.
+                    // NOTE this is not sample-accurate: only the last value of the block is applied, like the
+                    // JACK standalone does with its raw MIDI input. The events themselves still reach the plugin
+                    // with their original offsets below.
+                    if (rindex >= kVst3InternalParameterMidiCC_start && rindex <= kVst3InternalParameterMidiCC_end)
+                    {
+                        const uint32_t ccindex = static_cast<uint32_t>(rindex - kVst3InternalParameterMidiCC_start);
+                        const uint8_t channel = static_cast<uint8_t>(ccindex / 130);
+                        const uint8_t control = static_cast<uint8_t>(ccindex % 130);
+                        const uint32_t* indices;
+
+                        if (control < 128)
+                        {
+                            fMidiControlMap.learnControl(channel, control);
+
+                            const uint32_t icount = midiControls.getParameters(channel, control, indices);
+                            const int32_t pcount = icount != 0 ? v3_cpp_obj(queue)->get_point_count(queue) : 0;
+
+                            if (pcount > 0 && v3_cpp_obj(queue)->get_point(queue, pcount - 1, &offset, &normalized) == V3_OK)
+                            {
+                                for (uint32_t j = 0; j < icount; ++j)
+                                {
+                                    _setNormalizedPluginParameterValue(indices[j], normalized);
+                                    fParameterValuesChangedDuringProcessing[kVst3InternalParameterBaseCount + indices[j]] = true;
+                                }
+                            }
+                        }
+                    }
+
                     // if there are any MIDI CC events as parameter changes, handle them here
                     if (canAppendMoreEvents && rindex >= kVst3InternalParameterMidiCC_start && rindex <= kVst3InternalParameterMidiCC_end)
                     {
@@ -1950,14 +2028,15 @@ public:
         const uint32_t index = static_cast<uint32_t>(rindex - kVst3InternalParameterCount);
         DISTRHO_SAFE_ASSERT_UINT2_RETURN(index < fParameterCount, index, fParameterCount, 0.0);
 
-        const ParameterRanges& ranges(fPlugin.getParameterRanges(index));
         const uint32_t hints = fPlugin.getParameterHints(index);
-        float value = ranges.getUnnormalizedValue(normalized);
+        float value = fPlugin.getUnnormalizedParameterValue(index, normalized);
 
         if (hints & kParameterIsBoolean)
         {
-            const float midRange = ranges.min + (ranges.max - ranges.min) / 2.0f;
-            value = value > midRange ? ranges.max : ranges.min;
+            const float min = fPlugin.getParameterMinimum(index);
+            const float max = fPlugin.getParameterMaximum(index);
+            const float midRange = min + (max - min) / 2.0f;
+            value = value > midRange ? max : min;
         }
         else if (hints & kParameterIsInteger)
         {
@@ -2145,6 +2224,23 @@ public:
        #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
         if (std::strcmp(msgid, "midi") == 0)
             return notify_midi(attrs);
+
+        if (std::strcmp(msgid, "midi-learn") == 0)
+            return notify_midi_learn(attrs);
+
+        if (std::strcmp(msgid, "midi-idle") == 0)
+        {
+            // component side, apply a learned binding outside of the audio thread
+            if (fMidiControlMap.idle())
+                sendMidiLearnMessageToOther("midi-learned");
+            return V3_OK;
+        }
+
+        if (std::strcmp(msgid, "midi-learned") == 0)
+        {
+            fMidiLearnPending = false;
+            return V3_OK;
+        }
        #endif
 
        #if DISTRHO_PLUGIN_WANT_STATE
@@ -2206,7 +2302,9 @@ public:
            #endif
 
            #if DISTRHO_PLUGIN_WANT_STATE
-            // Set state
+            // Set state, UI has nothing yet
+            fStateHashesForUI.clear();
+
             for (StringMap::const_iterator cit=fStateMap.begin(), cite=fStateMap.end(); cit != cite; ++cit)
             {
                 const String& key(cit->first);
@@ -2261,6 +2359,16 @@ public:
                                      fCachedParameterValues[kVst3InternalParameterBaseCount + i]);
             }
 
+           #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+            // MIDI learn is captured on the audio thread, the binding is applied here
+           #if DPF_VST3_USES_SEPARATE_CONTROLLER
+            if (fMidiLearnPending)
+                sendMidiLearnMessageToOther("midi-idle");
+           #else
+            fMidiControlMap.idle();
+           #endif
+           #endif
+
             sendReadyToUI();
             return V3_OK;
         }
@@ -2333,6 +2441,22 @@ public:
             return notify_midi(attrs);
            #endif
         }
+
+        if (std::strcmp(msgid, "midi-learn") == 0)
+        {
+           #if DPF_VST3_USES_SEPARATE_CONTROLLER
+            int64_t index;
+            const v3_result res = v3_cpp_obj(attrs)->get_int(attrs, "index", &index);
+            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+
+            fMidiLearnPending = index >= 0;
+
+            DISTRHO_SAFE_ASSERT_RETURN(fConnectionFromCompToCtrl != nullptr, V3_INTERNAL_ERR);
+            return v3_cpp_obj(fConnectionFromCompToCtrl)->notify(fConnectionFromCompToCtrl, message);
+           #else
+            return notify_midi_learn(attrs);
+           #endif
+        }
        #endif
 
        #if DISTRHO_PLUGIN_WANT_STATE
@@ -2361,56 +2485,29 @@ public:
    #if DISTRHO_PLUGIN_WANT_STATE
     v3_result notify_state(v3_attribute_list** const attrs)
     {
-        int64_t keyLength = -1;
-        int64_t valueLength = -1;
-        v3_result res;
-
-        res = v3_cpp_obj(attrs)->get_int(attrs, "key:length", &keyLength);
-        DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
-        DISTRHO_SAFE_ASSERT_INT_RETURN(keyLength >= 0, keyLength, V3_INTERNAL_ERR);
-
-        res = v3_cpp_obj(attrs)->get_int(attrs, "value:length", &valueLength);
-        DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
-        DISTRHO_SAFE_ASSERT_INT_RETURN(valueLength >= 0, valueLength, V3_INTERNAL_ERR);
-
-        int16_t* const key16 = (int16_t*)std::malloc(sizeof(int16_t)*(keyLength + 1));
-        DISTRHO_SAFE_ASSERT_RETURN(key16 != nullptr, V3_NOMEM);
-
-        int16_t* const value16 = (int16_t*)std::malloc(sizeof(int16_t)*(valueLength + 1));
-        DISTRHO_SAFE_ASSERT_RETURN(value16 != nullptr, V3_NOMEM);
+        const v3_result res = fStateReceiver.receive(attrs);
 
-        res = v3_cpp_obj(attrs)->get_string(attrs, "key", key16, sizeof(int16_t)*(keyLength+1));
-        DISTRHO_SAFE_ASSERT_INT2_RETURN(res == V3_OK, res, keyLength, res);
-
-        if (valueLength != 0)
-        {
-            res = v3_cpp_obj(attrs)->get_string(attrs, "value", value16, sizeof(int16_t)*(valueLength+1));
-            DISTRHO_SAFE_ASSERT_INT2_RETURN(res == V3_OK, res, valueLength, res);
-        }
-
-        // do cheap inline conversion
-        char* const key = (char*)key16;
-        char* const value = (char*)value16;
+        // waiting for more chunks
+        if (res == V3_FALSE)
+            return V3_OK;
 
-        for (int64_t i=0; i<keyLength; ++i)
-            key[i] = key16[i];
-        for (int64_t i=0; i<valueLength; ++i)
-            value[i] = value16[i];
+        if (res != V3_OK)
+            return res;
 
-        key[keyLength] = '\0';
-        value[valueLength] = '\0';
+        const String& key(fStateReceiver.key);
+        const char* const value = fStateReceiver.value;
 
         fPlugin.setState(key, value);
 
         // save this key as needed
         if (fPlugin.wantStateKey(key))
-        {
-            const String dkey(key);
-            fStateMap[dkey] = value;
-        }
+            fStateMap[key] = value;
+
+       #if DISTRHO_PLUGIN_HAS_UI
+        // value came from the UI or was forwarded by the controller, either way the UI has it already
+        fStateHashesForUI.update(key, value);
+       #endif
 
-        std::free(key16);
-        std::free(value16);
         return V3_OK;
     }
    #endif // DISTRHO_PLUGIN_WANT_STATE
@@ -2430,6 +2527,24 @@ public:
 
         return fNotesRingBuffer.writeCustomData(data, size) && fNotesRingBuffer.commitWrite() ? V3_OK : V3_NOMEM;
     }
+
+    v3_result notify_midi_learn(v3_attribute_list** const attrs)
+    {
+        int64_t index;
+        const v3_result res = v3_cpp_obj(attrs)->get_int(attrs, "index", &index);
+        DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
+
+        if (index < 0)
+        {
+            fMidiControlMap.cancelLearning();
+            return V3_OK;
+        }
+
+        DISTRHO_SAFE_ASSERT_INT2_RETURN(index < fParameterCount, index, fParameterCount, V3_INVALID_ARG);
+
+        fMidiControlMap.startLearning(index);
+        return V3_OK;
+    }
    #endif // DISTRHO_PLUGIN_WANT_MIDI_INPUT
 #endif
 
@@ -2468,11 +2583,15 @@ private:
     bool* fParameterValueChangesForUI; // basic offset + real
     bool fConnectedToUI;
    #endif
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT && DPF_VST3_USES_SEPARATE_CONTROLLER
+    bool fMidiLearnPending; // controller side, waiting for the component to apply a binding
+   #endif
    #if DISTRHO_PLUGIN_WANT_LATENCY
     uint32_t fLastKnownLatency;
    #endif
   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
     MidiEvent fMidiEvents[kMaxMidiEvents];
+    MidiControlMap fMidiControlMap;
    #if DISTRHO_PLUGIN_HAS_UI
     SmallStackRingBuffer fNotesRingBuffer;
    #endif
@@ -2486,9 +2605,14 @@ private:
    #endif
    #if DISTRHO_PLUGIN_WANT_STATE
     StringMap fStateMap;
+    StateMessageReceiver fStateReceiver;
+   #if DISTRHO_PLUGIN_HAS_UI
+    StateHashes fStateHashesForUI;
+   #endif
    #endif
    #if DISTRHO_PLUGIN_WANT_TIMEPOS
     TimePosition fTimePosition;
+    TransportEngine fTransport;
    #endif
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -3005,37 +3129,65 @@ private:
         v3_cpp_obj_unref(message);
     }
 
-    void sendStateSetToUI(const char* const key, const char* const value) const
+   #if DISTRHO_PLUGIN_WANT_STATE
+    void sendStateSetToUI(const char* const key, const char* const value)
+    {
+        // skip values the UI already has
+        if (! fStateHashesForUI.update(key, value))
+            return;
+
+        const uint32_t valueLength = static_cast<uint32_t>(std::strlen(value));
+        uint32_t offset = 0;
+
+        do {
+            v3_message** const message = createMessage("state-set");
+            DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
+
+            v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
+            DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
+
+            v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 2);
+            setStateMessageChunk(attrlist, key, value, valueLength, offset);
+            v3_cpp_obj(fConnectionFromCtrlToView)->notify(fConnectionFromCtrlToView, message);
+
+            v3_cpp_obj_unref(message);
+            offset += kVst3StateChunkSize;
+        } while (offset < valueLength);
+    }
+   #endif
+
+    void sendReadyToUI() const
     {
-        v3_message** const message = createMessage("state-set");
+        v3_message** const message = createMessage("ready");
         DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
 
         v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
         DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
 
         v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 2);
-        v3_cpp_obj(attrlist)->set_int(attrlist, "key:length", std::strlen(key));
-        v3_cpp_obj(attrlist)->set_int(attrlist, "value:length", std::strlen(value));
-        v3_cpp_obj(attrlist)->set_string(attrlist, "key", ScopedUTF16String(key));
-        v3_cpp_obj(attrlist)->set_string(attrlist, "value", ScopedUTF16String(value));
         v3_cpp_obj(fConnectionFromCtrlToView)->notify(fConnectionFromCtrlToView, message);
 
         v3_cpp_obj_unref(message);
     }
 
-    void sendReadyToUI() const
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT && DPF_VST3_USES_SEPARATE_CONTROLLER
+    // "midi-idle" goes from controller to component, "midi-learned" from component back to controller
+    void sendMidiLearnMessageToOther(const char* const id) const
     {
-        v3_message** const message = createMessage("ready");
+        DISTRHO_SAFE_ASSERT_RETURN(fConnectionFromCompToCtrl != nullptr,);
+
+        v3_message** const message = createMessage(id);
         DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
 
         v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
         DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
 
-        v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 2);
-        v3_cpp_obj(fConnectionFromCtrlToView)->notify(fConnectionFromCtrlToView, message);
+        v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 1);
+        v3_cpp_obj(fConnectionFromCompToCtrl)->notify(fConnectionFromCompToCtrl, message);
 
         v3_cpp_obj_unref(message);
     }
+   #endif
    #endif
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -325,6 +325,11 @@ void UI::sendNote(uint8_t channel, uint8_t note, uint8_t velocity)
 {
     uiData->sendNoteCallback(channel, note, velocity);
 }
+
+void UI::requestParameterMidiLearn(const int32_t index)
+{
+    uiData->midiLearnCallback(index);
+}
 #endif
 
 #if DISTRHO_UI_FILE_BROWSER
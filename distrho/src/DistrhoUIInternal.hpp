@@ -30,6 +30,10 @@ extern uintptr_t   g_nextWindowId;
 extern double      g_nextScaleFactor;
 #endif
 
+#if DISTRHO_PLUGIN_HAS_EXTERNAL_UI && !defined(DISTRHO_OS_WINDOWS)
+# define DPF_UI_USING_EXTERNAL_CHANNEL
+#endif
+
 // -----------------------------------------------------------------------
 // UI exporter class
 
@@ -41,6 +45,40 @@ class UIExporter
     UI* ui;
     UI::PrivateData* uiData;
 
+   #ifdef DPF_UI_USING_EXTERNAL_CHANNEL
+    // messages coming from an external process, sent to the plugin as if they came from the UI
+    struct ExternalReceiver : ExternalChannel::Receiver {
+        UI* ui;
+
+        ExternalReceiver() noexcept
+            : ui(nullptr) {}
+
+        void parameterReceived(const uint32_t index, const float value) override
+        {
+            ui->setParameterValue(index, value);
+        }
+
+       #if DISTRHO_PLUGIN_WANT_STATE
+        void stateReceived(const char* const key, const char* const value) override
+        {
+            ui->setState(key, value);
+        }
+       #endif
+
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        void noteReceived(const uint8_t channel, const uint8_t note, const uint8_t velocity) override
+        {
+            ui->sendNote(channel, note, velocity);
+        }
+       #endif
+
+        void dataReceived(const void* const data, const uint32_t size) override
+        {
+            ui->externalDataReceived(data, size);
+        }
+    } externalReceiver;
+   #endif
+
     // -------------------------------------------------------------------
 
 public:
@@ -61,6 +99,9 @@ public:
                const char* const appClassName = nullptr)
         : ui(nullptr),
           uiData(new UI::PrivateData(appClassName))
+         #ifdef DPF_UI_USING_EXTERNAL_CHANNEL
+        , externalReceiver()
+         #endif
     {
         uiData->sampleRate = sampleRate;
         uiData->bundlePath = bundlePath != nullptr ? strdup(bundlePath) : nullptr;
@@ -102,6 +143,10 @@ public:
         ui = uiPtr;
         uiData->initializing = false;
 
+       #ifdef DPF_UI_USING_EXTERNAL_CHANNEL
+        externalReceiver.ui = uiPtr;
+       #endif
+
 #if !DISTRHO_PLUGIN_HAS_EXTERNAL_UI
         // unused
         (void)bundlePath;
@@ -185,6 +230,16 @@ public:
         return uiData->parameterOffset;
     }
 
+   #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+    // only set by plugin formats that support MIDI learn
+    void setMidiLearnCallback(const midiLearnFunc midiLearnCall) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(uiData != nullptr,);
+
+        uiData->midiLearnCallbackFunc = midiLearnCall;
+    }
+   #endif
+
     // -------------------------------------------------------------------
 
     void parameterChanged(const uint32_t index, const float value)
@@ -192,6 +247,11 @@ public:
         DISTRHO_SAFE_ASSERT_RETURN(ui != nullptr,);
 
         ui->parameterChanged(index, value);
+
+       #ifdef DPF_UI_USING_EXTERNAL_CHANNEL
+        if (ui->ext.channel.isValid())
+            ui->ext.channel.sendParameter(index, value);
+       #endif
     }
 
    #if DISTRHO_PLUGIN_WANT_PROGRAMS
@@ -211,6 +271,11 @@ public:
         DISTRHO_SAFE_ASSERT_RETURN(value != nullptr,);
 
         ui->stateChanged(key, value);
+
+       #ifdef DPF_UI_USING_EXTERNAL_CHANNEL
+        if (ui->ext.channel.isValid())
+            ui->ext.channel.sendState(key, value);
+       #endif
     }
    #endif
 
@@ -231,6 +296,7 @@ public:
     {
         DISTRHO_SAFE_ASSERT_RETURN(ui != nullptr, );
 
+        idleExternalChannel();
         ui->uiIdle();
         uiData->app.repaintIfNeeeded();
     }
@@ -247,6 +313,7 @@ public:
         DISTRHO_SAFE_ASSERT_RETURN(ui != nullptr, false);
 
         uiData->app.idle();
+        idleExternalChannel();
         ui->uiIdle();
         uiData->app.repaintIfNeeeded();
         return ! uiData->app.isQuitting();
@@ -278,6 +345,7 @@ public:
         DISTRHO_SAFE_ASSERT_RETURN(ui != nullptr,);
 
         uiData->app.triggerIdleCallbacks();
+        idleExternalChannel();
         ui->uiIdle();
         uiData->app.repaintIfNeeeded();
     }
@@ -407,6 +475,15 @@ public:
             ui->sampleRateChanged(sampleRate);
     }
 
+private:
+    void idleExternalChannel()
+    {
+       #ifdef DPF_UI_USING_EXTERNAL_CHANNEL
+        if (ui->ext.channel.isValid())
+            ui->ext.channel.readMessages(externalReceiver);
+       #endif
+    }
+
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UIExporter)
 };
 
@@ -329,6 +329,7 @@ typedef void (*editParamFunc)   (void* ptr, uint32_t rindex, bool started);
 typedef void (*setParamFunc)    (void* ptr, uint32_t rindex, float value);
 typedef void (*setStateFunc)    (void* ptr, const char* key, const char* value);
 typedef void (*sendNoteFunc)    (void* ptr, uint8_t channel, uint8_t note, uint8_t velo);
+typedef void (*midiLearnFunc)   (void* ptr, int32_t index);
 typedef void (*setSizeFunc)     (void* ptr, uint width, uint height);
 typedef bool (*fileRequestFunc) (void* ptr, const char* key);
 
@@ -365,6 +366,7 @@ struct UI::PrivateData {
     setParamFunc    setParamCallbackFunc;
     setStateFunc    setStateCallbackFunc;
     sendNoteFunc    sendNoteCallbackFunc;
+    midiLearnFunc   midiLearnCallbackFunc;
     setSizeFunc     setSizeCallbackFunc;
     fileRequestFunc fileRequestCallbackFunc;
 
@@ -388,6 +390,7 @@ struct UI::PrivateData {
           setParamCallbackFunc(nullptr),
           setStateCallbackFunc(nullptr),
           sendNoteCallbackFunc(nullptr),
+          midiLearnCallbackFunc(nullptr),
           setSizeCallbackFunc(nullptr),
           fileRequestCallbackFunc(nullptr)
     {
@@ -444,6 +447,12 @@ struct UI::PrivateData {
             sendNoteCallbackFunc(callbacksPtr, channel, note, velocity);
     }
 
+    void midiLearnCallback(const int32_t index)
+    {
+        if (midiLearnCallbackFunc != nullptr)
+            midiLearnCallbackFunc(callbacksPtr, index);
+    }
+
     void setSizeCallback(const uint width, const uint height)
     {
         if (setSizeCallbackFunc != nullptr)
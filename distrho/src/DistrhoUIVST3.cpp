@@ -347,6 +347,9 @@ public:
               instancePointer,
               scaleFactor)
     {
+       #if DISTRHO_PLUGIN_WANT_MIDI_INPUT
+        fUI.setMidiLearnCallback(midiLearnCallback);
+       #endif
     }
 
     ~UIVst3()
@@ -614,49 +617,18 @@ public:
        #if DISTRHO_PLUGIN_WANT_STATE
         if (std::strcmp(msgid, "state-set") == 0)
         {
-            int64_t keyLength = -1;
-            int64_t valueLength = -1;
-            v3_result res;
+            const v3_result res = fStateReceiver.receive(attrs);
 
-            res = v3_cpp_obj(attrs)->get_int(attrs, "key:length", &keyLength);
-            DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
-            DISTRHO_SAFE_ASSERT_INT_RETURN(keyLength >= 0, keyLength, V3_INTERNAL_ERR);
+            // waiting for more chunks
+            if (res == V3_FALSE)
+                return V3_OK;
 
-            res = v3_cpp_obj(attrs)->get_int(attrs, "value:length", &valueLength);
             DISTRHO_SAFE_ASSERT_INT_RETURN(res == V3_OK, res, res);
-            DISTRHO_SAFE_ASSERT_INT_RETURN(valueLength >= 0, valueLength, V3_INTERNAL_ERR);
-
-            int16_t* const key16 = (int16_t*)std::malloc(sizeof(int16_t)*(keyLength + 1));
-            DISTRHO_SAFE_ASSERT_RETURN(key16 != nullptr, V3_NOMEM);
-
-            int16_t* const value16 = (int16_t*)std::malloc(sizeof(int16_t)*(valueLength + 1));
-            DISTRHO_SAFE_ASSERT_RETURN(value16 != nullptr, V3_NOMEM);
-
-            res = v3_cpp_obj(attrs)->get_string(attrs, "key", key16, sizeof(int16_t)*(keyLength+1));
-            DISTRHO_SAFE_ASSERT_INT2_RETURN(res == V3_OK, res, keyLength, res);
-
-            if (valueLength != 0)
-            {
-                res = v3_cpp_obj(attrs)->get_string(attrs, "value", value16, sizeof(int16_t)*(valueLength+1));
-                DISTRHO_SAFE_ASSERT_INT2_RETURN(res == V3_OK, res, valueLength, res);
-            }
 
-            // do cheap inline conversion
-            char* const key = (char*)key16;
-            char* const value = (char*)value16;
+            // no need to send this value back
+            fStateHashes.update(fStateReceiver.key, fStateReceiver.value);
 
-            for (int64_t i=0; i<keyLength; ++i)
-                key[i] = key16[i];
-            for (int64_t i=0; i<valueLength; ++i)
-                value[i] = value16[i];
-
-            key[keyLength] = '\0';
-            value[valueLength] = '\0';
-
-            fUI.stateChanged(key, value);
-
-            std::free(key16);
-            std::free(value16);
+            fUI.stateChanged(fStateReceiver.key, fStateReceiver.value);
             return V3_OK;
         }
        #endif
@@ -742,6 +714,10 @@ private:
     bool fIsResizingFromHost;
     bool fNeedsResizeFromPlugin;
     v3_view_rect fNextPluginRect; // for when plugin requests a new size
+   #if DISTRHO_PLUGIN_WANT_STATE
+    StateMessageReceiver fStateReceiver;
+    StateHashes fStateHashes;
+   #endif
 
     // Plugin UI (after VST3 stuff so the UI can call into us during its constructor)
     UIExporter fUI;
@@ -834,20 +810,27 @@ private:
     {
         DISTRHO_SAFE_ASSERT_RETURN(fConnection != nullptr,);
 
-        v3_message** const message = createMessage("state-set");
-        DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
+        // skip values the controller already has
+        if (! fStateHashes.update(key, value))
+            return;
 
-        v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
-        DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
+        const uint32_t valueLength = static_cast<uint32_t>(std::strlen(value));
+        uint32_t offset = 0;
 
-        v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 1);
-        v3_cpp_obj(attrlist)->set_int(attrlist, "key:length", std::strlen(key));
-        v3_cpp_obj(attrlist)->set_int(attrlist, "value:length", std::strlen(value));
-        v3_cpp_obj(attrlist)->set_string(attrlist, "key", ScopedUTF16String(key));
-        v3_cpp_obj(attrlist)->set_string(attrlist, "value", ScopedUTF16String(value));
-        v3_cpp_obj(fConnection)->notify(fConnection, message);
+        do {
+            v3_message** const message = createMessage("state-set");
+            DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
 
-        v3_cpp_obj_unref(message);
+            v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
+            DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
+
+            v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 1);
+            setStateMessageChunk(attrlist, key, value, valueLength, offset);
+            v3_cpp_obj(fConnection)->notify(fConnection, message);
+
+            v3_cpp_obj_unref(message);
+            offset += kVst3StateChunkSize;
+        } while (offset < valueLength);
     }
 
     static void setStateCallback(void* const ptr, const char* const key, const char* const value)
@@ -883,6 +866,28 @@ private:
     {
         static_cast<UIVst3*>(ptr)->sendNote(channel, note, velocity);
     }
+
+    void requestMidiLearn(const int32_t index)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(fConnection != nullptr,);
+
+        v3_message** const message = createMessage("midi-learn");
+        DISTRHO_SAFE_ASSERT_RETURN(message != nullptr,);
+
+        v3_attribute_list** const attrlist = v3_cpp_obj(message)->get_attributes(message);
+        DISTRHO_SAFE_ASSERT_RETURN(attrlist != nullptr,);
+
+        v3_cpp_obj(attrlist)->set_int(attrlist, "__dpf_msg_target__", 1);
+        v3_cpp_obj(attrlist)->set_int(attrlist, "index", index);
+        v3_cpp_obj(fConnection)->notify(fConnection, message);
+
+        v3_cpp_obj_unref(message);
+    }
+
+    static void midiLearnCallback(void* const ptr, const int32_t index)
+    {
+        static_cast<UIVst3*>(ptr)->requestMidiLearn(index);
+    }
    #endif
 
     void setSize(uint width, uint height)
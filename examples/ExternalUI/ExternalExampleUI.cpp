@@ -19,28 +19,25 @@
 
 #include "DistrhoUI.hpp"
 
-#define MPV_TEST
-// #define KDE_FIFO_TEST
+// #define MPV_TEST
+#define KDE_TEST
 
-#ifdef KDE_FIFO_TEST
-// Extra includes for current path and fifo stuff
+#ifdef KDE_TEST
+// Extra includes for current path
 #include <dlfcn.h>
-#include <fcntl.h>
-#include <sys/stat.h>
-#include <sys/types.h>
 #endif
 
 START_NAMESPACE_DISTRHO
 
-#ifdef KDE_FIFO_TEST
-// TODO: generate a random, not-yet-existing, filename
-const char* const kFifoFilename = "/tmp/dpf-fifo-test";
+#ifdef KDE_TEST
+// Name of the helper program that talks to kdialog
+const char* const kExternalProcessName = "d_extui-process";
 
 // Helper to get current path of this plugin
 static const char* getCurrentPluginFilename()
 {
     Dl_info exeInfo;
-    void* localSymbol = (void*)kFifoFilename;
+    void* localSymbol = (void*)kExternalProcessName;
     dladdr(localSymbol, &exeInfo);
     return exeInfo.dli_fname;
 }
@@ -50,20 +47,6 @@ static bool fileExists(const char* const filename)
 {
     return access(filename, F_OK) != -1;
 }
-
-// Helper function to keep trying to write until it succeeds or really errors out
-static ssize_t
-writeRetry(int fd, const void* src, size_t size)
-{
-    ssize_t error;
-    int attempts = 0;
-
-    do {
-        error = write(fd, src, size);
-    } while (error == -1 && (errno == EINTR || errno == EPIPE) && ++attempts < 5);
-
-    return error;
-}
 #endif
 
 // -----------------------------------------------------------------------------------------------------------
@@ -73,21 +56,26 @@ class ExternalExampleUI : public UI
 public:
     ExternalExampleUI()
         : UI(405, 256),
-         #ifdef KDE_FIFO_TEST
-          fFifo(-1),
-          fExternalScript(getNextBundlePath()),
+         #ifdef KDE_TEST
+          fExternalProcess(getNextBundlePath()),
          #endif
           fValue(0.0f)
     {
-       #ifdef KDE_FIFO_TEST
-        if (fExternalScript.isEmpty())
-        {
-            fExternalScript = getCurrentPluginFilename();
-            fExternalScript.truncate(fExternalScript.rfind('/'));
-        }
+       #ifdef KDE_TEST
+        // the helper is built next to the plugin bundle, or next to the plugin binary when there is no bundle
+        if (fExternalProcess.isEmpty())
+            fExternalProcess = getCurrentPluginFilename();
+        else if (fExternalProcess.endsWith('/'))
+            fExternalProcess.truncate(fExternalProcess.length() - 1);
+
+        fExternalProcess.truncate(fExternalProcess.rfind('/') + 1);
+        fExternalProcess += kExternalProcessName;
 
-        fExternalScript += "/ExternalLauncher.sh";
-        d_stdout("External script = %s", fExternalScript.buffer());
+        // fallback to PATH lookup
+        if (! fileExists(fExternalProcess))
+            fExternalProcess = kExternalProcessName;
+
+        d_stdout("External process = %s", fExternalProcess.buffer());
        #endif
 
         if (isVisible() || isEmbed())
@@ -113,83 +101,35 @@ protected:
         if (index != 0)
             return;
 
+        // cached for when the external process starts, DPF sends changes to it while running
         fValue = value;
-
-       #ifdef KDE_FIFO_TEST
-        if (fFifo == -1)
-            return;
-
-        // NOTE: This is a terrible way to pass values, also locale might get in the way...
-        char valueStr[24];
-        std::memset(valueStr, 0, sizeof(valueStr));
-        std::snprintf(valueStr, 23, "%i\n", static_cast<int>(value + 0.5f));
-
-        DISTRHO_SAFE_ASSERT(writeRetry(fFifo, valueStr, 24) == sizeof(valueStr));
-       #endif
     }
 
    /* --------------------------------------------------------------------------------------------------------
     * External Window overrides */
 
-   /**
-      Keep-alive.
-    */
-    void uiIdle() override
-    {
-       #ifdef KDE_FIFO_TEST
-        if (fFifo == -1)
-            return;
-
-        writeRetry(fFifo, "idle\n", 5);
-       #endif
-    }
-
    /**
       Manage external process and IPC when UI is requested to be visible.
     */
     void visibilityChanged(const bool visible) override
     {
-       #ifdef KDE_FIFO_TEST
+       #ifdef KDE_TEST
         if (visible)
         {
-            DISTRHO_SAFE_ASSERT_RETURN(fileExists(fExternalScript),);
-
-            mkfifo(kFifoFilename, 0666);
-            sync();
-
-            char winIdStr[24];
-            std::memset(winIdStr, 0, sizeof(winIdStr));
-            std::snprintf(winIdStr, 23, "%lu", getTransientWindowId());
+            // initial value is passed as argument, the external process receives changes through ExternalChannel
+            char valueStr[24];
+            std::snprintf(valueStr, sizeof(valueStr), "%i", static_cast<int>(fValue + 0.5f));
 
             const char* args[] = {
-                fExternalScript.buffer(),
-                kFifoFilename,
-                "--progressbar", "External UI example",
-                "--title", getTitle(),
+                fExternalProcess.buffer(),
+                getTitle(),
+                valueStr,
                 nullptr,
             };
             DISTRHO_SAFE_ASSERT_RETURN(startExternalProcess(args),);
-
-            // NOTE: this can lockup the current thread if the other side does not read the file!
-            fFifo = open(kFifoFilename, O_WRONLY);
-            DISTRHO_SAFE_ASSERT_RETURN(fFifo != -1,);
-
-            parameterChanged(0, fValue);
         }
         else
         {
-            if (fFifo != -1)
-            {
-                if (isRunning())
-                {
-                    DISTRHO_SAFE_ASSERT(writeRetry(fFifo, "quit\n", 5) == 5);
-                    fsync(fFifo);
-                }
-                ::close(fFifo);
-                fFifo = -1;
-            }
-
-            unlink(kFifoFilename);
             terminateAndWaitForExternalProcess();
         }
        #endif
@@ -233,12 +173,9 @@ protected:
     // -------------------------------------------------------------------------------------------------------
 
 private:
-   #ifdef KDE_FIFO_TEST
-    // IPC Stuff
-    int fFifo;
-
-    // Path to external ui script
-    String fExternalScript;
+   #ifdef KDE_TEST
+    // Path to external ui process
+    String fExternalProcess;
    #endif
 
     // Current value, cached for when UI becomes visible
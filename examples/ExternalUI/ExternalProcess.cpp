@@ -0,0 +1,154 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+// External process started by ExternalExampleUI.
+// It connects to the plugin UI through ExternalChannel and shows the parameter value in a kdialog progressbar.
+// This is still a very ugly way to show a remote UI, but it is only to prove the point.
+
+#include "extra/ExternalChannel.hpp"
+
+#include <csignal>
+
+USE_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------------------------------------------
+
+static volatile sig_atomic_t gQuit = 0;
+
+static void signalHandler(int)
+{
+    gQuit = 1;
+}
+
+// Helper to pass arbitrary text as a single shell argument
+static String shellQuote(const char* const text)
+{
+    String quoted("'");
+
+    for (const char* c = text; *c != '\0'; ++c)
+    {
+        if (*c == '\'')
+            quoted += "'\\''";
+        else
+            quoted += String(*c);
+    }
+
+    quoted += "'";
+    return quoted;
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+class KDialogProgressBar : public ExternalChannel::Receiver
+{
+public:
+    KDialogProgressBar()
+        : fDBusRef() {}
+
+    ~KDialogProgressBar() override
+    {
+        if (fDBusRef.isNotEmpty())
+            qdbus("close");
+    }
+
+    bool open(const char* const title)
+    {
+        const String cmd("kdialog --title " + shellQuote(title) + " --progressbar 'External UI example' 100");
+
+        FILE* const proc = ::popen(cmd, "r");
+        DISTRHO_SAFE_ASSERT_RETURN(proc != nullptr, false);
+
+        // kdialog prints its dbus service and object path, like "org.kde.kdialog-123 /ProgressDialog"
+        char ref[256] = {};
+        const bool ok = std::fgets(ref, sizeof(ref), proc) != nullptr;
+        ::pclose(proc);
+        DISTRHO_SAFE_ASSERT_RETURN(ok, false);
+
+        fDBusRef = ref;
+        fDBusRef.replace('\n', '\0');
+        return fDBusRef.isNotEmpty();
+    }
+
+    void parameterReceived(const uint32_t index, const float value) override
+    {
+        if (index != 0)
+            return;
+
+        char cmd[64];
+        std::snprintf(cmd, sizeof(cmd), "Set '' value %i", static_cast<int>(value + 0.5f));
+        qdbus(cmd);
+    }
+
+private:
+    String fDBusRef;
+
+    void qdbus(const char* const args)
+    {
+        const String cmd("qdbus " + fDBusRef + " " + args + " >/dev/null");
+        DISTRHO_SAFE_ASSERT(std::system(cmd) == 0);
+    }
+};
+
+// -----------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        d_stderr("usage: %s <title> <initial-value>", argv[0]);
+        return 1;
+    }
+
+    ExternalChannel channel;
+
+    if (! channel.attach())
+    {
+        d_stderr("%s must be started by the ExternalUI plugin", argv[0]);
+        return 1;
+    }
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    KDialogProgressBar progressBar;
+
+    if (! progressBar.open(argv[1]))
+        return 1;
+
+    progressBar.parameterReceived(0, std::atof(argv[2]));
+
+    struct pollfd pfd;
+    pfd.fd = channel.getWakeupFd();
+    pfd.events = POLLIN;
+
+    while (gQuit == 0)
+    {
+        pfd.revents = 0;
+
+        if (::poll(&pfd, 1, 1000) < 0)
+            continue;
+
+        // the plugin side closed the channel
+        if (pfd.revents & (POLLHUP|POLLERR))
+            break;
+
+        channel.readMessages(progressBar);
+    }
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------------------------------------
@@ -28,4 +28,7 @@
 #define DISTRHO_PLUGIN_NUM_OUTPUTS  1
 #define DISTRHO_PLUGIN_WANT_LATENCY 1
 
+// inputs never alias outputs, DPF takes care of copying them if the host uses the same buffers
+#define DISTRHO_PLUGIN_SUPPORTS_IN_PLACE 0
+
 #endif // DISTRHO_PLUGIN_INFO_H_INCLUDED
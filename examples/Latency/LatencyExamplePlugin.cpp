@@ -192,10 +192,10 @@ protected:
         const float* const in  = inputs[0];
         /* */ float* const out = outputs[0];
 
+        // no need to check for in-place processing, this plugin does not support it (see DistrhoPluginInfo.h)
         if (fLatencyInFrames == 0)
         {
-            if (out != in)
-                std::memcpy(out, in, sizeof(float)*frames);
+            std::memcpy(out, in, sizeof(float)*frames);
             return;
         }
 
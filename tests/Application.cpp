@@ -38,6 +38,24 @@ struct IdleCallbackCounter : IdleCallback
     }
 };
 
+// runs a nested idle cycle on its first call, like a modal window event loop would
+struct IdleCallbackNested : IdleCallbackCounter
+{
+    Application& app;
+
+    IdleCallbackNested(Application& a)
+        : app(a) {}
+
+    void idleCallback() override
+    {
+        if (++counter != 1)
+            return;
+
+        d_msleep(5);
+        app.idle();
+    }
+};
+
 // --------------------------------------------------------------------------------------------------------------------
 
 END_NAMESPACE_DGL
@@ -63,6 +81,21 @@ int main()
         DISTRHO_ASSERT_EQUAL(idleCounter.counter, 2, "app MUST have triggered only 2 idle callbacks in its lifetime");
     }
 
+    // nested idle from a scheduled callback must not drop callbacks due in the outer cycle
+    {
+        Application app(true);
+        IdleCallbackNested nested(app);
+        IdleCallbackCounter idleCounter;
+        app.addIdleCallback(&nested, 1);
+        app.addIdleCallback(&idleCounter, 2);
+        d_msleep(5);
+        app.idle();
+        DISTRHO_ASSERT_EQUAL(nested.counter, 2, "nested callback MUST have triggered in both cycles");
+        DISTRHO_ASSERT_EQUAL(idleCounter.counter, 2, "other callback MUST have triggered in both cycles");
+        app.removeIdleCallback(&idleCounter);
+        app.removeIdleCallback(&nested);
+    }
+
     // standalone exec, must not block forever due to quit() called from another thread
     {
         Application app(true);
@@ -0,0 +1,177 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+// NOTE: drawing is offscreen, but creating the window still needs a display connection, use Xvfb on CI
+
+#include "tests.hpp"
+
+#include "widgets/ExampleColorWidget.hpp"
+#include "widgets/ExampleImagesWidget.hpp"
+#include "widgets/ExampleRectanglesWidget.hpp"
+#include "widgets/ExampleShapesWidget.hpp"
+
+#include "images_res/CatPics.cpp"
+
+#include "../dgl/Cairo.hpp"
+#include "../dgl/TopLevelWidget.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+START_NAMESPACE_DGL
+
+typedef CairoImage DemoImage;
+
+template<> inline
+ExampleImagesWidget<SubWidget, DemoImage>::ExampleImagesWidget(Widget* const parentWidget)
+: SubWidget(parentWidget) { init(parentWidget->getApp()); }
+
+typedef ExampleImagesWidget<SubWidget, DemoImage> ExampleImagesSubWidget;
+
+// --------------------------------------------------------------------------------------------------------------------
+// top-level widget with all example widgets laid out in a grid
+
+class BenchmarkWidget : public TopLevelWidget
+{
+public:
+    static const uint kCellWidth = 500;
+    static const uint kCellHeight = 400;
+
+    ExampleColorSubWidget wColor;
+    ExampleImagesSubWidget wImages;
+    ExampleRectanglesSubWidget wRects;
+    ExampleShapesSubWidget wShapes;
+
+    BenchmarkWidget(Window& window)
+        : TopLevelWidget(window),
+          wColor(this),
+          wImages(this),
+          wRects(this),
+          wShapes(this)
+    {
+        const Size<uint> cellSize(kCellWidth, kCellHeight);
+
+        wColor.setSize(cellSize);
+        wImages.setSize(cellSize);
+        wRects.setSize(cellSize);
+        wShapes.setSize(cellSize);
+
+        wImages.setAbsolutePos(kCellWidth, 0);
+        wRects.setAbsolutePos(0, kCellHeight);
+        wShapes.setAbsolutePos(kCellWidth, kCellHeight);
+    }
+
+protected:
+    void onDisplay() override {}
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// accumulates draw timings per widget
+
+class BenchmarkTimings : public Window::DisplayTimingCallback
+{
+public:
+    struct Entry {
+        Widget* widget;
+        const char* name;
+        double total;
+        double max;
+    };
+
+    std::vector<Entry> entries;
+
+    void add(Widget* const widget, const char* const name)
+    {
+        const Entry entry = { widget, name, 0.0, 0.0 };
+        entries.push_back(entry);
+    }
+
+    void widgetDisplayed(Widget* const widget, const double seconds) override
+    {
+        for (std::vector<Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            Entry& entry(*it);
+
+            if (entry.widget != widget)
+                continue;
+
+            entry.total += seconds;
+            if (entry.max < seconds)
+                entry.max = seconds;
+            return;
+        }
+    }
+};
+
+END_NAMESPACE_DGL
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    USE_NAMESPACE_DGL;
+
+    const uint numFrames = argc > 1 ? static_cast<uint>(std::atoi(argv[1])) : 500;
+    DISTRHO_SAFE_ASSERT_RETURN(numFrames != 0, 1);
+
+    Application app(true);
+    Window win(app);
+    win.setSize(BenchmarkWidget::kCellWidth * 2, BenchmarkWidget::kCellHeight * 2);
+
+    BenchmarkWidget widget(win);
+
+    BenchmarkTimings timings;
+    timings.add(&widget, "(all)");
+    timings.add(&widget.wColor, ExampleColorSubWidget::kExampleWidgetName);
+    timings.add(&widget.wImages, ExampleImagesSubWidget::kExampleWidgetName);
+    timings.add(&widget.wRects, ExampleRectanglesSubWidget::kExampleWidgetName);
+    timings.add(&widget.wShapes, ExampleShapesSubWidget::kExampleWidgetName);
+    win.setDisplayTimingCallback(&timings);
+
+    const uint width = win.getWidth();
+    const uint height = win.getHeight();
+    const uint stride = width * 4;
+    uint8_t* const pixels = new uint8_t[stride * height];
+
+    for (uint i = 0; i < numFrames; ++i)
+    {
+        // advance widget animations
+        app.idle();
+
+        if (! win.renderToMemory(pixels, stride))
+        {
+            d_stderr2("Offscreen rendering is not supported by this graphics backend");
+            delete[] pixels;
+            return 1;
+        }
+    }
+
+    win.setDisplayTimingCallback(nullptr);
+    delete[] pixels;
+
+    d_stdout("Rendered %u frames of %ux%u", numFrames, width, height);
+    d_stdout("%-12s %12s %12s", "widget", "avg (ms)", "max (ms)");
+
+    for (std::vector<BenchmarkTimings::Entry>::iterator it = timings.entries.begin(); it != timings.entries.end(); ++it)
+    {
+        const BenchmarkTimings::Entry& entry(*it);
+        d_stdout("%-12s %12.3f %12.3f", entry.name, entry.total * 1000.0 / numFrames, entry.max * 1000.0);
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,223 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tests.hpp"
+
+#include "distrho/src/DistrhoPlugin.cpp"
+#include "distrho/src/DistrhoPluginInternal.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kNumParameters = 512;
+
+static void fillParameter(const uint32_t index, Parameter& parameter)
+{
+    parameter.name = String("Parameter ") + String(index);
+    parameter.symbol = String("param") + String(index);
+    parameter.hints = kParameterIsAutomatable;
+    parameter.ranges.min = -static_cast<float>(index % 17);
+    parameter.ranges.max = static_cast<float>(index % 31) + 1.f;
+    parameter.ranges.def = 0.f;
+    parameter.midiCC = static_cast<uint8_t>(index % 121);
+
+    switch (index % 4)
+    {
+    case 1:
+        parameter.hints |= kParameterIsInteger;
+        break;
+    case 2:
+        parameter.hints |= kParameterIsBoolean;
+        break;
+    case 3:
+        parameter.hints = kParameterIsOutput;
+        break;
+    }
+}
+
+class MidiControlMapPlugin : public Plugin
+{
+public:
+    MidiControlMapPlugin()
+        : Plugin(kNumParameters, 0, 0),
+          values() {}
+
+protected:
+    const char* getLabel() const override { return "MidiControlMap"; }
+    const char* getMaker() const override { return "DISTRHO"; }
+    const char* getLicense() const override { return "ISC"; }
+    uint32_t getVersion() const override { return d_version(1, 0, 0); }
+    int64_t getUniqueId() const override { return d_cconst('d', 'M', 'c', 'm'); }
+
+    void initParameter(const uint32_t index, Parameter& parameter) override
+    {
+        fillParameter(index, parameter);
+        values[index] = parameter.ranges.def;
+    }
+
+    float getParameterValue(const uint32_t index) const override
+    {
+        return values[index];
+    }
+
+    void setParameterValue(const uint32_t index, const float value) override
+    {
+        values[index] = value;
+    }
+
+    void run(const float**, float**, uint32_t) override {}
+
+private:
+    float values[kNumParameters];
+};
+
+Plugin* createPlugin()
+{
+    return new MidiControlMapPlugin();
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+USE_NAMESPACE_DISTRHO;
+
+int main()
+{
+    d_nextBufferSize = 512;
+    d_nextSampleRate = 48000.0;
+
+    PluginExporter plugin(nullptr, nullptr, nullptr, nullptr);
+
+    // MIDI CC routing must match the parameter MIDI CC hints, and follow runtime binding changes
+    {
+        MidiControlMap midiMap;
+        midiMap.init(plugin);
+
+        const uint32_t* indices;
+        uint32_t numRouted = 0;
+
+        {
+            const MidiControlMap::ScopedReader reader(midiMap);
+
+            for (uint8_t cc=0; cc < 128; ++cc)
+            {
+                const uint32_t count = reader.getParameters(0, cc, indices);
+                numRouted += count;
+
+                for (uint32_t j=0; j < count; ++j)
+                {
+                    DISTRHO_ASSERT_EQUAL(plugin.getParameterMidiCC(indices[j]), cc, "routed MIDI CC matches");
+                    DISTRHO_ASSERT_EQUAL(plugin.isParameterInput(indices[j]), true, "routed parameter is input");
+                }
+
+                if (cc == 0 || cc == 32 || cc > 120)
+                    DISTRHO_ASSERT_EQUAL(count, 0, "invalid MIDI CC is not routed");
+            }
+
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(1, 7, indices), 0, "other channels are not routed");
+        }
+
+        uint32_t numExpected = 0;
+        for (uint32_t i=0; i < kNumParameters; ++i)
+        {
+            const uint8_t cc = plugin.getParameterMidiCC(i);
+            if (plugin.isParameterInput(i) && cc != 0 && cc != 32)
+                ++numExpected;
+        }
+        DISTRHO_ASSERT_EQUAL(numRouted, numExpected, "all valid MIDI CC hints are routed");
+
+        // MIDI learn moves a binding to the next received CC
+        midiMap.startLearning(5);
+        midiMap.learnControl(3, 100);
+        midiMap.learnControl(4, 101);
+
+        uint32_t learnedIndex = 0;
+        DISTRHO_ASSERT_EQUAL(midiMap.idle(&learnedIndex), true, "MIDI learn is applied");
+        DISTRHO_ASSERT_EQUAL(learnedIndex, 5, "MIDI learn index matches");
+        DISTRHO_ASSERT_EQUAL(midiMap.idle(), false, "MIDI learn is applied only once");
+
+        {
+            const MidiControlMap::ScopedReader reader(midiMap);
+
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(3, 100, indices), 1, "learned MIDI CC is routed");
+            DISTRHO_ASSERT_EQUAL(indices[0], 5, "learned MIDI CC routes to learned parameter");
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(4, 101, indices), 0, "MIDI learn ends after first CC");
+
+            const uint32_t count = reader.getParameters(0, 5, indices);
+            for (uint32_t j=0; j < count; ++j)
+                DISTRHO_ASSERT_NOT_EQUAL(indices[j], 5, "previous binding is removed");
+        }
+
+        midiMap.clearParameterControl(5);
+
+        {
+            const MidiControlMap::ScopedReader reader(midiMap);
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(3, 100, indices), 0, "cleared MIDI CC is not routed");
+
+            // binding changes while the realtime side holds a table never wait, and show up on its next block
+            midiMap.setParameterControl(6, 2, 50);
+            midiMap.setParameterControl(6, 2, 51);
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(2, 51, indices), 0, "held table is not changed");
+        }
+
+        {
+            const MidiControlMap::ScopedReader reader(midiMap);
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(2, 51, indices), 1, "newest pending table is adopted");
+            DISTRHO_ASSERT_EQUAL(reader.getParameters(2, 50, indices), 0, "replaced pending table is dropped");
+        }
+    }
+
+    // bindings saved as text must restore the same routing, only changed bindings need saving
+    {
+        MidiControlMap midiMap;
+        midiMap.init(plugin);
+
+        DISTRHO_ASSERT_EQUAL(midiMap.isParameterControlModified(1), false, "default binding is not modified");
+
+        midiMap.setParameterControl(1, 15, 127);
+        midiMap.clearParameterControl(2);
+
+        const String text1(midiMap.getParameterControlText(1));
+        const String text2(midiMap.getParameterControlText(2));
+        DISTRHO_ASSERT_EQUAL((text1 == "16:127"), true, "binding text uses 1-based channel");
+        DISTRHO_ASSERT_EQUAL((text2 == "none"), true, "cleared binding text");
+        DISTRHO_ASSERT_EQUAL(midiMap.isParameterControlModified(1), true, "changed binding is modified");
+        DISTRHO_ASSERT_EQUAL(midiMap.isParameterControlModified(2), true, "cleared binding is modified");
+
+        midiMap.resetParameterControls();
+        DISTRHO_ASSERT_EQUAL(midiMap.isParameterControlModified(1), false, "reset restores default binding");
+
+        DISTRHO_ASSERT_EQUAL(midiMap.setParameterControlFromText(1, text1), true, "binding text is restored");
+        DISTRHO_ASSERT_EQUAL(midiMap.setParameterControlFromText(2, text2), true, "cleared binding text is restored");
+        DISTRHO_ASSERT_EQUAL(midiMap.setParameterControlFromText(5, "17:1"), false, "invalid channel is rejected");
+
+        uint8_t channel, control;
+        DISTRHO_ASSERT_EQUAL(midiMap.getParameterControl(1, channel, control), true, "restored binding is set");
+        DISTRHO_ASSERT_EQUAL(channel, 15, "restored binding channel");
+        DISTRHO_ASSERT_EQUAL(control, 127, "restored binding control");
+        DISTRHO_ASSERT_EQUAL(midiMap.getParameterControl(2, channel, control), false, "restored binding is cleared");
+
+        const MidiControlMap::ScopedReader reader(midiMap);
+        const uint32_t* indices;
+        DISTRHO_ASSERT_EQUAL(reader.getParameters(15, 127, indices), 1, "restored binding is routed");
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,63 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tests.hpp"
+
+#include "distrho/src/DistrhoPluginInternal.hpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kNumParameters = 4096;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+USE_NAMESPACE_DISTRHO;
+
+int main()
+{
+    // parameter changes from the UI are coalesced per parameter and kept in order
+    ParameterEditQueue queue;
+    queue.init(kNumParameters);
+
+    const ParameterEdit* edits;
+    DISTRHO_ASSERT_EQUAL(queue.read(512, 48000.0, edits), 0, "nothing to read from empty queue");
+
+    float value = 0.f;
+    queue.write(10, 1.f);
+    queue.write(20, 2.f);
+    queue.write(10, 3.f);
+    DISTRHO_ASSERT_EQUAL(queue.getPendingValue(10, value), true, "pending value is available");
+    DISTRHO_ASSERT_EQUAL(value, 3.f, "pending value is the latest one");
+
+    DISTRHO_ASSERT_EQUAL(queue.read(512, 48000.0, edits), 2, "changes are coalesced");
+    DISTRHO_ASSERT_EQUAL(edits[0].index, 10, "first change index matches");
+    DISTRHO_ASSERT_EQUAL(edits[0].value, 3.f, "first change has latest value");
+    DISTRHO_ASSERT_EQUAL(edits[1].index, 20, "second change index matches");
+    DISTRHO_ASSERT_EQUAL((edits[1].frame >= edits[0].frame), true, "changes are sorted by frame");
+    DISTRHO_ASSERT_EQUAL((edits[1].frame < 512), true, "changes are within the block");
+    DISTRHO_ASSERT_EQUAL(queue.getPendingValue(10, value), false, "no pending value after read");
+
+    // every parameter can be queued at once
+    for (uint32_t i=0; i < kNumParameters; ++i)
+        queue.write(i, static_cast<float>(i));
+
+    DISTRHO_ASSERT_EQUAL(queue.read(512, 48000.0, edits), kNumParameters, "all changes are read");
+    DISTRHO_ASSERT_EQUAL(edits[kNumParameters - 1].value, static_cast<float>(kNumParameters - 1), "last change matches");
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
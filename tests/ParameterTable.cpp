@@ -0,0 +1,245 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tests.hpp"
+
+#include "distrho/src/DistrhoPlugin.cpp"
+#include "distrho/src/DistrhoPluginInternal.hpp"
+
+#include <chrono>
+#include <vector>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kNumParameters = 2000;
+static constexpr const uint32_t kNumRounds = 1000;
+static constexpr const size_t kEvictionSize = 8 * 1024 * 1024;
+
+static void fillParameter(const uint32_t index, Parameter& parameter)
+{
+    parameter.name = String("Parameter ") + String(index);
+    parameter.symbol = String("param") + String(index);
+    parameter.hints = kParameterIsAutomatable;
+    parameter.ranges.min = -static_cast<float>(index % 17);
+    parameter.ranges.max = static_cast<float>(index % 31) + 1.f;
+    parameter.ranges.def = 0.f;
+    parameter.midiCC = static_cast<uint8_t>(index % 121);
+
+    switch (index % 4)
+    {
+    case 1:
+        parameter.hints |= kParameterIsInteger;
+        break;
+    case 2:
+        parameter.hints |= kParameterIsBoolean;
+        break;
+    case 3:
+        parameter.hints = kParameterIsOutput;
+        break;
+    }
+}
+
+class ParameterTablePlugin : public Plugin
+{
+public:
+    ParameterTablePlugin()
+        : Plugin(kNumParameters, 0, 0),
+          values() {}
+
+protected:
+    const char* getLabel() const override { return "ParameterTable"; }
+    const char* getMaker() const override { return "DISTRHO"; }
+    const char* getLicense() const override { return "ISC"; }
+    uint32_t getVersion() const override { return d_version(1, 0, 0); }
+    int64_t getUniqueId() const override { return d_cconst('d', 'P', 't', 'b'); }
+
+    void initParameter(const uint32_t index, Parameter& parameter) override
+    {
+        fillParameter(index, parameter);
+        values[index] = parameter.ranges.def;
+    }
+
+    float getParameterValue(const uint32_t index) const override
+    {
+        return values[index];
+    }
+
+    void setParameterValue(const uint32_t index, const float value) override
+    {
+        values[index] = value;
+    }
+
+    void run(const float**, float**, uint32_t) override {}
+
+private:
+    float values[kNumParameters];
+};
+
+Plugin* createPlugin()
+{
+    return new ParameterTablePlugin();
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+USE_NAMESPACE_DISTRHO;
+
+static double getTimeInMilliseconds(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    d_nextBufferSize = 512;
+    d_nextSampleRate = 48000.0;
+
+    PluginExporter plugin(nullptr, nullptr, nullptr, nullptr);
+
+    // table values must match the original parameter data
+    for (uint32_t i=0; i < kNumParameters; ++i)
+    {
+        const ParameterRanges& ranges(plugin.getParameterRanges(i));
+
+        DISTRHO_ASSERT_EQUAL(plugin.getParameterMinimum(i), ranges.min, "minimum matches");
+        DISTRHO_ASSERT_EQUAL(plugin.getParameterMaximum(i), ranges.max, "maximum matches");
+        DISTRHO_ASSERT_EQUAL(plugin.getParameterDefault(i), ranges.def, "default matches");
+
+        for (double v = -20.0; v <= 40.0; v += 0.75)
+        {
+            DISTRHO_ASSERT_SAFE_EQUAL(plugin.getNormalizedParameterValue(i, v),
+                                 ranges.getFixedAndNormalizedValue(v), "normalized value matches");
+        }
+
+        for (double v = -0.25; v <= 1.25; v += 0.0625)
+        {
+            DISTRHO_ASSERT_SAFE_EQUAL(plugin.getUnnormalizedParameterValue(i, v),
+                                 ranges.getUnnormalizedValue(v), "unnormalized value matches");
+        }
+    }
+
+    // benchmark the typical per-block work done by plugin wrappers: output parameter scans and normalization.
+    // scans are also timed after evicting caches, as happens when the plugin runs between two wrapper blocks.
+    // timings are only reported, not compared, as they depend on machine and compiler
+    double plains[kNumParameters];
+    double normalized[kNumParameters];
+
+    for (uint32_t i=0; i < kNumParameters; ++i)
+        plains[i] = static_cast<double>(i % 13) - 6.0;
+
+    // same layout as the plugin parameter data, an array of full Parameter objects
+    Parameter* const parameters = new Parameter[kNumParameters];
+
+    for (uint32_t i=0; i < kNumParameters; ++i)
+        fillParameter(i, parameters[i]);
+
+    ParameterTable table;
+    table.init(parameters, kNumParameters);
+
+    std::vector<uint8_t> eviction(kEvictionSize, 0);
+    uint32_t evicted = 0;
+
+    double scanParameters = 0.0, scanTable = 0.0;
+    double coldScanParameters = 0.0, coldScanTable = 0.0;
+    uint32_t outputs1 = 0, outputs2 = 0;
+    std::chrono::steady_clock::time_point start;
+
+    for (uint32_t r=0; r < kNumRounds; ++r)
+    {
+        const bool cold = r % 2 != 0;
+
+        if (cold)
+        {
+            for (size_t k=0; k < kEvictionSize; k += 64)
+                evicted += ++eviction[k];
+        }
+
+        start = std::chrono::steady_clock::now();
+
+        for (uint32_t i=0; i < kNumParameters; ++i)
+        {
+            if (parameters[i].hints & kParameterIsOutput)
+                ++outputs1;
+        }
+
+        (cold ? coldScanParameters : scanParameters) += getTimeInMilliseconds(start);
+
+        if (cold)
+        {
+            for (size_t k=0; k < kEvictionSize; k += 64)
+                evicted += ++eviction[k];
+        }
+
+        start = std::chrono::steady_clock::now();
+
+        for (uint32_t i=0; i < kNumParameters; ++i)
+        {
+            if (table.hints[i] & kParameterIsOutput)
+                ++outputs2;
+        }
+
+        (cold ? coldScanTable : scanTable) += getTimeInMilliseconds(start);
+    }
+
+    double sum1 = 0.0, sum2 = 0.0;
+    start = std::chrono::steady_clock::now();
+
+    for (uint32_t r=0; r < kNumRounds; ++r)
+    {
+        for (uint32_t i=0; i < kNumParameters; ++i)
+        {
+            normalized[i] = parameters[i].ranges.getFixedAndNormalizedValue(plains[i]);
+            sum1 += parameters[i].ranges.getUnnormalizedValue(normalized[i]);
+        }
+    }
+
+    const double normParameters = getTimeInMilliseconds(start);
+    start = std::chrono::steady_clock::now();
+
+    for (uint32_t r=0; r < kNumRounds; ++r)
+    {
+        for (uint32_t i=0; i < kNumParameters; ++i)
+        {
+            normalized[i] = table.getNormalizedValue(i, plains[i]);
+            sum2 += table.getUnnormalizedValue(i, normalized[i]);
+        }
+    }
+
+    const double normTable = getTimeInMilliseconds(start);
+
+    delete[] parameters;
+
+    DISTRHO_ASSERT_EQUAL(outputs1, outputs2, "output parameter scans match");
+    DISTRHO_ASSERT_SAFE_EQUAL(sum1, sum2, "normalization round-trips match");
+    DISTRHO_ASSERT_NOT_EQUAL(evicted, 0, "cache eviction is not optimized away");
+
+    const double numScans = kNumRounds / 2;
+    d_stdout("%u parameters, average per block (us):  Parameter array  parameter table", kNumParameters);
+    d_stdout("  output scan                          %15.3f  %15.3f",
+             scanParameters * 1000.0 / numScans, scanTable * 1000.0 / numScans);
+    d_stdout("  output scan, cold caches             %15.3f  %15.3f",
+             coldScanParameters * 1000.0 / numScans, coldScanTable * 1000.0 / numScans);
+    d_stdout("  normalization round-trip             %15.3f  %15.3f",
+             normParameters * 1000.0 / kNumRounds, normTable * 1000.0 / kNumRounds);
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tests.hpp"
+
+#include "distrho/extra/Resource.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// "DISTRHO Plugin Framework, " repeated 40 times, compressed with `utils/res2c.py --compress`
+static const unsigned char kEncodedData[] = {
+    255, 11, 68, 73, 83, 84, 82, 72, 79, 32, 80, 108, 117, 103, 105, 110, 32, 70, 114, 97,
+    109, 101, 119, 111, 114, 107, 44, 32, 26, 0, 255, 255, 255, 225, 80, 111, 114, 107, 44, 32
+};
+static constexpr const uint32_t kEncodedSize = sizeof(kEncodedData);
+static constexpr const uint32_t kDecodedSize = 1040;
+
+static bool matchesDecodedData(const uint8_t* const data)
+{
+    static const char* const kPattern = "DISTRHO Plugin Framework, ";
+    const size_t patternSize = std::strlen(kPattern);
+
+    for (uint32_t i = 0; i < kDecodedSize; i += patternSize)
+    {
+        if (std::memcmp(data + i, kPattern, patternSize) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    USE_NAMESPACE_DISTRHO;
+
+    // decoding on first use
+    {
+        Resource res(kEncodedData, kEncodedSize, kDecodedSize);
+        DISTRHO_ASSERT_EQUAL(res.isCompressed(), true, "resource is compressed");
+        DISTRHO_ASSERT_EQUAL(Resource::getStats().numResident, 0, "nothing decoded before first use");
+
+        const uint8_t* const data = res.getData();
+        DISTRHO_ASSERT_NOT_EQUAL(data, nullptr, "data is decoded");
+        DISTRHO_ASSERT_EQUAL(matchesDecodedData(data), true, "decoded data matches");
+        DISTRHO_ASSERT_EQUAL(Resource::getStats().numResident, 1, "one resource is resident");
+        DISTRHO_ASSERT_EQUAL(Resource::getStats().residentSize, kDecodedSize, "resident size matches");
+
+        // other handles share the same decoded data
+        Resource res2(kEncodedData, kEncodedSize, kDecodedSize);
+        DISTRHO_ASSERT_EQUAL(res2.getData(), data, "decoded data is shared");
+
+        res.release();
+        DISTRHO_ASSERT_EQUAL(Resource::getStats().numResident, 1, "data is kept while still referenced");
+    }
+
+    DISTRHO_ASSERT_EQUAL(Resource::getStats().numResident, 0, "data is freed after last release");
+
+    // background decoding
+    {
+        Resource res(kEncodedData, kEncodedSize, kDecodedSize);
+        res.preload();
+
+        const uint8_t* const data = res.getData();
+        DISTRHO_ASSERT_NOT_EQUAL(data, nullptr, "data is decoded in the background");
+        DISTRHO_ASSERT_EQUAL(matchesDecodedData(data), true, "background decoded data matches");
+    }
+
+    // uncompressed data is used as-is
+    {
+        Resource res(kEncodedData, kEncodedSize, kEncodedSize);
+        DISTRHO_ASSERT_EQUAL(res.isCompressed(), false, "resource is not compressed");
+        DISTRHO_ASSERT_EQUAL(res.getData(), kEncodedData, "uncompressed data is not copied");
+    }
+
+    // invalid data must not decode
+    {
+        uint8_t buffer[kDecodedSize];
+        DISTRHO_ASSERT_EQUAL(Resource::decode(kEncodedData, kEncodedSize, buffer, kDecodedSize - 1), false,
+                             "decoding fails if target is too small");
+        DISTRHO_ASSERT_EQUAL(Resource::decode(kEncodedData, kEncodedSize - 3, buffer, kDecodedSize), false,
+                             "decoding fails on truncated data");
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
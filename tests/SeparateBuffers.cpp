@@ -0,0 +1,115 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+
+// plugin that cannot process in-place, it writes its 1st output before reading its 2nd input
+#define DISTRHO_PLUGIN_SUPPORTS_IN_PLACE 0
+
+#include "tests.hpp"
+
+#include "distrho/src/DistrhoPlugin.cpp"
+#include "distrho/src/DistrhoPluginInternal.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class SeparateBuffersPlugin : public Plugin
+{
+public:
+    SeparateBuffersPlugin()
+        : Plugin(0, 0, 0) {}
+
+protected:
+    const char* getLabel() const override { return "SeparateBuffers"; }
+    const char* getMaker() const override { return "DISTRHO"; }
+    const char* getLicense() const override { return "ISC"; }
+    uint32_t getVersion() const override { return d_version(1, 0, 0); }
+    int64_t getUniqueId() const override { return d_cconst('d', 'S', 'b', 'f'); }
+
+    // swaps channels
+    void run(const float** const inputs, float** const outputs, const uint32_t frames) override
+    {
+        for (uint32_t i=0; i < frames; ++i)
+            outputs[0][i] = inputs[1][i];
+
+        for (uint32_t i=0; i < frames; ++i)
+            outputs[1][i] = inputs[0][i];
+    }
+};
+
+Plugin* createPlugin()
+{
+    return new SeparateBuffersPlugin();
+}
+
+END_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+USE_NAMESPACE_DISTRHO;
+
+static void runInPlace(PluginExporter& plugin, float* const left, float* const right, const uint32_t frames)
+{
+    for (uint32_t i=0; i < frames; ++i)
+    {
+        left[i] = 1.f;
+        right[i] = 2.f;
+    }
+
+    const float* inputs[2] = { left, right };
+    float* outputs[2] = { left, right };
+    plugin.run(inputs, outputs, frames);
+}
+
+int main()
+{
+    d_nextBufferSize = 256;
+    d_nextSampleRate = 48000.0;
+
+    PluginExporter plugin(nullptr, nullptr, nullptr, nullptr);
+
+    float* const left = new float[1024];
+    float* const right = new float[1024];
+
+    plugin.activate();
+    runInPlace(plugin, left, right, 256);
+
+    for (uint32_t i=0; i < 256; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(left[i], 2.f, "left output has right input");
+        DISTRHO_ASSERT_EQUAL(right[i], 1.f, "right output has left input");
+    }
+
+    // buffer size changes while active must resize the separate input buffers
+    plugin.setBufferSize(1024, true);
+    runInPlace(plugin, left, right, 1024);
+
+    for (uint32_t i=0; i < 1024; ++i)
+    {
+        DISTRHO_ASSERT_EQUAL(left[i], 2.f, "left output has right input after buffer size change");
+        DISTRHO_ASSERT_EQUAL(right[i], 1.f, "right output has left input after buffer size change");
+    }
+
+    plugin.deactivate();
+
+    delete[] left;
+    delete[] right;
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
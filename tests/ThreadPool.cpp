@@ -0,0 +1,112 @@
+/*
+ * DISTRHO Plugin Framework (DPF)
+ * Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any purpose with
+ * or without fee is hereby granted, provided that the above copyright notice and this
+ * permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+ * TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+ * NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+ * DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+ * IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tests.hpp"
+
+#include "distrho/extra/ThreadPool.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kNumTasks = 64;
+static constexpr const uint32_t kNumBatches = 2000;
+
+// a user of the pool, counting how many times each of its tasks ran
+struct PoolUser {
+    ThreadPool& pool;
+    volatile uint32_t counts[kNumTasks];
+
+    PoolUser(ThreadPool& p)
+        : pool(p)
+    {
+        std::memset((void*)counts, 0, sizeof(counts));
+    }
+
+    void runBatches()
+    {
+        for (uint32_t i=0; i < kNumBatches; ++i)
+            pool.runTasks(runTask, this, kNumTasks);
+    }
+
+    bool allTasksRanOnEveryBatch() const
+    {
+        for (uint32_t i=0; i < kNumTasks; ++i)
+        {
+            if (counts[i] != kNumBatches)
+                return false;
+        }
+        return true;
+    }
+
+    static void runTask(void* const ptr, const uint32_t taskIndex)
+    {
+        __atomic_add_fetch(&static_cast<PoolUser*>(ptr)->counts[taskIndex], 1, __ATOMIC_RELAXED);
+    }
+};
+
+// runs batches on a separate thread, like a second plugin instance processing on another host thread
+class PoolUserThread : public Thread
+{
+public:
+    PoolUser user;
+
+    PoolUserThread(ThreadPool& pool)
+        : Thread("PoolUserThread"),
+          user(pool) {}
+
+protected:
+    void run() override
+    {
+        user.runBatches();
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+int main()
+{
+    USE_NAMESPACE_DISTRHO;
+
+    ThreadPool pool(3, false);
+    DISTRHO_ASSERT_EQUAL(pool.getNumThreads(), 3, "pool has the requested amount of workers");
+
+    // single user, every task runs exactly once per batch
+    {
+        PoolUser user(pool);
+        user.runBatches();
+        DISTRHO_ASSERT_EQUAL(user.allTasksRanOnEveryBatch(), true, "single user tasks ran once per batch");
+    }
+
+    // two users sharing the pool concurrently, one of them falls back to the calling thread while the pool is busy
+    {
+        PoolUserThread thread(pool);
+        PoolUser user(pool);
+
+        thread.startThread();
+        user.runBatches();
+        thread.stopThread(-1);
+
+        DISTRHO_ASSERT_EQUAL(user.allTasksRanOnEveryBatch(), true, "first shared user tasks ran once per batch");
+        DISTRHO_ASSERT_EQUAL(thread.user.allTasksRanOnEveryBatch(), true, "second shared user tasks ran once per batch");
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -2,7 +2,7 @@
 # -*- coding: utf-8 -*-
 
 # DISTRHO Plugin Framework (DPF)
-# Copyright (C) 2012-2019 Filipe Coelho <falktx@falktx.com>
+# Copyright (C) 2012-2024 Filipe Coelho <falktx@falktx.com>
 #
 # Permission to use, copy, modify, and/or distribute this software for any purpose with
 # or without fee is hereby granted, provided that the above copyright notice and this
@@ -18,8 +18,92 @@
 import os, sys
 
 # -----------------------------------------------------
+# LZ4 block compression, decoded at runtime by distrho/extra/Resource.hpp
 
-def res2c(namespace, filenames):
+LZ4_MIN_MATCH     = 4
+LZ4_LAST_LITERALS = 5
+LZ4_MF_LIMIT      = 12
+LZ4_MAX_OFFSET    = 65535
+LZ4_SEARCH_DEPTH  = 16
+
+def lz4_write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def lz4_write_sequence(out, literals, matchLength, offset):
+    litLen = len(literals)
+    token  = min(litLen, 15) << 4
+
+    if matchLength:
+        token |= min(matchLength - LZ4_MIN_MATCH, 15)
+
+    out.append(token)
+
+    if litLen >= 15:
+        lz4_write_length(out, litLen - 15)
+
+    out += literals
+
+    if matchLength:
+        out.append(offset & 0xff)
+        out.append(offset >> 8)
+
+        if matchLength - LZ4_MIN_MATCH >= 15:
+            lz4_write_length(out, matchLength - LZ4_MIN_MATCH - 15)
+
+def lz4_compress(data):
+    size   = len(data)
+    out    = bytearray()
+    chains = {}
+    anchor = 0
+    pos    = 0
+
+    # matches must leave the last bytes as literals, as required by the LZ4 block format
+    matchLimit = size - LZ4_LAST_LITERALS
+
+    while pos < size - LZ4_MF_LIMIT:
+        key = data[pos:pos+LZ4_MIN_MATCH]
+        candidates = chains.setdefault(key, [])
+
+        bestLength = 0
+        bestOffset = 0
+
+        for candidate in reversed(candidates[-LZ4_SEARCH_DEPTH:]):
+            offset = pos - candidate
+            if offset > LZ4_MAX_OFFSET:
+                break
+
+            length = LZ4_MIN_MATCH
+            while pos + length < matchLimit and data[candidate + length] == data[pos + length]:
+                length += 1
+
+            if length > bestLength:
+                bestLength = length
+                bestOffset = offset
+
+        candidates.append(pos)
+
+        if bestLength < LZ4_MIN_MATCH:
+            pos += 1
+            continue
+
+        lz4_write_sequence(out, data[anchor:pos], bestLength, bestOffset)
+
+        # index positions within the match, so later data can refer to it
+        for i in range(pos + 1, min(pos + bestLength, size - LZ4_MF_LIMIT)):
+            chains.setdefault(data[i:i+LZ4_MIN_MATCH], []).append(i)
+
+        pos   += bestLength
+        anchor = pos
+
+    lz4_write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+# -----------------------------------------------------
+
+def res2c(namespace, filenames, compress = False):
 
     fdH = open("%s.hpp" % namespace, "w")
     fdH.write("/* (Auto-generated binary data file). */\n")
@@ -47,7 +131,21 @@ def res2c(namespace, filenames):
         print("Generating data for \"%s\"" % (filename))
 
         fdH.write("    extern const unsigned char* %sData;\n" % shortFilename)
-        fdH.write("    const unsigned int %sDataSize = %i;\n" % (shortFilename, len(resData)))
+
+        if compress:
+            decodedSize = len(resData)
+            encodedData = lz4_compress(resData)
+
+            # keep data as-is if it does not compress, Resource handles both cases
+            if len(encodedData) < decodedSize:
+                resData = encodedData
+
+            print("  %i -> %i bytes" % (decodedSize, len(resData)))
+
+            fdH.write("    const unsigned int %sDataSize = %i;\n" % (shortFilename, len(resData)))
+            fdH.write("    const unsigned int %sDataDecodedSize = %i;\n" % (shortFilename, decodedSize))
+        else:
+            fdH.write("    const unsigned int %sDataSize = %i;\n" % (shortFilename, len(resData)))
 
         if tempIndex != len(filenames):
             fdH.write("\n")
@@ -89,8 +187,14 @@ def res2c(namespace, filenames):
 # -----------------------------------------------------
 
 if __name__ == '__main__':
+    compress = "--compress" in sys.argv
+
+    if compress:
+        sys.argv.remove("--compress")
+
     if len(sys.argv) not in (3, 4):
-        print("Usage: %s <namespace> <resource-folder> [output-folder=$CWD]" % sys.argv[0])
+        print("Usage: %s [--compress] <namespace> <resource-folder> [output-folder=$CWD]" % sys.argv[0])
+        print("  --compress: store LZ4 compressed data, to be decoded at runtime with DISTRHO::Resource")
         quit()
 
     namespace = sys.argv[1].replace("-","_")
@@ -118,4 +222,4 @@ if __name__ == '__main__':
         os.chdir(outFolder)
 
     # create code now
-    res2c(namespace, resFiles)
+    res2c(namespace, resFiles, compress)